@@ -1,7 +1,9 @@
 #include "adrc.hpp"
+#include "../../HAL/PROFILE/profile.hpp"
 
 float ALG::ADRC::FirstLADRC::LADRC_1(float input, float feedback)
 {
+    PROFILE_ZONE("ladrc_1");
     LESO_1(feedback);
     LSEF_1(input);
     std::clamp(U, GetMin(), GetMax());
@@ -33,6 +35,7 @@ void ALG::ADRC::FirstLADRC::LESO_1(float feedback)
 
 float ALG::ADRC::SecondLADRC::LADRC_2(float input, float feedback)
 {
+    PROFILE_ZONE("ladrc_2");
     TD_2(input);
     LESO_2(feedback);
     LSEF_2();
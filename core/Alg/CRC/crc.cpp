@@ -0,0 +1,140 @@
+#include "crc.hpp"
+
+namespace ALG::CHECKSUM
+{
+    namespace
+    {
+        // 标准校验串"123456789"
+        constexpr uint8_t CHECK[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+        // 一帧裁判系统数据（帧头 + 命令码0x0201 + 数据）作为第二组向量
+        constexpr uint8_t SAMPLE[] = {0xA5, 0x0D, 0x00, 0x01, 0x00, 0x01, 0x02, 0x03, 0x01, 0x90, 0x01,
+                                      0x90, 0x01, 0xF0, 0x00, 0x50, 0x00, 0x64, 0x00, 0x07, 0x00, 0x00};
+
+        static_assert(detail::crc8_bytewise(CRC8_INIT, CHECK, sizeof(CHECK)) == 0x0B, "CRC8校验值错误");
+        static_assert(detail::crc16_bytewise(CRC16_INIT, CHECK, sizeof(CHECK)) == 0x6F91, "CRC16校验值错误");
+        static_assert(detail::crc16_ccitt_bytewise(CRC16_CCITT_INIT, CHECK, sizeof(CHECK)) == 0x31C3, "CRC16-CCITT校验值错误");
+        static_assert(detail::crc32_bytewise(CRC32_INIT, CHECK, sizeof(CHECK)) == 0x0376E6E7, "CRC32校验值错误");
+
+        static_assert(detail::crc8_bytewise(CRC8_INIT, SAMPLE, sizeof(SAMPLE)) ==
+                          detail::reflected_bitwise<uint8_t>(CRC8_INIT, 0x8C, SAMPLE, sizeof(SAMPLE)),
+                      "CRC8查表与逐位结果不一致");
+        static_assert(detail::crc16_bytewise(CRC16_INIT, SAMPLE, sizeof(SAMPLE)) ==
+                          detail::reflected_bitwise<uint16_t>(CRC16_INIT, 0x8408, SAMPLE, sizeof(SAMPLE)),
+                      "CRC16查表与逐位结果不一致");
+        static_assert(detail::crc16_ccitt_bytewise(CRC16_CCITT_INIT, SAMPLE, sizeof(SAMPLE)) ==
+                          detail::crc16_ccitt_bitwise(CRC16_CCITT_INIT, SAMPLE, sizeof(SAMPLE)),
+                      "CRC16-CCITT查表与逐位结果不一致");
+        static_assert(detail::crc32_bytewise(CRC32_INIT, SAMPLE, sizeof(SAMPLE)) ==
+                          detail::crc32_bitwise(CRC32_INIT, SAMPLE, sizeof(SAMPLE)),
+                      "CRC32查表与逐位结果不一致");
+
+#if ALG_CRC_SLICE_BY_4
+        // slice-by-4的附加表：table[k][i]为字节i后面再跟k个0字节的CRC
+        template <typename T, bool Reflected>
+        struct SliceTables
+        {
+            T entry[4][256];
+
+            constexpr explicit SliceTables(const T (&base)[256]) : entry()
+            {
+                for (unsigned i = 0; i < 256; ++i)
+                {
+                    entry[0][i] = base[i];
+                }
+                for (unsigned k = 1; k < 4; ++k)
+                {
+                    for (unsigned i = 0; i < 256; ++i)
+                    {
+                        const T prev = entry[k - 1][i];
+                        if (Reflected)
+                        {
+                            entry[k][i] = (T)((prev >> 8) ^ base[prev & 0xFF]);
+                        }
+                        else
+                        {
+                            entry[k][i] = (T)((T)(prev << 8) ^ base[(prev >> (sizeof(T) * 8 - 8)) & 0xFF]);
+                        }
+                    }
+                }
+            }
+        };
+
+        constexpr SliceTables<uint16_t, true> CRC16_SLICE(detail::CRC16_TABLE.entry);
+        constexpr SliceTables<uint16_t, false> CRC16_CCITT_SLICE(detail::CRC16_CCITT_TABLE.entry);
+        constexpr SliceTables<uint32_t, false> CRC32_SLICE(detail::CRC32_TABLE.entry);
+#endif
+    } // namespace
+
+    uint8_t crc8_update(uint8_t crc, const uint8_t *data, size_t size)
+    {
+        return detail::crc8_bytewise(crc, data, size);
+    }
+
+    uint16_t crc16_update(uint16_t crc, const uint8_t *data, size_t size)
+    {
+#if ALG_CRC_SLICE_BY_4
+        const auto &t = CRC16_SLICE.entry;
+        for (; size >= 4; size -= 4, data += 4)
+        {
+            const uint16_t x = crc ^ (uint16_t)(data[0] | data[1] << 8);
+            crc = t[3][x & 0xFF] ^ t[2][x >> 8] ^ t[1][data[2]] ^ t[0][data[3]];
+        }
+#endif
+        return detail::crc16_bytewise(crc, data, size);
+    }
+
+    uint16_t crc16_ccitt_update(uint16_t crc, const uint8_t *data, size_t size)
+    {
+#if ALG_CRC_SLICE_BY_4
+        const auto &t = CRC16_CCITT_SLICE.entry;
+        for (; size >= 4; size -= 4, data += 4)
+        {
+            const uint16_t x = crc ^ (uint16_t)(data[0] << 8 | data[1]);
+            crc = t[3][x >> 8] ^ t[2][x & 0xFF] ^ t[1][data[2]] ^ t[0][data[3]];
+        }
+#endif
+        return detail::crc16_ccitt_bytewise(crc, data, size);
+    }
+
+    uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t size)
+    {
+#if ALG_CRC_SLICE_BY_4
+        const auto &t = CRC32_SLICE.entry;
+        for (; size >= 4; size -= 4, data += 4)
+        {
+            const uint32_t x = crc ^ ((uint32_t)data[0] << 24 | (uint32_t)data[1] << 16 | (uint32_t)data[2] << 8 | data[3]);
+            crc = t[3][x >> 24] ^ t[2][(x >> 16) & 0xFF] ^ t[1][(x >> 8) & 0xFF] ^ t[0][x & 0xFF];
+        }
+#endif
+        return detail::crc32_bytewise(crc, data, size);
+    }
+
+    bool verify_crc8(const uint8_t *data, size_t size)
+    {
+        return size >= 2 && crc8(data, size - 1) == data[size - 1];
+    }
+
+    bool verify_crc16(const uint8_t *data, size_t size)
+    {
+        return size >= 3 && crc16(data, size - 2) == (data[size - 2] | (uint16_t)data[size - 1] << 8);
+    }
+
+    void append_crc8(uint8_t *data, size_t size)
+    {
+        if (size >= 2)
+        {
+            data[size - 1] = crc8(data, size - 1);
+        }
+    }
+
+    void append_crc16(uint8_t *data, size_t size)
+    {
+        if (size >= 3)
+        {
+            const uint16_t crc = crc16(data, size - 2);
+            data[size - 2] = crc & 0xFF;
+            data[size - 1] = crc >> 8;
+        }
+    }
+} // namespace ALG::CHECKSUM
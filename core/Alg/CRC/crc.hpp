@@ -0,0 +1,192 @@
+#ifndef ALG_CRC_HPP
+#define ALG_CRC_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// 为1时CRC16/CRC32使用slice-by-4（每次处理4字节，每种CRC多占3张表：CRC16多1.5 KB，CRC32多3 KB Flash）
+#ifndef ALG_CRC_SLICE_BY_4
+#define ALG_CRC_SLICE_BY_4 0
+#endif
+
+namespace ALG::CHECKSUM
+{
+    /**
+     * 支持的CRC（参数按RevEng目录命名，"123456789"的校验值见crc.cpp中的static_assert）：
+     *
+     * | 函数 | 模型 | 多项式 | 初值 | 用途 |
+     * | --- | --- | --- | --- | --- |
+     * | crc8 | CRC-8/MAXIM（初值0xFF） | 0x31反射 | 0xFF | 裁判系统帧头 |
+     * | crc16 | CRC-16/MCRF4XX | 0x1021反射 | 0xFFFF | 裁判系统整帧 |
+     * | crc16_ccitt | CRC-16/XMODEM | 0x1021 | 0 | HI12 IMU |
+     * | crc32 | CRC-32/MPEG-2 | 0x04C11DB7 | 0xFFFFFFFF | STM32硬件CRC单元 |
+     *
+     * xxx_update()为增量接口：第一次传入对应的初值，之后传入上一次的返回值
+     */
+    constexpr uint8_t CRC8_INIT = 0xFF;
+    constexpr uint16_t CRC16_INIT = 0xFFFF;
+    constexpr uint16_t CRC16_CCITT_INIT = 0x0000;
+    constexpr uint32_t CRC32_INIT = 0xFFFFFFFF;
+
+    uint8_t crc8_update(uint8_t crc, const uint8_t *data, size_t size);
+    uint16_t crc16_update(uint16_t crc, const uint8_t *data, size_t size);
+    uint16_t crc16_ccitt_update(uint16_t crc, const uint8_t *data, size_t size);
+    uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t size);
+
+    inline uint8_t crc8(const uint8_t *data, size_t size) { return crc8_update(CRC8_INIT, data, size); }
+    inline uint16_t crc16(const uint8_t *data, size_t size) { return crc16_update(CRC16_INIT, data, size); }
+    inline uint16_t crc16_ccitt(const uint8_t *data, size_t size) { return crc16_ccitt_update(CRC16_CCITT_INIT, data, size); }
+    inline uint32_t crc32(const uint8_t *data, size_t size) { return crc32_update(CRC32_INIT, data, size); }
+
+    /**
+     * @brief 裁判系统格式：校验值放在数据末尾（CRC16小端）
+     * @param size 含校验值的总长度
+     */
+    bool verify_crc8(const uint8_t *data, size_t size);
+    bool verify_crc16(const uint8_t *data, size_t size);
+
+    /**
+     * @brief 计算前size - 1（CRC16为size - 2）字节的校验值并写入末尾
+     * @param size 含校验值的总长度
+     */
+    void append_crc8(uint8_t *data, size_t size);
+    void append_crc16(uint8_t *data, size_t size);
+
+    /**
+     * @brief 用STM32硬件CRC单元计算CRC-32/MPEG-2，结果与crc32()相同
+     *
+     * F4的硬件CRC只支持0x04C11DB7、32位输入、初值固定，CRC8/CRC16无法使用硬件。
+     * 4字节的整数倍部分由硬件计算，剩余字节由软件接续。硬件单元全局共享，不可重入，只在一个任务中使用。
+     * 实现在crc_hw.cpp（依赖main.h），定义HAL_CAN_VIRTUAL时整个文件不参与编译
+     */
+    uint32_t crc32_hw(const uint8_t *data, size_t size);
+
+    namespace detail
+    {
+        // 反射（低位在前）CRC的单字节表
+        template <typename T>
+        struct ReflectedTable
+        {
+            T entry[256];
+
+            constexpr explicit ReflectedTable(T poly) : entry()
+            {
+                for (unsigned i = 0; i < 256; ++i)
+                {
+                    T crc = (T)i;
+                    for (int bit = 0; bit < 8; ++bit)
+                    {
+                        crc = (crc & 1) ? (T)((crc >> 1) ^ poly) : (T)(crc >> 1);
+                    }
+                    entry[i] = crc;
+                }
+            }
+        };
+
+        // 非反射（高位在前）CRC的单字节表
+        template <typename T>
+        struct NormalTable
+        {
+            static constexpr unsigned SHIFT = sizeof(T) * 8 - 8;
+            T entry[256];
+
+            constexpr explicit NormalTable(T poly) : entry()
+            {
+                for (unsigned i = 0; i < 256; ++i)
+                {
+                    T crc = (T)(i << SHIFT);
+                    for (int bit = 0; bit < 8; ++bit)
+                    {
+                        crc = (crc >> (sizeof(T) * 8 - 1)) ? (T)((T)(crc << 1) ^ poly) : (T)(crc << 1);
+                    }
+                    entry[i] = crc;
+                }
+            }
+        };
+
+        inline constexpr ReflectedTable<uint8_t> CRC8_TABLE(0x8C);
+        inline constexpr ReflectedTable<uint16_t> CRC16_TABLE(0x8408);
+        inline constexpr NormalTable<uint16_t> CRC16_CCITT_TABLE(0x1021);
+        inline constexpr NormalTable<uint32_t> CRC32_TABLE(0x04C11DB7);
+
+        // 单字节查表，constexpr版本用于编译期校验
+        constexpr uint8_t crc8_bytewise(uint8_t crc, const uint8_t *data, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                crc = CRC8_TABLE.entry[crc ^ data[i]];
+            }
+            return crc;
+        }
+
+        constexpr uint16_t crc16_bytewise(uint16_t crc, const uint8_t *data, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                crc = (uint16_t)((crc >> 8) ^ CRC16_TABLE.entry[(crc ^ data[i]) & 0xFF]);
+            }
+            return crc;
+        }
+
+        constexpr uint16_t crc16_ccitt_bytewise(uint16_t crc, const uint8_t *data, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                crc = (uint16_t)((crc << 8) ^ CRC16_CCITT_TABLE.entry[((crc >> 8) ^ data[i]) & 0xFF]);
+            }
+            return crc;
+        }
+
+        constexpr uint32_t crc32_bytewise(uint32_t crc, const uint8_t *data, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                crc = (crc << 8) ^ CRC32_TABLE.entry[((crc >> 24) ^ data[i]) & 0xFF];
+            }
+            return crc;
+        }
+
+        // 逐位参考实现（crc16_ccitt_bitwise与HI12Base::crc16_update原实现相同），用于核对查表结果和性能对照
+        constexpr uint16_t crc16_ccitt_bitwise(uint16_t crc, const uint8_t *data, size_t size)
+        {
+            for (size_t j = 0; j < size; ++j)
+            {
+                crc ^= (uint16_t)(data[j] << 8);
+                for (int i = 0; i < 8; ++i)
+                {
+                    crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+                }
+            }
+            return crc;
+        }
+
+        template <typename T>
+        constexpr T reflected_bitwise(T crc, T poly, const uint8_t *data, size_t size)
+        {
+            for (size_t j = 0; j < size; ++j)
+            {
+                crc ^= data[j];
+                for (int i = 0; i < 8; ++i)
+                {
+                    crc = (crc & 1) ? (T)((crc >> 1) ^ poly) : (T)(crc >> 1);
+                }
+            }
+            return crc;
+        }
+
+        constexpr uint32_t crc32_bitwise(uint32_t crc, const uint8_t *data, size_t size)
+        {
+            for (size_t j = 0; j < size; ++j)
+            {
+                crc ^= (uint32_t)data[j] << 24;
+                for (int i = 0; i < 8; ++i)
+                {
+                    crc = (crc & 0x80000000u) ? (crc << 1) ^ 0x04C11DB7u : crc << 1;
+                }
+            }
+            return crc;
+        }
+    } // namespace detail
+} // namespace ALG::CHECKSUM
+
+#endif
@@ -0,0 +1,128 @@
+#include "crc_bench.hpp"
+
+#ifdef HAL_CAN_VIRTUAL
+
+#include "crc.hpp"
+#include <chrono>
+#include <cstdio>
+
+namespace ALG::CHECKSUM
+{
+    namespace
+    {
+        constexpr size_t MAX_SIZE = 1024;
+        // 数据远大于一帧，避免每帧数据重复时分支预测记住逐位实现的分支
+        constexpr size_t DATA_SIZE = 64 * 1024;
+
+        uint8_t data[DATA_SIZE];
+
+        void fill_data()
+        {
+            // 固定种子的xorshift32，结果与平台的rand()无关
+            uint32_t state = 1;
+            for (uint8_t &byte : data)
+            {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                byte = (uint8_t)state;
+            }
+        }
+
+        // 逐位实现在头文件中为constexpr，不内联，与查表实现同样按函数调用测量
+        __attribute__((noinline)) uint16_t crc16_ccitt_bitwise(const uint8_t *p, size_t size)
+        {
+            return detail::crc16_ccitt_bitwise(CRC16_CCITT_INIT, p, size);
+        }
+
+        uint32_t compute(BenchCrc crc, const uint8_t *p, size_t size)
+        {
+            switch (crc)
+            {
+            case BenchCrc::Crc16CcittBitwise:
+                return crc16_ccitt_bitwise(p, size);
+            case BenchCrc::Crc16Ccitt:
+                return crc16_ccitt(p, size);
+            case BenchCrc::Crc16:
+                return crc16(p, size);
+            case BenchCrc::Crc8:
+                return crc8(p, size);
+            default:
+                return crc32(p, size);
+            }
+        }
+
+        const char *crc_name(BenchCrc crc)
+        {
+            switch (crc)
+            {
+            case BenchCrc::Crc16CcittBitwise:
+                return "crc16_ccitt bitwise";
+            case BenchCrc::Crc16Ccitt:
+                return "crc16_ccitt";
+            case BenchCrc::Crc16:
+                return "crc16";
+            case BenchCrc::Crc8:
+                return "crc8";
+            default:
+                return "crc32";
+            }
+        }
+    } // namespace
+
+    BenchResult run_benchmark(BenchCrc crc, size_t size, uint32_t rounds)
+    {
+        if (size > MAX_SIZE || rounds == 0)
+        {
+            return BenchResult{};
+        }
+        fill_data();
+
+        uint32_t checksum = 0;
+        size_t offset = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < rounds; ++i)
+        {
+            checksum ^= compute(crc, data + offset, size);
+            // 步长为奇数，起始地址的对齐也在轮换
+            offset += size + 1;
+            offset = offset + size > DATA_SIZE ? 0 : offset;
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        BenchResult result;
+        result.ns_x10 = (uint32_t)(seconds * 1e10 / rounds);
+        result.checksum = checksum;
+        return result;
+    }
+
+    bool print_benchmark()
+    {
+        const BenchCrc crcs[] = {BenchCrc::Crc16CcittBitwise, BenchCrc::Crc16Ccitt, BenchCrc::Crc16, BenchCrc::Crc8,
+                                 BenchCrc::Crc32};
+        const size_t sizes[] = {82, 1024};
+
+        bool same_result = true;
+        std::printf("CRC, ALG_CRC_SLICE_BY_4=%d, ns per frame\n", ALG_CRC_SLICE_BY_4);
+        for (size_t size : sizes)
+        {
+            uint32_t bitwise_checksum = 0;
+            for (BenchCrc crc : crcs)
+            {
+                const BenchResult r = run_benchmark(crc, size);
+                std::printf("%-20s %4u B %7u.%u ns\n", crc_name(crc), (unsigned)size, r.ns_x10 / 10, r.ns_x10 % 10);
+                if (crc == BenchCrc::Crc16CcittBitwise)
+                {
+                    bitwise_checksum = r.checksum;
+                }
+                else if (crc == BenchCrc::Crc16Ccitt)
+                {
+                    same_result = same_result && r.checksum == bitwise_checksum;
+                }
+            }
+        }
+        return same_result;
+    }
+} // namespace ALG::CHECKSUM
+
+#endif // HAL_CAN_VIRTUAL
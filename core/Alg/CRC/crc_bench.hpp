@@ -0,0 +1,53 @@
+/**
+ * @file crc_bench.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief CRC各实现的单帧耗时测量（只在PC端编译）
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#ifndef ALG_CRC_BENCH_HPP
+#define ALG_CRC_BENCH_HPP
+
+#ifdef HAL_CAN_VIRTUAL
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ALG::CHECKSUM
+{
+    // 被测实现，查表各项在ALG_CRC_SLICE_BY_4为1时走slice-by-4
+    enum class BenchCrc : uint8_t
+    {
+        Crc16CcittBitwise, // 逐位CRC16-CCITT（HI12原实现）
+        Crc16Ccitt,        // crc16_ccitt()
+        Crc16,             // crc16()
+        Crc8,              // crc8()
+        Crc32,             // crc32()
+    };
+
+    // 一组测量结果
+    struct BenchResult
+    {
+        uint32_t ns_x10;   // 每帧耗时（0.1 ns）
+        uint32_t checksum; // 所有帧校验值的异或，用于比较不同实现的结果
+    };
+
+    /**
+     * @brief 在固定种子生成的64 KB数据上依次计算rounds帧size字节的CRC，相邻帧不重叠
+     */
+    BenchResult run_benchmark(BenchCrc crc, size_t size, uint32_t rounds = 50000);
+
+    /**
+     * @brief 测量README中的各项（82字节与1024字节），打印到标准输出
+     * @return 查表与逐位CRC16-CCITT的结果是否一致
+     */
+    bool print_benchmark();
+} // namespace ALG::CHECKSUM
+
+#endif // HAL_CAN_VIRTUAL
+
+#endif
@@ -0,0 +1,31 @@
+#include "crc.hpp"
+
+// PC端（HAL_CAN_VIRTUAL）没有硬件CRC单元，只编译crc.cpp
+#ifndef HAL_CAN_VIRTUAL
+
+#include "main.h"
+#include <cstring>
+
+namespace ALG::CHECKSUM
+{
+    uint32_t crc32_hw(const uint8_t *data, size_t size)
+    {
+        __HAL_RCC_CRC_CLK_ENABLE();
+
+        // 复位后数据寄存器为0xFFFFFFFF，即CRC32_INIT
+        CRC->CR = CRC_CR_RESET;
+
+        const size_t words = size / 4;
+        for (size_t i = 0; i < words; ++i)
+        {
+            // 硬件按高位在前处理32位字，小端读入后字节反转，使处理顺序与字节流一致
+            uint32_t word;
+            memcpy(&word, data + i * 4, sizeof(word));
+            CRC->DR = __REV(word);
+        }
+
+        return crc32_update(CRC->DR, data + words * 4, size - words * 4);
+    }
+} // namespace ALG::CHECKSUM
+
+#endif // HAL_CAN_VIRTUAL
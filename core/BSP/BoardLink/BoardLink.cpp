@@ -0,0 +1,232 @@
+#include "BoardLink.hpp"
+#include "../user/core/BSP/Common/StateWatch/buzzer_manager.hpp"
+#include <cstring>
+
+namespace BSP::BoardLink
+{
+    namespace
+    {
+        // 小端逐字段读写
+        class Writer
+        {
+        public:
+            explicit Writer(uint8_t *out) : p_(out) {}
+
+            void u8(uint8_t v) { *p_++ = v; }
+            void u16(uint16_t v)
+            {
+                *p_++ = v & 0xFF;
+                *p_++ = v >> 8;
+            }
+            void u32(uint32_t v)
+            {
+                u16(v & 0xFFFF);
+                u16(v >> 16);
+            }
+            void f32(float v)
+            {
+                memcpy(p_, &v, sizeof(v));
+                p_ += sizeof(v);
+            }
+            void bytes(const uint8_t *v, uint16_t n)
+            {
+                memcpy(p_, v, n);
+                p_ += n;
+            }
+
+        private:
+            uint8_t *p_;
+        };
+
+        class Reader
+        {
+        public:
+            explicit Reader(const uint8_t *in) : p_(in) {}
+
+            uint8_t u8() { return *p_++; }
+            uint16_t u16()
+            {
+                const uint16_t v = p_[0] | (uint16_t)p_[1] << 8;
+                p_ += 2;
+                return v;
+            }
+            uint32_t u32()
+            {
+                const uint32_t lo = u16();
+                return lo | (uint32_t)u16() << 16;
+            }
+            float f32()
+            {
+                float v;
+                memcpy(&v, p_, sizeof(v));
+                p_ += sizeof(v);
+                return v;
+            }
+            void bytes(uint8_t *v, uint16_t n)
+            {
+                memcpy(v, p_, n);
+                p_ += n;
+            }
+
+        private:
+            const uint8_t *p_;
+        };
+    } // namespace
+
+    uint16_t encode(const GimbalCommand &command, uint8_t (&out)[GIMBAL_COMMAND_SIZE])
+    {
+        Writer w(out);
+        w.u8((uint8_t)BlockType::GimbalCommand);
+        w.bytes(command.remote, sizeof(command.remote));
+        w.f32(command.vx);
+        w.f32(command.vy);
+        w.f32(command.wz);
+        w.f32(command.yaw_relative_deg);
+        w.u8(command.chassis_mode);
+        w.u8(command.flags);
+        w.u32(command.stamp_us);
+        return GIMBAL_COMMAND_SIZE;
+    }
+
+    uint16_t encode(const RefereeInfo &referee, uint8_t (&out)[REFEREE_SIZE])
+    {
+        Writer w(out);
+        w.u8((uint8_t)BlockType::Referee);
+        w.u8(referee.robot_id);
+        w.u8(referee.robot_level);
+        w.u16(referee.remaining_hp);
+        w.u16(referee.shooter_heat);
+        w.u16(referee.shooter_heat_limit);
+        w.u16(referee.shooter_cooling);
+        w.u16(referee.chassis_power_limit);
+        w.u16(referee.buffer_energy);
+        w.f32(referee.bullet_speed);
+        w.u8(referee.game_progress);
+        w.u8(referee.power_output);
+        return REFEREE_SIZE;
+    }
+
+    bool decode(const uint8_t *data, uint16_t size, GimbalCommand &command)
+    {
+        if (size != GIMBAL_COMMAND_SIZE || data[0] != (uint8_t)BlockType::GimbalCommand)
+        {
+            return false;
+        }
+
+        Reader r(data + 1);
+        r.bytes(command.remote, sizeof(command.remote));
+        command.vx = r.f32();
+        command.vy = r.f32();
+        command.wz = r.f32();
+        command.yaw_relative_deg = r.f32();
+        command.chassis_mode = r.u8();
+        command.flags = r.u8();
+        command.stamp_us = r.u32();
+        return true;
+    }
+
+    bool decode(const uint8_t *data, uint16_t size, RefereeInfo &referee)
+    {
+        if (size != REFEREE_SIZE || data[0] != (uint8_t)BlockType::Referee)
+        {
+            return false;
+        }
+
+        Reader r(data + 1);
+        referee.robot_id = r.u8();
+        referee.robot_level = r.u8();
+        referee.remaining_hp = r.u16();
+        referee.shooter_heat = r.u16();
+        referee.shooter_heat_limit = r.u16();
+        referee.shooter_cooling = r.u16();
+        referee.chassis_power_limit = r.u16();
+        referee.buffer_energy = r.u16();
+        referee.bullet_speed = r.f32();
+        referee.game_progress = r.u8();
+        referee.power_output = r.u8();
+        return true;
+    }
+
+    BoardLink::BoardLink(HAL::CAN::CanDeviceId can_bus, HAL::CAN::ID_t tx_id, HAL::CAN::ID_t rx_id, int timeThreshold)
+        : can_bus_(can_bus), transport_(tx_id, rx_id, HAL::CAN::TRANSPORT::Mode::Fast), statewatch_(timeThreshold)
+    {
+    }
+
+    bool BoardLink::start()
+    {
+        transport_.set_rx_handler([this](const uint8_t *data, uint16_t size) { onMessage(data, size); });
+        return transport_.start(HAL::CAN::get_can_bus_instance().get_device(can_bus_));
+    }
+
+    uint32_t BoardLink::remoteTime_us()
+    {
+        if (sync_ == nullptr)
+        {
+            return 0;
+        }
+        // 应答方未同步时to_remote_time()原样返回，即本板时间
+        return (uint32_t)sync_->to_remote_time(sync_->local_time_us());
+    }
+
+    bool BoardLink::sendCommand(const GimbalCommand &command)
+    {
+        GimbalCommand stamped = command;
+        stamped.stamp_us = remoteTime_us();
+
+        uint8_t buffer[GIMBAL_COMMAND_SIZE];
+        return transport_.send(buffer, encode(stamped, buffer));
+    }
+
+    bool BoardLink::sendReferee(const RefereeInfo &referee)
+    {
+        uint8_t buffer[REFEREE_SIZE];
+        return transport_.send(buffer, encode(referee, buffer));
+    }
+
+    void BoardLink::onMessage(const uint8_t *data, uint16_t size)
+    {
+        bool valid = false;
+        switch ((BlockType)data[0])
+        {
+        case BlockType::GimbalCommand:
+            valid = decode(data, size, command_);
+            command_count_ += valid;
+            if (valid && sync_ != nullptr && sync_->synced())
+            {
+                command_latency_us_ = remoteTime_us() - command_.stamp_us;
+            }
+            break;
+        case BlockType::Referee:
+            valid = decode(data, size, referee_);
+            referee_count_ += valid;
+            break;
+        default:
+            break;
+        }
+
+        if (valid)
+        {
+            statewatch_.UpdateLastTime();
+        }
+    }
+
+    uint32_t BoardLink::getCommandAge_us()
+    {
+        if (sync_ == nullptr || !sync_->synced() || command_count_ == 0)
+        {
+            return 0;
+        }
+        return remoteTime_us() - command_.stamp_us;
+    }
+
+    bool BoardLink::isConnected()
+    {
+        statewatch_.UpdateTime();
+        statewatch_.CheckStatus();
+        if (statewatch_.GetStatus() == BSP::WATCH_STATE::Status::OFFLINE)
+        {
+            BSP::WATCH_STATE::BuzzerManagerSimple::getInstance().requestCommunicationRing();
+        }
+        return statewatch_.GetStatus() == BSP::WATCH_STATE::Status::ONLINE;
+    }
+} // namespace BSP::BoardLink
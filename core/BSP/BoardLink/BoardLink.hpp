@@ -0,0 +1,153 @@
+#ifndef BOARD_LINK_HPP
+#define BOARD_LINK_HPP
+
+#pragma once
+
+#include "../user/core/BSP/Common/StateWatch/state_watch.hpp"
+#include "../user/core/HAL/CAN/can_hal.hpp"
+#include "../user/core/HAL/CAN/timesync/can_time_sync.hpp"
+#include "../user/core/HAL/CAN/transport/can_transport.hpp"
+#include <cstdint>
+
+namespace BSP::BoardLink
+{
+    // 数据块类型（消息第一个字节）
+    enum class BlockType : uint8_t
+    {
+        GimbalCommand = 0x01, // 云台→底盘
+        Referee = 0x02,       // 底盘→云台
+    };
+
+    /**
+     * @brief 云台→底盘控制块
+     */
+    struct GimbalCommand
+    {
+        uint8_t remote[18];     // DT7原始数据，底盘板可直接用RemoteController::parseData()解析
+        float vx;               // 底盘目标速度X（m/s）
+        float vy;               // 底盘目标速度Y（m/s）
+        float wz;               // 底盘目标角速度（rad/s）
+        float yaw_relative_deg; // 云台相对底盘的yaw角（度）
+        uint8_t chassis_mode;   // 底盘模式，由机器人代码定义
+        uint8_t flags;          // 标志位，由机器人代码定义
+        uint32_t stamp_us;      // 发送时刻（云台板时间，微秒），由sendCommand()填写
+    };
+
+    /**
+     * @brief 底盘→云台裁判系统块
+     */
+    struct RefereeInfo
+    {
+        uint8_t robot_id;
+        uint8_t robot_level;
+        uint16_t remaining_hp;
+        uint16_t shooter_heat;        // 当前枪口热量
+        uint16_t shooter_heat_limit;  // 枪口热量上限
+        uint16_t shooter_cooling;     // 每秒冷却值
+        uint16_t chassis_power_limit; // 底盘功率上限（W）
+        uint16_t buffer_energy;       // 缓冲能量（J）
+        float bullet_speed;           // 最近一发弹速（m/s）
+        uint8_t game_progress;        // 比赛阶段
+        uint8_t power_output;         // 电源输出：bit0云台 bit1底盘 bit2发射
+    };
+
+    // 编码后的长度（含类型字节），按小端逐字段编码，与结构体内存布局无关
+    constexpr uint16_t GIMBAL_COMMAND_SIZE = 1 + 18 + 4 * 4 + 2 + 4;
+    constexpr uint16_t REFEREE_SIZE = 1 + 2 + 2 * 6 + 4 + 2;
+
+    static_assert(GIMBAL_COMMAND_SIZE <= HAL_CAN_TRANSPORT_MAX_PAYLOAD, "控制块超过分段传输缓冲区");
+    static_assert(REFEREE_SIZE <= HAL_CAN_TRANSPORT_MAX_PAYLOAD, "裁判系统块超过分段传输缓冲区");
+
+    /**
+     * @brief 编码/解码数据块，解码时类型或长度不符返回false
+     */
+    uint16_t encode(const GimbalCommand &command, uint8_t (&out)[GIMBAL_COMMAND_SIZE]);
+    uint16_t encode(const RefereeInfo &referee, uint8_t (&out)[REFEREE_SIZE]);
+    bool decode(const uint8_t *data, uint16_t size, GimbalCommand &command);
+    bool decode(const uint8_t *data, uint16_t size, RefereeInfo &referee);
+
+    /**
+     * @brief 云台板与底盘板之间的CAN链路
+     *
+     * 用分段传输（快速模式，不使用流控帧）替代UART6转发DT7原始数据：
+     * 云台板周期发送GimbalCommand，底盘板周期发送RefereeInfo，两块板使用同一个类，收发ID互换。
+     *
+     * @code
+     * // 云台板
+     * BSP::BoardLink::BoardLink link(HAL::CAN::CanDeviceId::HAL_Can2, 0x310, 0x311);
+     * // 底盘板
+     * BSP::BoardLink::BoardLink link(HAL::CAN::CanDeviceId::HAL_Can2, 0x311, 0x310);
+     *
+     * link.start();           // 在apply_id_filters()之前
+     * link.sendCommand(cmd);  // 或sendReferee()
+     * link.poll();            // 与drain_rx()同一个任务中周期调用
+     * @endcode
+     *
+     * 底盘板调用setTimeSync()绑定时钟同步（请求方）后，可以用getCommandLatency_us()得到控制块从云台板发出到
+     * 在底盘板解码完成的延迟，用getCommandAge_us()得到当前控制块的“年龄”；云台板需要绑定应答方的实例，
+     * 未绑定时stamp_us为0
+     */
+    class BoardLink
+    {
+    public:
+        BoardLink(HAL::CAN::CanDeviceId can_bus, HAL::CAN::ID_t tx_id, HAL::CAN::ID_t rx_id, int timeThreshold = 100);
+
+        // 绑定CAN设备并登记接收ID
+        bool start();
+
+        // 绑定时钟同步，时间戳和延迟都按云台板时间计算
+        void setTimeSync(HAL::CAN::TIMESYNC::CanTimeSync *sync) { sync_ = sync; }
+
+        // 发送数据块，上一块还未发完时返回false；控制块的stamp_us由此处填写
+        bool sendCommand(const GimbalCommand &command);
+        bool sendReferee(const RefereeInfo &referee);
+
+        // 周期调用：继续发送并检查超时
+        void poll()
+        {
+            transport_.poll();
+        }
+
+        // 最近一次收到的数据块
+        const GimbalCommand &getCommand() const { return command_; }
+        const RefereeInfo &getReferee() const { return referee_; }
+
+        // 收到过的数据块数量，可用于判断是否有新数据
+        uint32_t getCommandCount() const { return command_count_; }
+        uint32_t getRefereeCount() const { return referee_count_; }
+
+        // 最近一个控制块的传输延迟（微秒），时钟未同步时为0
+        uint32_t getCommandLatency_us() const { return command_latency_us_; }
+
+        // 当前控制块距离发出已经过去多久（微秒），时钟未同步时为0
+        uint32_t getCommandAge_us();
+
+        // 链路是否在线（任意数据块都会刷新），离线时请求蜂鸣器提示
+        bool isConnected();
+
+        HAL::CAN::TRANSPORT::TransportStats getStats() const
+        {
+            return transport_.get_stats();
+        }
+
+    private:
+        const HAL::CAN::CanDeviceId can_bus_;
+        HAL::CAN::TRANSPORT::CanTransport transport_;
+        BSP::WATCH_STATE::StateWatch statewatch_;
+
+        GimbalCommand command_ = {};
+        RefereeInfo referee_ = {};
+        uint32_t command_count_ = 0;
+        uint32_t referee_count_ = 0;
+
+        HAL::CAN::TIMESYNC::CanTimeSync *sync_ = nullptr;
+        uint32_t command_latency_us_ = 0;
+
+        // 当前的云台板时间（微秒，低32位），未绑定时钟同步时为0
+        uint32_t remoteTime_us();
+
+        void onMessage(const uint8_t *data, uint16_t size);
+    };
+} // namespace BSP::BoardLink
+
+#endif
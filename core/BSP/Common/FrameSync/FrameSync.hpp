@@ -0,0 +1,293 @@
+#ifndef FRAME_SYNC_HPP
+#define FRAME_SYNC_HPP
+
+#pragma once
+
+#include "../user/core/HAL/DELEGATE/delegate.hpp"
+#include <cstdint>
+#include <cstring>
+
+namespace BSP::FrameSync
+{
+    // 不校验
+    struct NoChecksum
+    {
+        static bool check(const uint8_t *, uint16_t) { return true; }
+    };
+
+    // 同步统计
+    struct Stats
+    {
+        uint32_t bytes;          // 输入的总字节数
+        uint32_t frames;         // 校验通过的帧数
+        uint32_t skipped_bytes;  // 帧头之外被丢弃的字节数
+        uint32_t length_errors;  // 长度字段超出范围
+        uint32_t checksum_errors; // 校验失败
+    };
+
+    // 帧回调，frame指向内部缓冲区，只在回调期间有效
+    using FrameHandler = HAL::DELEGATE::InplaceFunction<void(const uint8_t *frame, uint16_t size)>;
+
+    /**
+     * @brief 增量式字节流帧同步器（状态机）
+     *
+     * 按到达顺序输入任意长度的数据块，每个字节只看一次（长度或校验出错时只在已缓存的这一帧内重新找帧头），
+     * 校验通过的完整帧通过回调交出。
+     *
+     * Format描述帧格式：
+     * @code
+     * struct Format
+     * {
+     *     static constexpr uint8_t HEADER[] = {0x5A, 0xA5}; // 帧头
+     *     static constexpr uint16_t LENGTH_OFFSET = 2;      // 长度字段在帧中的位置
+     *     static constexpr uint8_t LENGTH_SIZE = 2;         // 长度字段字节数（1或2，小端），0表示定长帧
+     *     // 由长度字段计算整帧长度（含帧头和校验），定长帧时参数为0
+     *     static constexpr uint32_t frameSize(uint16_t length) { return 6 + length; }
+     * };
+     * @endcode
+     *
+     * Checksum为校验策略，提供static bool check(const uint8_t *frame, uint16_t size)，对整帧校验。
+     * MaxFrameSize为允许的最大帧长，也是内部缓冲区的大小，长度字段超出时丢弃该帧头重新同步。
+     *
+     * 帧头第一个字节之外的部分如果与帧头开头重叠（如A5 A5 5A），失配时可能错过一个帧头，选择帧头时应避免
+     */
+    template <typename Format, typename Checksum, uint16_t MaxFrameSize>
+    class FrameSync
+    {
+        static constexpr uint8_t HEADER_SIZE = sizeof(Format::HEADER);
+        static constexpr uint16_t LENGTH_END = Format::LENGTH_OFFSET + Format::LENGTH_SIZE;
+
+        static_assert(HEADER_SIZE > 0, "帧头至少1个字节");
+        static_assert(Format::LENGTH_SIZE <= 2, "长度字段最多2个字节");
+        static_assert(Format::LENGTH_SIZE == 0 || Format::LENGTH_OFFSET >= HEADER_SIZE, "长度字段不能与帧头重叠");
+        static_assert(LENGTH_END <= MaxFrameSize, "最大帧长小于长度字段的位置");
+
+    public:
+        explicit FrameSync(FrameHandler handler = FrameHandler()) : handler_(handler) {}
+
+        void setHandler(FrameHandler handler) { handler_ = handler; }
+
+        // 输入一段数据，其中的完整帧在本次调用中交出
+        void feed(const uint8_t *data, uint16_t size)
+        {
+            stats_.bytes += size;
+            consume(data, size);
+        }
+
+        // 输入分为两段的数据（如HAL::UART::RxSpan），要求有first/first_size/second/second_size成员
+        template <typename Span>
+        void feed(const Span &span)
+        {
+            feed(span.first, span.first_size);
+            feed(span.second, span.second_size);
+        }
+
+        // 丢弃已缓存的半帧
+        void reset()
+        {
+            state_ = State::Header;
+            fill_ = 0;
+            replay_pos_ = 0;
+            replay_end_ = 0;
+        }
+
+        Stats getStats() const { return stats_; }
+
+    private:
+        enum class State : uint8_t
+        {
+            Header, // 匹配帧头
+            Length, // 收集到长度字段为止
+            Body,   // 收集剩余字节
+        };
+
+        FrameHandler handler_;
+        Stats stats_ = {};
+
+        State state_ = State::Header;
+        uint16_t fill_ = 0;     // buffer_中已有的字节数
+        uint16_t expected_ = 0; // 整帧长度，Body状态有效
+
+        // 出错后需要重新输入的缓存数据位于buffer_[replay_pos_, replay_end_)，总在fill_之后
+        uint16_t replay_pos_ = 0;
+        uint16_t replay_end_ = 0;
+
+        uint8_t buffer_[MaxFrameSize];
+
+        void consume(const uint8_t *data, uint16_t size)
+        {
+            for (;;)
+            {
+                // 缓存数据在新输入之前
+                while (replay_pos_ < replay_end_)
+                {
+                    replay_pos_ += step(buffer_ + replay_pos_, replay_end_ - replay_pos_);
+                    advance();
+                }
+                if (size == 0)
+                {
+                    return;
+                }
+
+                const uint16_t used = step(data, size);
+                data += used;
+                size -= used;
+                advance();
+            }
+        }
+
+        // 按当前状态消耗输入，返回消耗的字节数
+        uint16_t step(const uint8_t *data, uint16_t size)
+        {
+            switch (state_)
+            {
+            case State::Header:
+                return matchHeader(data, size);
+            case State::Length:
+                return collect(data, size, LENGTH_END);
+            case State::Body:
+            default:
+                return collect(data, size, expected_);
+            }
+        }
+
+        // 当前阶段收齐后进入下一阶段
+        void advance()
+        {
+            if (state_ == State::Header && fill_ == HEADER_SIZE)
+            {
+                if (Format::LENGTH_SIZE == 0)
+                {
+                    beginBody();
+                }
+                else
+                {
+                    state_ = State::Length;
+                }
+            }
+            else if (state_ == State::Length && fill_ == LENGTH_END)
+            {
+                beginBody();
+            }
+            else if (state_ == State::Body && fill_ == expected_)
+            {
+                finishFrame();
+            }
+        }
+
+        // 帧头匹配：空闲时用memchr跳过不可能是帧头的字节，匹配完整后返回
+        uint16_t matchHeader(const uint8_t *data, uint16_t size)
+        {
+            uint16_t i = 0;
+            if (fill_ == 0)
+            {
+                const void *hit = memchr(data, Format::HEADER[0], size);
+                if (hit == nullptr)
+                {
+                    stats_.skipped_bytes += size;
+                    return size;
+                }
+                i = (uint16_t)((const uint8_t *)hit - data);
+                stats_.skipped_bytes += i;
+            }
+
+            for (; i < size; ++i)
+            {
+                const uint8_t byte = data[i];
+                if (byte != Format::HEADER[fill_])
+                {
+                    // 失配：已匹配的字节丢弃，当前字节可能是新帧头的开始
+                    stats_.skipped_bytes += fill_;
+                    fill_ = 0;
+                    if (byte != Format::HEADER[0])
+                    {
+                        ++stats_.skipped_bytes;
+                        continue;
+                    }
+                }
+                buffer_[fill_++] = byte;
+                if (fill_ == HEADER_SIZE)
+                {
+                    return i + 1;
+                }
+            }
+            return size;
+        }
+
+        // 收集到target字节为止；重新输入时源和目标在同一缓冲区，使用memmove
+        uint16_t collect(const uint8_t *data, uint16_t size, uint16_t target)
+        {
+            const uint16_t need = target - fill_;
+            const uint16_t n = size < need ? size : need;
+            memmove(buffer_ + fill_, data, n);
+            fill_ += n;
+            return n;
+        }
+
+        void beginBody()
+        {
+            uint16_t length = 0;
+            if (Format::LENGTH_SIZE == 1)
+            {
+                length = buffer_[Format::LENGTH_OFFSET];
+            }
+            else if (Format::LENGTH_SIZE == 2)
+            {
+                length = buffer_[Format::LENGTH_OFFSET] | (uint16_t)buffer_[Format::LENGTH_OFFSET + 1] << 8;
+            }
+
+            const uint32_t frame_size = Format::frameSize(length);
+            if (frame_size < fill_ || frame_size > MaxFrameSize)
+            {
+                ++stats_.length_errors;
+                resync();
+                return;
+            }
+
+            expected_ = (uint16_t)frame_size;
+            state_ = State::Body;
+            if (fill_ == expected_)
+            {
+                finishFrame();
+            }
+        }
+
+        void finishFrame()
+        {
+            if (!Checksum::check(buffer_, expected_))
+            {
+                ++stats_.checksum_errors;
+                resync();
+                return;
+            }
+
+            ++stats_.frames;
+            state_ = State::Header;
+            fill_ = 0;
+            if (handler_)
+            {
+                handler_(buffer_, expected_);
+            }
+        }
+
+        /**
+         * 当前帧头作废。新的帧头只可能在帧头第一个字节之后，把已缓存的buffer_[1, fill_)和
+         * 尚未重新输入完的数据拼在缓冲区开头，作为新输入重新处理（只在出错时发生，长度不超过一帧）
+         */
+        void resync()
+        {
+            const uint16_t cached = fill_;
+            const uint16_t rest = replay_end_ - replay_pos_;
+            state_ = State::Header;
+            fill_ = 0;
+
+            ++stats_.skipped_bytes;
+            memmove(buffer_, buffer_ + 1, cached - 1);
+            memmove(buffer_ + cached - 1, buffer_ + replay_pos_, rest);
+            replay_pos_ = 0;
+            replay_end_ = cached - 1 + rest;
+        }
+    };
+} // namespace BSP::FrameSync
+
+#endif
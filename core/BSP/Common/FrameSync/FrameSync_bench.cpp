@@ -0,0 +1,245 @@
+#include "FrameSync_bench.hpp"
+
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../user/core/Alg/CRC/crc.hpp"
+#include "../user/core/BSP/IMU/HI12Base.hpp"
+#include "FrameSync.hpp"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace BSP::FrameSync
+{
+    namespace
+    {
+        constexpr uint16_t FRAME_SIZE = 82;
+        constexpr uint16_t PAYLOAD_SIZE = FRAME_SIZE - 6;
+        constexpr uint16_t MAX_FEED = 60000;
+
+        // 固定种子的xorshift32，结果与平台的rand()无关
+        struct Random
+        {
+            uint32_t state;
+
+            uint32_t next()
+            {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                return state;
+            }
+
+            uint32_t below(uint32_t n) { return next() % n; }
+        };
+
+        // HI12Base::crc16_update改用查表之前的逐位实现
+        struct Crc16BitwiseChecksum
+        {
+            static bool check(const uint8_t *frame, uint16_t size)
+            {
+                uint16_t crc = ALG::CHECKSUM::detail::crc16_ccitt_bitwise(0, frame, 4);
+                crc = ALG::CHECKSUM::detail::crc16_ccitt_bitwise(crc, frame + 6, size - 6);
+                return crc == (frame[4] | (uint16_t)frame[5] << 8);
+            }
+        };
+
+        // 最后一个字节为前面所有字节的累加和
+        struct Sum8Checksum
+        {
+            static bool check(const uint8_t *frame, uint16_t size)
+            {
+                uint8_t sum = 0;
+                for (uint16_t i = 0; i + 1 < size; ++i)
+                {
+                    sum += frame[i];
+                }
+                return sum == frame[size - 1];
+            }
+        };
+
+        std::vector<uint8_t> make_stream(BenchCheck check, bool corrupt, uint32_t frames, uint32_t &good_frames)
+        {
+            Random random{1};
+            std::vector<uint8_t> stream;
+            stream.reserve((size_t)frames * (FRAME_SIZE + 2));
+            good_frames = 0;
+
+            for (uint32_t k = 0; k < frames; ++k)
+            {
+                uint8_t frame[FRAME_SIZE] = {0x5A, 0xA5, PAYLOAD_SIZE, 0};
+                for (uint16_t i = 6; i < FRAME_SIZE; ++i)
+                {
+                    frame[i] = (uint8_t)random.next();
+                }
+                if (check == BenchCheck::Sum8)
+                {
+                    frame[4] = frame[5] = 0;
+                    uint8_t sum = 0;
+                    for (uint16_t i = 0; i + 1 < FRAME_SIZE; ++i)
+                    {
+                        sum += frame[i];
+                    }
+                    frame[FRAME_SIZE - 1] = sum;
+                }
+                else
+                {
+                    uint16_t crc = 0;
+                    IMU::HI12Base::crc16_update(&crc, frame, 4);
+                    IMU::HI12Base::crc16_update(&crc, frame + 6, PAYLOAD_SIZE);
+                    frame[4] = crc & 0xFF;
+                    frame[5] = crc >> 8;
+                }
+
+                if (corrupt && random.below(10) == 0)
+                {
+                    frame[random.below(FRAME_SIZE)] ^= (uint8_t)(1u << random.below(8));
+                }
+                else
+                {
+                    ++good_frames;
+                }
+                if (corrupt && random.below(10) == 0)
+                {
+                    const uint32_t garbage = random.below(20);
+                    for (uint32_t i = 0; i < garbage; ++i)
+                    {
+                        stream.push_back((uint8_t)random.next());
+                    }
+                }
+                stream.insert(stream.end(), frame, frame + FRAME_SIZE);
+            }
+            return stream;
+        }
+
+        template <typename Checksum>
+        BenchResult run(const std::vector<uint8_t> &stream, BenchInput input, uint32_t rounds)
+        {
+            uint32_t received = 0;
+            FrameSync<IMU::HI12Format, Checksum, IMU::HI12_MAX_FRAME_SIZE> sync(
+                [&received](const uint8_t *, uint16_t) { ++received; });
+
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t r = 0; r < rounds; ++r)
+            {
+                // 每一轮的切分相同
+                Random random{2};
+                size_t pos = 0;
+                while (pos < stream.size())
+                {
+                    size_t n = input == BenchInput::Whole ? stream.size() - pos
+                               : input == BenchInput::Bytes ? 1
+                                                             : 1 + random.below(16);
+                    n = n < stream.size() - pos ? n : stream.size() - pos;
+                    while (n > 0)
+                    {
+                        const uint16_t m = n > MAX_FEED ? MAX_FEED : (uint16_t)n;
+                        sync.feed(stream.data() + pos, m);
+                        pos += m;
+                        n -= m;
+                    }
+                }
+            }
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            const Stats stats = sync.getStats();
+            BenchResult result = {};
+            result.throughput_kBps = seconds > 0 ? (uint32_t)(stream.size() * rounds / seconds / 1000) : 0;
+            result.stream_bytes = (uint32_t)stream.size();
+            result.received = received / rounds;
+            result.checksum_errors = stats.checksum_errors / rounds;
+            result.length_errors = stats.length_errors / rounds;
+            return result;
+        }
+
+        const char *input_name(BenchInput input)
+        {
+            switch (input)
+            {
+            case BenchInput::Whole:
+                return "whole";
+            case BenchInput::Chunks:
+                return "1~16B chunks";
+            default:
+                return "1B";
+            }
+        }
+
+        const char *check_name(BenchCheck check)
+        {
+            switch (check)
+            {
+            case BenchCheck::Crc16:
+                return "crc16 table";
+            case BenchCheck::Crc16Bitwise:
+                return "crc16 bitwise";
+            case BenchCheck::Sum8:
+                return "sum8";
+            default:
+                return "none";
+            }
+        }
+    } // namespace
+
+    BenchResult run_benchmark(BenchInput input, BenchCheck check, bool corrupt, uint32_t frames, uint32_t rounds)
+    {
+        if (frames == 0 || rounds == 0)
+        {
+            return BenchResult{};
+        }
+
+        uint32_t good_frames = 0;
+        const std::vector<uint8_t> stream = make_stream(check, corrupt, frames, good_frames);
+
+        BenchResult result;
+        switch (check)
+        {
+        case BenchCheck::Crc16:
+            result = run<IMU::HI12Checksum>(stream, input, rounds);
+            break;
+        case BenchCheck::Crc16Bitwise:
+            result = run<Crc16BitwiseChecksum>(stream, input, rounds);
+            break;
+        case BenchCheck::Sum8:
+            result = run<Sum8Checksum>(stream, input, rounds);
+            break;
+        default:
+            result = run<NoChecksum>(stream, input, rounds);
+            break;
+        }
+        result.good_frames = good_frames;
+        return result;
+    }
+
+    void print_benchmark(uint32_t frames)
+    {
+        struct Case
+        {
+            BenchInput input;
+            BenchCheck check;
+            bool corrupt;
+        };
+        const Case cases[] = {
+            {BenchInput::Whole, BenchCheck::Crc16, false},
+            {BenchInput::Chunks, BenchCheck::Crc16, false},
+            {BenchInput::Chunks, BenchCheck::Crc16, true},
+            {BenchInput::Whole, BenchCheck::Crc16Bitwise, false},
+            {BenchInput::Chunks, BenchCheck::Crc16Bitwise, false},
+            {BenchInput::Chunks, BenchCheck::Crc16Bitwise, true},
+            {BenchInput::Chunks, BenchCheck::Sum8, false},
+            {BenchInput::Bytes, BenchCheck::None, false},
+        };
+
+        std::printf("FrameSync, %u HI12 frames x %u bytes\n", frames, FRAME_SIZE);
+        for (const Case &c : cases)
+        {
+            const BenchResult r = run_benchmark(c.input, c.check, c.corrupt, frames);
+            std::printf("%-12s %-13s %-7s %4u.%u MB/s  received %u/%u  checksum errors %u  length errors %u\n",
+                        input_name(c.input), check_name(c.check), c.corrupt ? "corrupt" : "clean",
+                        r.throughput_kBps / 1000, r.throughput_kBps % 1000 / 100, r.received, r.good_frames,
+                        r.checksum_errors, r.length_errors);
+        }
+    }
+} // namespace BSP::FrameSync
+
+#endif // HAL_CAN_VIRTUAL
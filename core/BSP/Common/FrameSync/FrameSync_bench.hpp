@@ -0,0 +1,61 @@
+/**
+ * @file FrameSync_bench.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief 帧同步器在HI12数据流上的吞吐量测量（只在PC端编译）
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+
+#ifdef HAL_CAN_VIRTUAL
+
+#include <cstdint>
+
+namespace BSP::FrameSync
+{
+    // 输入方式
+    enum class BenchInput : uint8_t
+    {
+        Whole,  // 整段输入（每次最多60000字节）
+        Chunks, // 1~16字节随机切分
+        Bytes,  // 逐字节输入
+    };
+
+    // 校验方式
+    enum class BenchCheck : uint8_t
+    {
+        Crc16,        // HI12Checksum（Alg/CRC查表实现）
+        Crc16Bitwise, // 对照：HI12Base原来的逐位CRC16
+        Sum8,         // 8位累加和
+        None,         // NoChecksum
+    };
+
+    // 一组测量结果
+    struct BenchResult
+    {
+        uint32_t throughput_kBps; // 吞吐量（1000字节/秒）
+        uint32_t stream_bytes;    // 数据流长度（字节）
+        uint32_t good_frames;     // 数据流中完好的帧数
+        uint32_t received;        // 回调收到的帧数
+        uint32_t checksum_errors; // 校验错误
+        uint32_t length_errors;   // 长度错误
+    };
+
+    /**
+     * @brief 生成frames个82字节的HI12帧组成的数据流，按input切分后重复输入rounds次，统计每一轮的结果
+     *
+     * 数据和切分由固定种子的伪随机数生成，每次运行相同。corrupt为true时10%的帧翻转1位、
+     * 10%的帧前插入0~19字节垃圾数据
+     */
+    BenchResult run_benchmark(BenchInput input, BenchCheck check, bool corrupt, uint32_t frames = 20000,
+                              uint32_t rounds = 20);
+
+    // 测量README中的各项，打印到标准输出
+    void print_benchmark(uint32_t frames = 20000);
+} // namespace BSP::FrameSync
+
+#endif // HAL_CAN_VIRTUAL
@@ -3,6 +3,8 @@
 
 #include "../user/core/BSP/Common/StateWatch/state_watch.hpp"
 #include "../user/core/BSP/Common/StateWatch/buzzer_manager.hpp"
+#include "../user/core/BSP/Common/FrameSync/FrameSync.hpp"
+#include "../user/core/Alg/CRC/crc.hpp"
 #include <string.h>
 
 namespace BSP::IMU
@@ -15,7 +17,7 @@ namespace BSP::IMU
             }
             virtual ~HI12Base() = default;
             
-            float R4(uint8_t *p) 
+            float R4(const uint8_t *p) 
             {
                 float r; 
                 memcpy(&r,p,4); 
@@ -43,25 +45,10 @@ namespace BSP::IMU
                 return __builtin_bswap32(r);
             };
 
-            void crc16_update(uint16_t *currentCrc, const uint8_t *src, uint32_t lengthInBytes)
+            // CRC16-CCITT（XMODEM）增量计算，查表实现见Alg/CRC
+            static void crc16_update(uint16_t *currentCrc, const uint8_t *src, uint32_t lengthInBytes)
             {
-                uint16_t crc = *currentCrc;  // 使用16位，不是32位！
-                for (uint32_t j = 0; j < lengthInBytes; ++j)
-                {
-                    crc ^= (src[j] << 8);  // 将字节左移8位后异或
-                    for (uint32_t i = 0; i < 8; ++i)
-                    {
-                        if (crc & 0x8000)  // 检查最高位
-                        {
-                            crc = (crc << 1) ^ 0x1021;
-                        }
-                        else
-                        {
-                            crc <<= 1;
-                        }
-                    }
-                }
-                *currentCrc = crc;
+                *currentCrc = ALG::CHECKSUM::crc16_ccitt_update(*currentCrc, src, lengthInBytes);
             }
 
             void header()
@@ -179,6 +166,32 @@ namespace BSP::IMU
             bool CRC_flag = false;
             bool Verify_flag = false;
     };
+
+    /**
+     * @brief HI12数据帧格式：5A A5 + 长度（2字节小端）+ CRC（2字节小端）+ 数据
+     */
+    struct HI12Format
+    {
+        static constexpr uint8_t HEADER[] = {0x5A, 0xA5};
+        static constexpr uint16_t LENGTH_OFFSET = 2;
+        static constexpr uint8_t LENGTH_SIZE = 2;
+        static constexpr uint32_t frameSize(uint16_t length) { return 6u + length; }
+    };
+
+    // CRC16-CCITT，覆盖帧头和长度（前4字节）以及数据部分，不含CRC本身
+    struct HI12Checksum
+    {
+        static bool check(const uint8_t *frame, uint16_t size)
+        {
+            uint16_t crc = 0;
+            HI12Base::crc16_update(&crc, frame, 4);
+            HI12Base::crc16_update(&crc, frame + 6, size - 6);
+            return crc == (frame[4] | (uint16_t)frame[5] << 8);
+        }
+    };
+
+    // HI12单帧最大长度（浮点输出帧为82字节）
+    constexpr uint16_t HI12_MAX_FRAME_SIZE = 128;
 }
 
 #endif
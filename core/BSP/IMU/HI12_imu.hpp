@@ -2,6 +2,7 @@
 #define HI12_IMU_HPP
 
 #include "HI12Base.hpp"
+#include "../user/core/HAL/PROFILE/profile.hpp"
 
 namespace BSP::IMU
 {
@@ -19,15 +20,25 @@ namespace BSP::IMU
              * @param huart UART句柄，用于与IMU传感器通信
              */
             HI12_float() 
-                : offset(6), acc{0}, gyro{0}, angle{0}, quaternion{0}, last_angle(0), add_angle(0)
+                : offset(6), acc{0}, gyro{0}, angle{0}, quaternion{0}, last_angle(0), add_angle(0),
+                  sync_([this](const uint8_t *frame, uint16_t size) {
+                      if (size == HI12Format::frameSize(76))
+                      {
+                          this->updateTimestamp();
+                          ParseFrame(frame);
+                      }
+                  })
             {
             }
 
+            HI12_float(const HI12_float &) = delete;
+            HI12_float &operator=(const HI12_float &) = delete;
+
             /**
              * @brief 更新IMU数据
              * @param pData 指向原始数据的指针
              * 
-             * 从原始数据中解析出加速度、角速度、角度和四元数信息
+             * 在一次接收的缓冲区中搜索帧头并解析；串口使用循环DMA接收时改用Feed()
              */
             void DataUpdate(uint8_t *pData)
             {
@@ -60,30 +71,36 @@ namespace BSP::IMU
                     
                 if(GetVerify())
                 {
-                    // 解析加速度数据 (单位: g)
-                    acc[0] = this->R4(pData+offset+12);
-                    acc[1] = this->R4(pData+offset+16);
-                    acc[2] = this->R4(pData+offset+20);
-                    
-                    // 解析角速度数据 (单位: °/s)
-                    gyro[0] = this->R4(pData+offset+24);
-                    gyro[1] = this->R4(pData+offset+28);
-                    gyro[2] = this->R4(pData+offset+32);
-                    
-                    // 解析欧拉角数据 (单位: °)
-                    angle[0] = this->R4(pData+offset+48);
-                    angle[1] = this->R4(pData+offset+52);
-                    angle[2] = this->R4(pData+offset+56);
-                    
-                    // 解析四元数数据
-                    quaternion[0] = this->R4(pData+offset+60);
-                    quaternion[1] = this->R4(pData+offset+64);
-                    quaternion[2] = this->R4(pData+offset+68);
-                    quaternion[3] = this->R4(pData+offset+72);
+                    ParseFrame(pData + frame_start);
                 }
 
             }
 
+            /**
+             * @brief 输入串口收到的任意一段数据
+             * @param data 数据指针
+             * @param size 数据长度
+             * 
+             * 数据可以在任意位置被切开，帧同步器逐字节拼帧，CRC校验通过后解析，不会重复扫描已经看过的数据
+             */
+            void Feed(const uint8_t *data, uint16_t size)
+            {
+                sync_.feed(data, size);
+            }
+
+            // 输入分为两段的数据（HAL::UART::RxSpan）
+            template <typename Span>
+            void Feed(const Span &span)
+            {
+                sync_.feed(span);
+            }
+
+            // 帧同步统计（校验失败、丢弃字节数等）
+            BSP::FrameSync::Stats GetSyncStats() const
+            {
+                return sync_.getStats();
+            }
+
             /**
              * @brief 获取加速度数据
              * @param index 索引值 (0:x轴, 1:y轴, 2:z轴)
@@ -176,6 +193,35 @@ namespace BSP::IMU
                 return this->add_angle;
             }
         private:
+            /**
+             * @brief 解析一帧已校验的数据
+             * @param pData 指向帧头的指针
+             */
+            void ParseFrame(const uint8_t *pData)
+            {
+                PROFILE_ZONE("hi12_parse");
+                // 解析加速度数据 (单位: g)
+                acc[0] = this->R4(pData+offset+12);
+                acc[1] = this->R4(pData+offset+16);
+                acc[2] = this->R4(pData+offset+20);
+                
+                // 解析角速度数据 (单位: °/s)
+                gyro[0] = this->R4(pData+offset+24);
+                gyro[1] = this->R4(pData+offset+28);
+                gyro[2] = this->R4(pData+offset+32);
+                
+                // 解析欧拉角数据 (单位: °)
+                angle[0] = this->R4(pData+offset+48);
+                angle[1] = this->R4(pData+offset+52);
+                angle[2] = this->R4(pData+offset+56);
+                
+                // 解析四元数数据
+                quaternion[0] = this->R4(pData+offset+60);
+                quaternion[1] = this->R4(pData+offset+64);
+                quaternion[2] = this->R4(pData+offset+68);
+                quaternion[3] = this->R4(pData+offset+72);
+            }
+
             int offset;              ///< 数据偏移量
             float acc[3];            ///< 加速度数据 [x, y, z]
             float gyro[3];           ///< 角速度数据 [x, y, z]
@@ -183,6 +229,7 @@ namespace BSP::IMU
             float quaternion[4];     ///< 四元数数据 [w, x, y, z]
             float last_angle;
             float add_angle;
+            BSP::FrameSync::FrameSync<HI12Format, HI12Checksum, HI12_MAX_FRAME_SIZE> sync_;
     };
 
     /**
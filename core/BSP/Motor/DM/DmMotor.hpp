@@ -4,6 +4,7 @@
 #pragma once
 #include "../user/core/BSP/Motor/MotorBase.hpp"
 #include "../user/core/HAL/CAN/can_hal.hpp"
+#include "../user/core/HAL/PROFILE/profile.hpp"
 
 namespace BSP::Motor::DM
 {
@@ -61,9 +62,12 @@ namespace BSP::Motor::DM
 
         /**
          * @brief 构造函数
+         *
+         * @param can_bus 电机所在的CAN总线
          */
-        DMMotorBase(uint16_t Init_id, const uint8_t (&recv_ids)[N], const uint32_t (&send_ids)[N], Parameters params)
-            : init_address(Init_id), params_(params)
+        DMMotorBase(uint16_t Init_id, const uint8_t (&recv_ids)[N], const uint32_t (&send_ids)[N], Parameters params,
+                    HAL::CAN::CanDeviceId can_bus)
+            : MotorBase<N>(100, can_bus), init_address(Init_id), params_(params)
         {
             for (uint8_t i = 0; i < N; ++i)
             {
@@ -120,28 +124,52 @@ namespace BSP::Motor::DM
         {
             for (uint8_t i = 0; i < N; ++i)
             {
-                if (frame.id == init_address + recv_idxs_[i])
+                HAL::CAN::ID_t id;
+                if (getRecvId(i, id) && frame.id == id)
                 {
-                    const uint8_t* pData = frame.data;
-                        
-                    feedback_[i].id = (pData[0] >> 4) & 0xF;
-                    feedback_[i].err = pData[0] & 0xF;
-                    feedback_[i].angle = (pData[1] << 8) | pData[2];
-                    feedback_[i].velocity = (pData[3] << 4) | (pData[4] >> 4);
-                    feedback_[i].torque = ((pData[4] & 0xF) << 8) | pData[5];
-                    feedback_[i].T_Mos = pData[6];
-                    feedback_[i].T_Rotor = pData[7];
-
-                    Configure(i);
-                    this->updateTimestamp(i + 1);                       
+                    ParseSlot(frame, i);
                 }
             }
         }
 
+        /**
+         * @brief 解析已确定槽位的CAN数据（由路由表直接调用）
+         */
+        void ParseSlot(const HAL::CAN::Frame &frame, uint8_t i) override
+        {
+            PROFILE_ZONE("dm_parse");
+            const uint8_t* pData = frame.data;
+
+            feedback_[i].id = (pData[0] >> 4) & 0xF;
+            feedback_[i].err = pData[0] & 0xF;
+            feedback_[i].angle = (pData[1] << 8) | pData[2];
+            feedback_[i].velocity = (pData[3] << 4) | (pData[4] >> 4);
+            feedback_[i].torque = ((pData[4] & 0xF) << 8) | pData[5];
+            feedback_[i].T_Mos = pData[6];
+            feedback_[i].T_Rotor = pData[7];
+
+            Configure(i);
+            this->updateFeedbackTime(i, frame);
+            this->updateTimestamp(i + 1);
+        }
+
+        /**
+         * @brief 获取槽位对应的反馈帧ID
+         */
+        bool getRecvId(uint8_t i, HAL::CAN::ID_t &id) const override
+        {
+            if (i >= N)
+            {
+                return false;
+            }
+            id = init_address + recv_idxs_[i];
+            return true;
+        }
+
         /**
          * @brief DM电机的MIT控制方法
          */
-        void ctrl_Mit(uint8_t id, float _pos, float _vel, 
+        bool ctrl_Mit(uint8_t id, float _pos, float _vel, 
                 float _KP, float _KD, float _torq)
         {
             uint16_t pos_tmp, vel_tmp, kp_tmp, kd_tmp, tor_tmp;
@@ -151,75 +179,42 @@ namespace BSP::Motor::DM
             kd_tmp = float_to_uint(_KD, params_.KD_MIN, params_.KD_MAX, 12);
             tor_tmp = float_to_uint(_torq, params_.T_MIN, params_.T_MAX, 12);
 
-            uint8_t send_data[8];
-            send_data[0] = (pos_tmp >> 8);
-            send_data[1] = (pos_tmp);
-            send_data[2] = (vel_tmp >> 4);
-            send_data[3] = ((vel_tmp & 0xF) << 4) | (kp_tmp >> 8);
-            send_data[4] = kp_tmp;
-            send_data[5] = (kd_tmp >> 4);
-            send_data[6] = ((kd_tmp & 0xF) << 4) | (tor_tmp >> 8);
-            send_data[7] = tor_tmp;
-
-            HAL::CAN::Frame frame;
-            frame.id = send_idxs_[id - 1];
-            frame.dlc = 8;
-            memcpy(frame.data, send_data, sizeof(send_data));
-            frame.is_extended_id = false;
-            frame.is_remote_frame = false;
-            
-            HAL::CAN::get_can_bus_instance().get_can2().send(frame);
+            // 直接编码到待发送的帧中
+            auto frame = HAL::CAN::Frame::make(send_idxs_[id - 1]);
+            frame.data[0] = (pos_tmp >> 8);
+            frame.data[1] = (pos_tmp);
+            frame.data[2] = (vel_tmp >> 4);
+            frame.data[3] = ((vel_tmp & 0xF) << 4) | (kp_tmp >> 8);
+            frame.data[4] = kp_tmp;
+            frame.data[5] = (kd_tmp >> 4);
+            frame.data[6] = ((kd_tmp & 0xF) << 4) | (tor_tmp >> 8);
+            frame.data[7] = tor_tmp;
+
+            return this->getCanDevice().send(frame);
         }
 
 
         /**
          * @brief DM电机的角度速度控制方法
          */
-        void ctrl_AngleVelocity(uint8_t id, float _pos, float _vel)
+        bool ctrl_AngleVelocity(uint8_t id, float _pos, float _vel)
         {
-            uint8_t data[8];
-            uint8_t *pbuf, *vbuf;
-
-            pbuf = (uint8_t*)&_pos;
-            vbuf = (uint8_t*)&_vel;
-
-            for (int i = 0; i < 4; ++i) 
-            {
-                data[i] = pbuf[i];
-                data[4 + i] = vbuf[i];
-            }
+            auto frame = HAL::CAN::Frame::make(0X100 + send_idxs_[id - 1]);
+            frame.put_f32(0, _pos);
+            frame.put_f32(4, _vel);
 
-            HAL::CAN::Frame frame;
-            frame.id = 0X100 + send_idxs_[id - 1];
-            frame.dlc = 8;
-            memcpy(frame.data, data, sizeof(data));
-            frame.is_extended_id = false;
-            frame.is_remote_frame = false;
-            
-            HAL::CAN::get_can_bus_instance().get_can2().send(frame);
+            return this->getCanDevice().send(frame);
         }
 
         /**
          * @brief DM电机的速度控制方法
          */
-        void ctrl_Velocity(uint8_t id, float _vel)
+        bool ctrl_Velocity(uint8_t id, float _vel)
         {
-            uint8_t data[8] = {0};
-            uint8_t *vbuf = (uint8_t*)&_vel;
+            auto frame = HAL::CAN::Frame::make(0X200 + send_idxs_[id - 1]);
+            frame.put_f32(0, _vel);
 
-            for (int i = 0; i < 4; ++i) 
-            {
-                data[i] = vbuf[i];
-            }
-
-            HAL::CAN::Frame frame;
-            frame.id = 0X200 + send_idxs_[id - 1];
-            frame.dlc = 8;
-            memcpy(frame.data, data, sizeof(data));
-            frame.is_extended_id = false;
-            frame.is_remote_frame = false;
-            
-            HAL::CAN::get_can_bus_instance().get_can2().send(frame);
+            return this->getCanDevice().send(frame);
         }
 
 
@@ -227,87 +222,52 @@ namespace BSP::Motor::DM
          * @brief 使能DM电机
          * @param mod 模式可以有3种: MIT = 0, ANGLEVELOCITY = 1, VELOCITY = 2
          */
-        void On(uint8_t id, Model mod)
+        bool On(uint8_t id, Model mod)
         {
-            uint8_t send_data[8] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC};
-            
-            HAL::CAN::Frame frame;
-            if(mod == Model::MIT)
-            {
-                frame.id = send_idxs_[id - 1];
-            }
-            else if(mod == Model::ANGLEVELOCITY)
-            {
-                frame.id = 0x100 + send_idxs_[id - 1];
-            }
-            else if(mod == Model::VELOCITY)
-            {
-                frame.id = 0x200 + send_idxs_[id - 1];
-            }
-            frame.dlc = 8;
-            memcpy(frame.data, send_data, sizeof(send_data));
-            frame.is_extended_id = false;
-            frame.is_remote_frame = false;
-            
-            HAL::CAN::get_can_bus_instance().get_can2().send(frame);
+            return sendSpecial(id, mod, 0xFC);
         }
         
         /**
          * @brief 失能DM电机
          * @param mod 模式可以有3种: MIT = 0, ANGLEVELOCITY = 1, VELOCITY = 2
          */
-        void Off(uint8_t id, Model mod)
+        bool Off(uint8_t id, Model mod)
         {
-            uint8_t send_data[8] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD};
-
-            HAL::CAN::Frame frame;
-            if(mod == Model::MIT)
-            {
-                frame.id = send_idxs_[id - 1];
-            }
-            else if(mod == Model::ANGLEVELOCITY)
-            {
-                frame.id = 0x100 + send_idxs_[id - 1];
-            }
-            else if(mod == Model::VELOCITY)
-            {
-                frame.id = 0x200 + send_idxs_[id - 1];
-            }
-            frame.dlc = 8;
-            memcpy(frame.data, send_data, sizeof(send_data));
-            frame.is_extended_id = false;
-            frame.is_remote_frame = false;
-            
-            HAL::CAN::get_can_bus_instance().get_can2().send(frame);
+            return sendSpecial(id, mod, 0xFD);
         }
 
         /**
          * @brief 清除DM电机错误
          * @param mod 模式可以有3种: MIT = 0, ANGLEVELOCITY = 1, VELOCITY = 2
          */
-        void ClearErr(uint8_t id, Model mod)
+        bool ClearErr(uint8_t id, Model mod)
         {
-            uint8_t send_data[8] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFB};
+            return sendSpecial(id, mod, 0xFB);
+        }
 
-            HAL::CAN::Frame frame;
-            if(mod == Model::MIT)
-            {
-                frame.id = send_idxs_[id - 1];
-            }
-            else if(mod == Model::ANGLEVELOCITY)
+    private:
+        /**
+         * @brief 发送特殊指令帧：前7字节为0xFF，最后一字节为指令
+         *
+         * @param cmd 0xFC使能，0xFD失能，0xFB清除错误
+         */
+        bool sendSpecial(uint8_t id, Model mod, uint8_t cmd)
+        {
+            uint32_t frame_id = send_idxs_[id - 1];
+            if(mod == Model::ANGLEVELOCITY)
             {
-                frame.id = 0x100 + send_idxs_[id - 1];
+                frame_id += 0x100;
             }
             else if(mod == Model::VELOCITY)
             {
-                frame.id = 0x200 + send_idxs_[id - 1];
+                frame_id += 0x200;
             }
-            frame.dlc = 8;
-            memcpy(frame.data, send_data, sizeof(send_data));
-            frame.is_extended_id = false;
-            frame.is_remote_frame = false;
-            
-            HAL::CAN::get_can_bus_instance().get_can2().send(frame);
+
+            auto frame = HAL::CAN::Frame::make(frame_id);
+            memset(frame.data, 0xFF, 7);
+            frame.data[7] = cmd;
+
+            return this->getCanDevice().send(frame);
         }
 
     protected:
@@ -325,9 +285,10 @@ namespace BSP::Motor::DM
     class J4310 : public DMMotorBase<N>
     {
     public:
-        J4310(uint16_t Init_id, const uint8_t (&ids)[N], const uint32_t (&send_idxs)[N])
-            : DMMotorBase<N>(Init_id, ids, send_idxs, 
-                            Parameters(-12.56f, 12.56f, -45.0f, 45.0f, -18.0f, 18.0f, 0.0f, 500.0f, 0.0f, 5.0f))
+        J4310(uint16_t Init_id, const uint8_t (&ids)[N], const uint32_t (&send_idxs)[N],
+              HAL::CAN::CanDeviceId can_bus = HAL::CAN::CanDeviceId::HAL_Can2)
+            : DMMotorBase<N>(Init_id, ids, send_idxs,
+                            Parameters(-12.56f, 12.56f, -45.0f, 45.0f, -18.0f, 18.0f, 0.0f, 500.0f, 0.0f, 5.0f), can_bus)
         {
         }
     };
@@ -339,9 +300,10 @@ namespace BSP::Motor::DM
     class S2325 : public DMMotorBase<N>
     {
     public:
-        S2325(uint16_t Init_id, const uint8_t (&ids)[N], const uint32_t (&send_idxs)[N])
+        S2325(uint16_t Init_id, const uint8_t (&ids)[N], const uint32_t (&send_idxs)[N],
+              HAL::CAN::CanDeviceId can_bus = HAL::CAN::CanDeviceId::HAL_Can2)
             : DMMotorBase<N>(Init_id, ids, send_idxs,
-                            Parameters(-12.5f, 12.5f, -50.0f, 50.0f, -10.0f, 10.0f, 0.0f, 500.0f, 0.0f, 5.0f))
+                            Parameters(-12.5f, 12.5f, -50.0f, 50.0f, -10.0f, 10.0f, 0.0f, 500.0f, 0.0f, 5.0f), can_bus)
         {
         }
     };
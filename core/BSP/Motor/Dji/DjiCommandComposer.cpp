@@ -0,0 +1,127 @@
+#include "DjiCommandComposer.hpp"
+#include "main.h"
+
+namespace BSP::Motor::Dji
+{
+
+DjiCommandComposer::DjiCommandComposer(HAL::CAN::CanDeviceId bus) : bus_(bus)
+{
+}
+
+bool DjiCommandComposer::resolve(uint32_t send_id, int esc_id, uint32_t &group_id, uint8_t &slot)
+{
+    if (esc_id >= 1 && esc_id <= 4)
+    {
+        group_id = send_id;
+        slot = static_cast<uint8_t>(esc_id);
+        return true;
+    }
+
+    if (esc_id < 5 || esc_id > 8)
+    {
+        return false;
+    }
+
+    // 电调ID 5~8 对应下一组控制帧
+    switch (send_id)
+    {
+    case 0x200:
+        group_id = 0x1FF;
+        break;
+    case 0x1FF:
+        group_id = 0x2FF;
+        break;
+    case 0x1FE:
+        group_id = 0x2FE;
+        break;
+    default:
+        return false;
+    }
+    slot = static_cast<uint8_t>(esc_id - 4);
+    return true;
+}
+
+bool DjiCommandComposer::set(uint32_t group_id, uint8_t slot, int16_t value)
+{
+    if (slot < 1 || slot > 4)
+    {
+        return false;
+    }
+
+    Group *group = nullptr;
+    for (uint8_t i = 0; i < group_count_; ++i)
+    {
+        if (groups_[i].frame.id == group_id)
+        {
+            group = &groups_[i];
+            break;
+        }
+    }
+    if (group == nullptr)
+    {
+        if (group_count_ >= MAX_GROUPS)
+        {
+            return false;
+        }
+        group = &groups_[group_count_++];
+        group->frame = HAL::CAN::Frame::make(group_id);
+    }
+
+    group->frame.put_u16_be((slot - 1) * 2, static_cast<uint16_t>(value));
+    group->dirty = true;
+    return true;
+}
+
+bool DjiCommandComposer::flush()
+{
+    auto &can = HAL::CAN::get_can_bus_instance().get_device(bus_);
+    const uint32_t tick = HAL_GetTick();
+
+    bool ok = true;
+    for (uint8_t i = 0; i < group_count_; ++i)
+    {
+        Group &group = groups_[i];
+        if (!group.dirty)
+        {
+            continue;
+        }
+        // 同一节拍内已发送过，数据留到下一节拍，避免共用组ID的电机逐个sendCAN()时每周期发出多帧
+        if (group.sent && group.sent_tick == tick)
+        {
+            ++deferred_frames_;
+            continue;
+        }
+
+        if (can.send(group.frame, HAL::CAN::TxPriority::Control))
+        {
+            ++sent_frames_;
+        }
+        else
+        {
+            ok = false;
+        }
+        group.sent_tick = tick;
+        group.sent = true;
+        group.dirty = false;
+    }
+    return ok;
+}
+
+DjiCommandComposer &get_command_composer(HAL::CAN::CanDeviceId bus)
+{
+    static DjiCommandComposer can1(HAL::CAN::CanDeviceId::HAL_Can1);
+    static DjiCommandComposer can2(HAL::CAN::CanDeviceId::HAL_Can2);
+    static DjiCommandComposer can3(HAL::CAN::CanDeviceId::HAL_Can3);
+
+    switch (bus)
+    {
+    case HAL::CAN::CanDeviceId::HAL_Can2:
+        return can2;
+    case HAL::CAN::CanDeviceId::HAL_Can3:
+        return can3;
+    default:
+        return can1;
+    }
+}
+
+} // namespace BSP::Motor::Dji
@@ -0,0 +1,110 @@
+#ifndef DJI_COMMAND_COMPOSER_HPP
+#define DJI_COMMAND_COMPOSER_HPP
+
+#pragma once
+
+#include "../user/core/HAL/CAN/can_hal.hpp"
+#include <cstdint>
+
+namespace BSP::Motor::Dji
+{
+/**
+ * @brief 大疆电机控制帧合成器（每路CAN一个）
+ *
+ * 大疆电调一帧控制报文携带4个电调的电流/电压（0x200、0x1FF、0x2FF等组ID），
+ * 同一组ID下的多个电机对象共用这一帧。所有电机的setCAN()都写入合成器，
+ * 控制周期结束时调用一次flush()，每个本周期被写过的组ID只发送一帧，
+ * 不同电机对象之间不会再互相覆盖数据。
+ *
+ * 用法：
+ * @code
+ * Motor3508.setCAN(out0, 1);
+ * Motor3508.setCAN(out1, 4);
+ * Motor2006.setCAN(out2, 5);
+ * BSP::Motor::Dji::get_command_composer(HAL::CAN::CanDeviceId::HAL_Can1).flush();
+ * @endcode
+ *
+ * 每个组ID每个系统节拍（HAL_GetTick()，1 ms）最多发送一帧：同一节拍内再次flush()时，
+ * 已发送过的组保持待发送，留到下一节拍的flush()连同新写入的数据一起发送。
+ * 因此逐个电机调用sendCAN()也不会让共用组ID的电机每周期发出多帧，
+ * 但后写入的电机的数据会晚一个节拍，应在所有setCAN()之后只调用一次flush()。
+ *
+ * setCAN()和flush()需在同一个任务中调用
+ */
+class DjiCommandComposer
+{
+  public:
+    // 单路CAN上同时使用的组ID上限
+    static constexpr uint8_t MAX_GROUPS = 4;
+
+    explicit DjiCommandComposer(HAL::CAN::CanDeviceId bus);
+
+    /**
+     * @brief 把电机的发送ID和电调ID换算为组ID和帧内槽位
+     *
+     * 电调ID 1~4 使用send_id本身，5~8 使用下一组：0x200 -> 0x1FF，0x1FF -> 0x2FF，0x1FE -> 0x2FE
+     *
+     * @param send_id 电机对象的发送ID
+     * @param esc_id 电调ID（1 ~ 8）
+     * @param group_id 输出的组ID
+     * @param slot 输出的帧内槽位（1 ~ 4）
+     * @return false 电调ID超出范围或该发送ID没有下一组
+     */
+    static bool resolve(uint32_t send_id, int esc_id, uint32_t &group_id, uint8_t &slot);
+
+    /**
+     * @brief 写入一个槽位的数据
+     *
+     * @param group_id 组ID
+     * @param slot 帧内槽位（1 ~ 4）
+     * @param value 电流/电压
+     * @return false 槽位越界或组ID数量超过MAX_GROUPS
+     */
+    bool set(uint32_t group_id, uint8_t slot, int16_t value);
+
+    /**
+     * @brief 发送本周期被写过的组，每个组ID一帧
+     *
+     * 未被写入的槽位保持上一次的值；本节拍内已发送过的组推迟到下一节拍
+     *
+     * @return false 有帧发送失败（发送队列已满）
+     */
+    bool flush();
+
+    // 累计发送的帧数
+    uint32_t getSentFrames() const
+    {
+        return sent_frames_;
+    }
+
+    // 因同一节拍内已发送过而推迟的次数，不为0说明每个控制周期调用了多次flush()
+    uint32_t getDeferredFrames() const
+    {
+        return deferred_frames_;
+    }
+
+  private:
+    // 每个组直接保存待发送的帧，set()写入帧数据，flush()直接发送，不再经过中间缓冲区
+    struct Group
+    {
+        HAL::CAN::Frame frame;
+        uint32_t sent_tick; // 上一次发送时的HAL_GetTick()
+        bool sent;          // 是否发送过
+        bool dirty;
+    };
+
+    HAL::CAN::CanDeviceId bus_;
+    Group groups_[MAX_GROUPS] = {};
+    uint8_t group_count_ = 0;
+    uint32_t sent_frames_ = 0;
+    uint32_t deferred_frames_ = 0;
+};
+
+/**
+ * @brief 获取指定CAN的合成器
+ */
+DjiCommandComposer &get_command_composer(HAL::CAN::CanDeviceId bus);
+
+} // namespace BSP::Motor::Dji
+
+#endif
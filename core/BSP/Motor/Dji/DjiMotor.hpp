@@ -5,6 +5,8 @@
 // 基础DJI电机实现
 #include "../user/core/BSP/Motor/MotorBase.hpp"
 #include "../user/core/BSP/Common/StateWatch/state_watch.hpp"
+#include "../user/core/BSP/Motor/Dji/DjiCommandComposer.hpp"
+#include "../user/core/HAL/PROFILE/profile.hpp"
 #include "can.h"
 #include <cstdint>
 #include <cstring> // 添加头文件
@@ -58,9 +60,11 @@ template <uint8_t N> class DjiMotorBase : public MotorBase<N>
      *
      * @param can_id can的初始id 比如3508与20066就是0x200
      * @param params 初始化转换国际单位的参数
+     * @param can_bus 电机所在的CAN总线
      */
-    DjiMotorBase(uint16_t Init_id, const uint8_t (&recv_idxs)[N], uint32_t send_idxs, Parameters params)
-        : init_address(Init_id), params_(params)
+    DjiMotorBase(uint16_t Init_id, const uint8_t (&recv_idxs)[N], uint32_t send_idxs, Parameters params,
+                 HAL::CAN::CanDeviceId can_bus)
+        : MotorBase<N>(100, can_bus), init_address(Init_id), composer_(get_command_composer(can_bus)), params_(params)
     {
         // 初始化 recv_idxs_ 和 send_idxs_
         for (uint8_t i = 0; i < N; ++i)
@@ -80,54 +84,78 @@ template <uint8_t N> class DjiMotorBase : public MotorBase<N>
      */
     void Parse(const HAL::CAN::Frame &frame) override
     {
-        const uint16_t received_id = frame.id;
-
         for (uint8_t i = 0; i < N; ++i)
         {
-            if (received_id == init_address + recv_idxs_[i])
+            HAL::CAN::ID_t id;
+            if (getRecvId(i, id) && frame.id == id)
             {
-                memcpy(&feedback_[i], frame.data, sizeof(DjiMotorfeedback));
-
-                feedback_[i].angle = __builtin_bswap16(feedback_[i].angle);
-                feedback_[i].velocity = __builtin_bswap16(feedback_[i].velocity);
-                feedback_[i].current = __builtin_bswap16(feedback_[i].current);
+                ParseSlot(frame, i);
+            }
+        }
+    }
 
-                Configure(i);
+    /**
+     * @brief 解析已确定槽位的CAN数据（由路由表直接调用）
+     *
+     * @param frame CAN帧
+     * @param i 存结构体的id号
+     */
+    void ParseSlot(const HAL::CAN::Frame &frame, uint8_t i) override
+    {
+        PROFILE_ZONE("dji_parse");
+        // 按引用直接从帧数据解码（大端），不再整帧拷贝后翻转字节序
+        const uint8_t *pData = frame.data;
+        feedback_[i].angle = (int16_t)((pData[0] << 8) | pData[1]);
+        feedback_[i].velocity = (int16_t)((pData[2] << 8) | pData[3]);
+        feedback_[i].current = (int16_t)((pData[4] << 8) | pData[5]);
+        feedback_[i].temperature = pData[6];
+
+        Configure(i);
+
+        this->updateFeedbackTime(i, frame);
+        this->updateTimestamp(i + 1);
+    }
 
-                this->updateTimestamp(i + 1);
-            }
+    /**
+     * @brief 获取槽位对应的反馈帧ID，DJI电调ID从1开始，0表示该槽位未使用
+     */
+    bool getRecvId(uint8_t i, HAL::CAN::ID_t &id) const override
+    {
+        if (i >= N || recv_idxs_[i] == 0)
+        {
+            return false;
         }
+        id = init_address + recv_idxs_[i];
+        return true;
     }
 
     /**
-     * @brief 设置发送数据
+     * @brief 设置发送数据，写入本路CAN的控制帧合成器
      *
      * @param data  数据发送的数据
-     * @param id    CAN id
+     * @param id    电调ID（1 ~ 8），5 ~ 8 自动使用下一组控制帧
+     * @return false 电调ID超出范围
      */
-    void setCAN(int16_t data, int id)
+    bool setCAN(int16_t data, int id)
     {
-        msd.data[(id - 1) * 2] = data >> 8;
-        msd.data[(id - 1) * 2 + 1] = data << 8 >> 8;
+        uint32_t group_id;
+        uint8_t slot;
+        if (!DjiCommandComposer::resolve(send_idxs_, id, group_id, slot))
+        {
+            return false;
+        }
+        return composer_.set(group_id, slot, data);
     }
 
     /**
-     * @brief               发送Can数据
+     * @brief 发送Can数据，即本路CAN合成器的flush()
      *
-     * @param han           Can句柄
-     * @param pTxMailbox    邮
+     * 发送合成器中本周期被写过的所有组，每个组ID每个节拍最多一帧。共用组ID的电机应在所有setCAN()之后
+     * 调用一次（或直接调用合成器的flush()）；逐个电机setCAN()后sendCAN()时，后写入的电机的数据晚一个节拍发出
      */
-    void sendCAN()
+    bool sendCAN()
     {
-        // 修改此处以适应新的CAN接口
-        HAL::CAN::Frame frame;
-        frame.id = send_idxs_;
-        frame.dlc = 8;
-        memcpy(frame.data, msd.data, 8);
-        frame.is_extended_id = false;
-        frame.is_remote_frame = false;
-        
-        HAL::CAN::get_can_bus_instance().get_can1().send(frame);
+        return composer_.flush();
     }
 
   protected:
@@ -200,7 +228,7 @@ template <uint8_t N> class DjiMotorBase : public MotorBase<N>
     DjiMotorfeedback feedback_[N]; // 反馈数据
     uint8_t recv_idxs_[N];         // ID索引
     uint32_t send_idxs_;
-    HAL::CAN::Frame msd;
+    DjiCommandComposer &composer_; // 本路CAN的控制帧合成器
 
 
 
@@ -217,10 +245,11 @@ template <uint8_t N> class DjiMotorBase : public MotorBase<N>
 template <uint8_t N> class GM2006 : public DjiMotorBase<N>
 {
   public:
-    GM2006(uint16_t Init_id, const uint8_t (&recv_idxs)[N], uint32_t send_idxs)
+    GM2006(uint16_t Init_id, const uint8_t (&recv_idxs)[N], uint32_t send_idxs,
+           HAL::CAN::CanDeviceId can_bus = HAL::CAN::CanDeviceId::HAL_Can1)
         : DjiMotorBase<N>(Init_id, recv_idxs, send_idxs,
                           // 直接构造参数对象
-                          Parameters(36.0, 0.18 / 36.0, 16384, 10, 8192))
+                          Parameters(36.0, 0.18 / 36.0, 16384, 10, 8192), can_bus)
     {
     }
 };
@@ -246,11 +275,13 @@ template <uint8_t N> class GM3508 : public DjiMotorBase<N>
      *
      * @param Init_id 初始ID
      * @param recv_idxs_ 电机ID列表
+     * @param can_bus 电机所在的CAN总线，默认CAN1
      */
-    GM3508(uint16_t Init_id, const uint8_t (&recv_idxs)[N], uint32_t send_idxs)
+    GM3508(uint16_t Init_id, const uint8_t (&recv_idxs)[N], uint32_t send_idxs,
+           HAL::CAN::CanDeviceId can_bus = HAL::CAN::CanDeviceId::HAL_Can1)
         : DjiMotorBase<N>(Init_id, recv_idxs, send_idxs,
                           // 直接构造参数对象
-                          Parameters(1.0, 0.3 / 1.0, 16384, 20, 8192))
+                          Parameters(1.0, 0.3 / 1.0, 16384, 20, 8192), can_bus)
     {
     }
 };
@@ -276,11 +307,13 @@ template <uint8_t N> class GM6020 : public DjiMotorBase<N>
      *
      * @param Init_id 初始ID
      * @param recv_idxs_ 电机ID列表
+     * @param can_bus 电机所在的CAN总线，默认CAN1
      */
-    GM6020(uint16_t Init_id, const uint8_t (&recv_idxs)[N], uint32_t send_idxs)
+    GM6020(uint16_t Init_id, const uint8_t (&recv_idxs)[N], uint32_t send_idxs,
+           HAL::CAN::CanDeviceId can_bus = HAL::CAN::CanDeviceId::HAL_Can1)
         : DjiMotorBase<N>(Init_id, recv_idxs, send_idxs,
                           // 直接构造参数对象
-                          Parameters(1.0, 0.7 * 1.0, 16384, 3, 8192))
+                          Parameters(1.0, 0.7 * 1.0, 16384, 3, 8192), can_bus)
     {
     }
 };
@@ -288,7 +321,7 @@ template <uint8_t N> class GM6020 : public DjiMotorBase<N>
 /**
  * @brief 电机实例
  * 模板内的参数为电机的总数量，这里为假设有两个电机
- * 构造函数的第一个参数为初始ID，第二个参数为电机ID列表,第三个参数是发送的ID
+ * 构造函数的第一个参数为初始ID，第二个参数为电机ID列表,第三个参数是发送的ID，第四个参数为所在CAN总线（默认CAN1）
  *
  */
 
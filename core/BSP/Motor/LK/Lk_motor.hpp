@@ -5,6 +5,7 @@
 
 #include "../user/core/BSP/Motor/MotorBase.hpp"
 #include "../user/core/HAL/CAN/can_hal.hpp"
+#include "../user/core/HAL/PROFILE/profile.hpp"
 
 namespace BSP::Motor::LK
 {
@@ -68,9 +69,12 @@ namespace BSP::Motor::LK
 
        /**
         * @brief 构造函数
+        *
+        * @param can_bus 电机所在的CAN总线
         */
-        LkMotorBase(uint16_t Init_id, const uint8_t (&recv_ids)[N], const uint32_t (&send_ids)[N], Parameters params)
-            : init_address(Init_id), params_(params)
+        LkMotorBase(uint16_t Init_id, const uint8_t (&recv_ids)[N], const uint32_t (&send_ids)[N], Parameters params,
+                    HAL::CAN::CanDeviceId can_bus)
+            : MotorBase<N>(100, can_bus), init_address(Init_id), params_(params)
         {
             for (uint8_t i = 0; i < N; ++i)
             {
@@ -125,8 +129,6 @@ namespace BSP::Motor::LK
             this->unit_data_[i].last_angle = this->unit_data_[i].angle_Deg;
         }
 
-        HAL::CAN::Frame msd;
-
     public:
         /**
             * @brief 解析CAN数据
@@ -135,119 +137,105 @@ namespace BSP::Motor::LK
         {
             for (uint8_t i = 0; i < N; ++i)
             {
-                if (frame.id == init_address + recv_idxs_[i])
+                HAL::CAN::ID_t id;
+                if (getRecvId(i, id) && frame.id == id)
                 {
-                    const uint8_t* pData = frame.data;
-                        
-                    feedback_[i].cmd = pData[0];
-                    feedback_[i].temperature = pData[1];
-                    feedback_[i].current = (int16_t)((pData[3] << 8) | pData[2]);
-                    feedback_[i].velocity = (int16_t)((pData[5] << 8) | pData[4]);
-                    feedback_[i].angle = (uint16_t)((pData[7] << 8) | pData[6]);
-
-                    Configure(i);
-                    this->updateTimestamp(i + 1);
+                    ParseSlot(frame, i);
                 }
             }
         }
 
         /**
-         * @brief               发送Can数据
-         *
-         * @param han           Can句柄
-         * @param pTxMailbox    邮
+         * @brief 解析已确定槽位的CAN数据（由路由表直接调用）
          */
-        void sendCAN(uint8_t id)
+        void ParseSlot(const HAL::CAN::Frame &frame, uint8_t i) override
         {
-            // 修改此处以适应新的CAN接口
-            HAL::CAN::Frame frame;
-            frame.id = 140 + send_idxs_[id - 1];
-            frame.dlc = 8;
-            memcpy(frame.data, msd.data, 8);
-            frame.is_extended_id = false;
-            frame.is_remote_frame = false;
-            
-            HAL::CAN::get_can_bus_instance().get_can1().send(frame);
+            PROFILE_ZONE("lk_parse");
+            const uint8_t* pData = frame.data;
+
+            feedback_[i].cmd = pData[0];
+            feedback_[i].temperature = pData[1];
+            feedback_[i].current = (int16_t)((pData[3] << 8) | pData[2]);
+            feedback_[i].velocity = (int16_t)((pData[5] << 8) | pData[4]);
+            feedback_[i].angle = (uint16_t)((pData[7] << 8) | pData[6]);
+
+            Configure(i);
+            this->updateFeedbackTime(i, frame);
+            this->updateTimestamp(i + 1);
+        }
+
+        /**
+         * @brief 获取槽位对应的反馈帧ID
+         */
+        bool getRecvId(uint8_t i, HAL::CAN::ID_t &id) const override
+        {
+            if (i >= N)
+            {
+                return false;
+            }
+            id = init_address + recv_idxs_[i];
+            return true;
         }
 
        /**
         * @brief LK电机的位置控制方法
         */
-        void ctrl_Position(uint8_t id, int32_t angle, uint16_t speed)
+        bool ctrl_Position(uint8_t id, int32_t angle, uint16_t speed)
         {
-            uint8_t data[8];
             uint32_t encoder_value = angle * 100; // 根据实际转换关系调整
-            
-            data[0] = 0xA4;
-            data[1] = 0x00;
-            data[2] = speed & 0xFF;
-            data[3] = (speed >> 8) & 0xFF;
-            data[4] = encoder_value & 0xFF;
-            data[5] = (encoder_value >> 8) & 0xFF;
-            data[6] = (encoder_value >> 16) & 0xFF;
-            data[7] = (encoder_value >> 24) & 0xFF;
-
-            sendCAN(id);
+
+            auto frame = makeCommand(id, 0xA4);
+            frame.put_u16_le(2, speed);
+            frame.put_u32_le(4, encoder_value);
+
+            return this->getCanDevice().send(frame);
         }
 
        /**
         * @brief LK电机的扭矩控制方法
         */
-        void ctrl_Torque(uint8_t id, uint8_t motor_index, int16_t torque)
+        bool ctrl_Torque(uint8_t id, uint8_t motor_index, int16_t torque)
         {
-            if (motor_index < 1 || motor_index > N) return;
+            if (motor_index < 1 || motor_index > N) return false;
 
             // 扭矩限制
             if (torque > 2048) torque = 2048;
             if (torque < -2048) torque = -2048;
-                
-            uint8_t data[8];
-            data[0] = 0xA1;
-            data[1] = 0x00;
-            data[2] = 0x00;
-            data[3] = 0x00;
-            data[4] = torque & 0xFF;
-            data[5] = (torque >> 8) & 0xFF;
-            data[6] = 0x00;
-            data[7] = 0x00;
-
-            sendCAN(id);
+
+            auto frame = makeCommand(id, 0xA1);
+            frame.put_u16_le(4, static_cast<uint16_t>(torque));
+
+            return this->getCanDevice().send(frame);
         }
 
        /**
         * @brief 使能LK电机
         */
-        void On(uint8_t id, uint8_t motor_index)
+        bool On(uint8_t id, uint8_t motor_index)
         {
-            if (motor_index < 1 || motor_index > N) return;
+            if (motor_index < 1 || motor_index > N) return false;
 
-            uint8_t data[8] = {0x88};
-                
-            sendCAN(id);
+            return this->getCanDevice().send(makeCommand(id, 0x88));
         }
 
        /**
         * @brief 失能LK电机
         */
-        void Off(uint8_t id, uint8_t motor_index)
+        bool Off(uint8_t id, uint8_t motor_index)
         {
-            if (motor_index < 1 || motor_index > N) return;
+            if (motor_index < 1 || motor_index > N) return false;
 
-            uint8_t data[8] = {0x81};
-            
-            sendCAN(id);
+            return this->getCanDevice().send(makeCommand(id, 0x81));
         }
 
        /**
         * @brief 清除LK电机错误
         */
-        void ClearErr(uint8_t id, uint8_t motor_index)
+        bool ClearErr(uint8_t id, uint8_t motor_index)
         {
-            if (motor_index < 1 || motor_index > N) return;
+            if (motor_index < 1 || motor_index > N) return false;
 
-            uint8_t data[8] = {0x9B};
-            
-            sendCAN(id);
+            return this->getCanDevice().send(makeCommand(id, 0x9B));
         }
 
        /**
@@ -278,6 +266,16 @@ namespace BSP::Motor::LK
        }
 
    protected:
+       /**
+        * @brief 构造指令帧：ID为0x140 + 电机ID，第一字节为指令，其余清零
+        */
+       HAL::CAN::Frame makeCommand(uint8_t id, uint8_t cmd) const
+       {
+           auto frame = HAL::CAN::Frame::make(0x140 + send_idxs_[id - 1]);
+           frame.data[0] = cmd;
+           return frame;
+       }
+
        const uint16_t init_address;
        uint8_t recv_idxs_[N];
        uint32_t send_idxs_[N];
@@ -293,13 +291,15 @@ namespace BSP::Motor::LK
    class LK4005 : public LkMotorBase<N>
    {
    public:
-       LK4005(uint16_t Init_id, const uint8_t (&ids)[N], const uint32_t (&send_idxs)[N])
+       LK4005(uint16_t Init_id, const uint8_t (&ids)[N], const uint32_t (&send_idxs)[N],
+              HAL::CAN::CanDeviceId can_bus = HAL::CAN::CanDeviceId::HAL_Can1)
            : LkMotorBase<N>(Init_id, ids, send_idxs,
                            Parameters(10.0,     // 减速比
                                     0.06,      // 扭矩常数
                                     4096,      // 最大反馈电流
                                     2.7,       // 最大电流 
-                                    65536.0))  // 编码器分辨率
+                                    65536.0),  // 编码器分辨率
+                           can_bus)
        {
        }
    };
@@ -6,6 +6,7 @@
 #include "../user/core/BSP/Common/StateWatch/state_watch.hpp"
 #include "../user/core/BSP/Common/StateWatch/buzzer_manager.hpp"
 #include "../user/core/HAL/CAN/can_hal.hpp"
+#include "../user/core/HAL/DWT/DWT.hpp"
 
 namespace BSP::Motor
 {
@@ -26,19 +27,59 @@ namespace BSP::Motor
 
             double last_angle;  // 上一次位置
             double add_angle;   // 增量位置
+
+            uint32_t feedback_cycles; // 最近一次反馈帧的接收时刻（DWT周期数低28位，0也是有效值）
+            bool has_feedback;        // 是否收到过反馈帧
         };
 
         // 国际单位数据
-        UnitData unit_data_[N];
+        UnitData unit_data_[N] = {};
         // 设备在线检测
         BSP::WATCH_STATE::StateWatch state_watch_[N];
         // 数据
         virtual void Parse(const HAL::CAN::Frame &frame) = 0;
+
+        /**
+         * @brief 解析已确定槽位的CAN数据
+         *
+         * @param frame CAN帧
+         * @param slot 电机在本对象中的下标（0 ~ N-1）
+         */
+        virtual void ParseSlot(const HAL::CAN::Frame &frame, uint8_t slot) = 0;
+
+        /**
+         * @brief 获取槽位对应的反馈帧ID
+         *
+         * @param slot 电机在本对象中的下标（0 ~ N-1）
+         * @param id 输出的反馈帧ID
+         * @return false 该槽位未使用
+         */
+        virtual bool getRecvId(uint8_t slot, HAL::CAN::ID_t &id) const = 0;
+
         bool is_Enable = false;
 
+        // 电机所在的CAN总线
+        HAL::CAN::CanDeviceId can_bus_;
+
+        /**
+         * @brief 记录反馈帧的接收时刻，在ParseSlot()中调用
+         *
+         * @param slot 电机在本对象中的下标（0 ~ N-1）
+         * @param frame 反馈帧
+         */
+        void updateFeedbackTime(uint8_t slot, const HAL::CAN::Frame &frame)
+        {
+            this->unit_data_[slot].feedback_cycles = frame.timestamp;
+            this->unit_data_[slot].has_feedback = true;
+        }
+
     public:
-        MotorBase(uint32_t timeThreshold = 100)
-            : state_watch_{}  // 确保数组被默认初始化
+        /**
+         * @param timeThreshold 离线判定时间（ms）
+         * @param can_bus 电机所在的CAN总线，收发都使用该总线
+         */
+        MotorBase(uint32_t timeThreshold = 100, HAL::CAN::CanDeviceId can_bus = HAL::CAN::CanDeviceId::HAL_Can1)
+            : state_watch_{}, can_bus_(can_bus)  // 确保数组被默认初始化
         {
             for (int i = 0; i < N; i++) 
             {
@@ -47,6 +88,61 @@ namespace BSP::Motor
             }
         }
 
+        /**
+         * @brief 把每个电机的反馈ID注册到CAN路由表
+         *
+         * 注册后接收到的帧按ID直接分发到对应槽位，不需要再调用Parse()逐个比较；
+         * 反馈ID同时按高优先级登记到硬件过滤器（FIFO0）
+         *
+         * @param can_device 电机所在的CAN设备
+         * @return false 存在注册失败的ID（路由表已满或ID重复）
+         */
+        bool registerCallback(HAL::CAN::ICanDevice *can_device)
+        {
+            bool ok = true;
+            for (uint8_t i = 0; i < N; i++)
+            {
+                HAL::CAN::ID_t id;
+                if (getRecvId(i, id))
+                {
+                    ok = can_device->register_id_handler(id, false, &MotorBase::RouteFrame, this, i,
+                                                         HAL::CAN::RxPriority::High) &&
+                         ok;
+                }
+            }
+            return ok;
+        }
+
+        /**
+         * @brief 把每个电机的反馈ID注册到电机所在CAN总线的路由表
+         *
+         * @return false 存在注册失败的ID（路由表已满或ID重复）
+         */
+        bool registerCallback()
+        {
+            return registerCallback(&getCanDevice());
+        }
+
+        /**
+         * @brief 获取电机所在的CAN总线
+         *
+         * @return HAL::CAN::CanDeviceId
+         */
+        HAL::CAN::CanDeviceId getCanBus() const
+        {
+            return can_bus_;
+        }
+
+        /**
+         * @brief 获取电机所在的CAN设备
+         *
+         * @return HAL::CAN::ICanDevice&
+         */
+        HAL::CAN::ICanDevice &getCanDevice() const
+        {
+            return HAL::CAN::get_can_bus_instance().get_device(can_bus_);
+        }
+
         /**
          * @brief 
          * 
@@ -193,6 +289,36 @@ namespace BSP::Motor
             return this->unit_data_[id - 1].temperature_C;
         }
 
+        /**
+         * @brief 获取最近一次反馈帧的接收时刻（DWT周期数低28位，见Frame::TIMESTAMP_MASK）
+         *
+         * @param id CAN id
+         * @return uint32_t
+         */
+        uint32_t getFeedbackCycles(uint8_t id)
+        {
+            return this->unit_data_[id - 1].feedback_cycles;
+        }
+
+        /**
+         * @brief 获取反馈数据的时效    单位：(us)
+         * 从接收中断读出反馈帧到现在经过的时间，用于测量或补偿传感器到控制的延迟
+         * 时间戳只有28位，168 MHz下超过约1.6秒的时效不准确（此时电机早已判定离线）
+         * @param id CAN id
+         * @return uint32_t 尚未收到反馈时返回UINT32_MAX
+         */
+        uint32_t getFeedbackAge_us(uint8_t id)
+        {
+            if (!this->unit_data_[id - 1].has_feedback)
+            {
+                return UINT32_MAX;
+            }
+            const uint32_t cycles = this->unit_data_[id - 1].feedback_cycles;
+            auto &dwt = HAL::DWTimer::getInstance();
+            const uint32_t elapsed = (HAL::DWTimer::GetCycles() - cycles) & HAL::CAN::Frame::TIMESTAMP_MASK;
+            return elapsed / dwt.GetCyclesPerUs();
+        }
+
         /**
          * @brief 获取掉线的电机编号
          *
@@ -231,6 +357,13 @@ namespace BSP::Motor
             this->is_Enable = is_Enable;
         }
 
+    private:
+        // 路由表回调入口
+        static void RouteFrame(void *ctx, const HAL::CAN::Frame &frame, uint8_t slot)
+        {
+            static_cast<MotorBase *>(ctx)->ParseSlot(frame, slot);
+        }
+
     };
 } // namespace BSP::Motor
 
@@ -0,0 +1,145 @@
+#ifndef MOTOR_BUS_PLANNER_HPP
+#define MOTOR_BUS_PLANNER_HPP
+
+#pragma once
+
+#include "../user/core/HAL/CAN/can_hal.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace BSP::Motor
+{
+    /**
+     * @brief 一组电机在总线上产生的流量
+     *
+     * 控制帧与反馈帧均按frame_bits_worst_case()（最坏位填充）估算
+     */
+    struct MotorBusLoad
+    {
+        HAL::CAN::CanDeviceId bus;  // 所在CAN总线
+        uint8_t count;              // 电机数量
+        uint16_t control_hz;        // 控制帧发送频率（Hz）
+        uint8_t motors_per_command; // 一帧控制帧可控制的电机数量
+        uint16_t feedback_hz;       // 每个电机的反馈频率（Hz）
+    };
+
+    /**
+     * @brief DJI电机（3508/2006/6020）：一帧控制帧控制4个电调，电调固定1 kHz反馈
+     *
+     * 电调ID跨越两组（1~4与5~8）时实际控制帧会多一帧，这里按最少帧数估算
+     */
+    constexpr MotorBusLoad DjiLoad(HAL::CAN::CanDeviceId bus, uint8_t count, uint16_t control_hz = 1000)
+    {
+        return MotorBusLoad{bus, count, control_hz, 4, 1000};
+    }
+
+    /**
+     * @brief 达妙电机：每个电机单独一帧控制帧，每收到一帧控制帧回复一帧反馈
+     */
+    constexpr MotorBusLoad DmLoad(HAL::CAN::CanDeviceId bus, uint8_t count, uint16_t control_hz = 1000)
+    {
+        return MotorBusLoad{bus, count, control_hz, 1, control_hz};
+    }
+
+    /**
+     * @brief 瓴控电机：每个电机单独一帧控制帧，每收到一帧控制帧回复一帧反馈
+     */
+    constexpr MotorBusLoad LkLoad(HAL::CAN::CanDeviceId bus, uint8_t count, uint16_t control_hz = 1000)
+    {
+        return MotorBusLoad{bus, count, control_hz, 1, control_hz};
+    }
+
+    /**
+     * @brief 计算一组电机每秒占用的总线位数
+     */
+    constexpr uint32_t BusBitsPerSecond(const MotorBusLoad &load)
+    {
+        // 控制帧与反馈帧都是8字节标准帧
+        constexpr uint32_t frame_bits = HAL::CAN::frame_bits_worst_case(8, false, false);
+
+        const uint32_t command_frames = (load.count + load.motors_per_command - 1) / load.motors_per_command;
+        return frame_bits * (command_frames * load.control_hz + (uint32_t)load.count * load.feedback_hz);
+    }
+
+    /**
+     * @brief 预测指定总线的占用率
+     *
+     * 可以在编译期检查电机分配是否合理：
+     * @code
+     * constexpr BSP::Motor::MotorBusLoad kMotors[] = {
+     *     BSP::Motor::DjiLoad(HAL::CAN::CanDeviceId::HAL_Can1, 3),
+     *     BSP::Motor::DjiLoad(HAL::CAN::CanDeviceId::HAL_Can2, 2),
+     *     BSP::Motor::DmLoad(HAL::CAN::CanDeviceId::HAL_Can2, 1),
+     * };
+     * static_assert(BSP::Motor::PredictUtilization(kMotors, HAL::CAN::CanDeviceId::HAL_Can1) < 600, "CAN1负载过高");
+     * @endcode
+     *
+     * @param loads 机器人上的所有电机组
+     * @param bus 要计算的总线
+     * @param bitrate 总线波特率
+     * @return uint32_t 占用率（‰）
+     */
+    template <size_t K>
+    constexpr uint32_t PredictUtilization(const MotorBusLoad (&loads)[K], HAL::CAN::CanDeviceId bus,
+                                          uint32_t bitrate = 1000000)
+    {
+        uint64_t bits = 0;
+        for (size_t i = 0; i < K; ++i)
+        {
+            if (loads[i].bus == bus)
+            {
+                bits += BusBitsPerSecond(loads[i]);
+            }
+        }
+        return (uint32_t)(bits * 1000 / bitrate);
+    }
+
+    /**
+     * @brief 找出预测占用率最高的总线的占用率
+     *
+     * @return uint32_t 占用率（‰）
+     */
+    template <size_t K>
+    constexpr uint32_t PredictPeakUtilization(const MotorBusLoad (&loads)[K], uint32_t bitrate = 1000000)
+    {
+        uint32_t peak = 0;
+        for (size_t b = 0; b < (size_t)HAL::CAN::CanDeviceId::MAX_DEVICES; ++b)
+        {
+            const uint32_t utilization = PredictUtilization(loads, (HAL::CAN::CanDeviceId)b, bitrate);
+            peak = utilization > peak ? utilization : peak;
+        }
+        return peak;
+    }
+
+    // 每条总线的预测占用率
+    struct BusPlan
+    {
+        uint32_t utilization_permille[(size_t)HAL::CAN::CanDeviceId::MAX_DEVICES]; // 占用率（‰），下标为CanDeviceId
+    };
+
+    /**
+     * @brief 预测所有总线的占用率，可与HAL::CAN::log_bus_stats()的实测值对比
+     */
+    template <size_t K> constexpr BusPlan PlanBuses(const MotorBusLoad (&loads)[K], uint32_t bitrate = 1000000)
+    {
+        BusPlan plan = {};
+        for (size_t b = 0; b < (size_t)HAL::CAN::CanDeviceId::MAX_DEVICES; ++b)
+        {
+            plan.utilization_permille[b] = PredictUtilization(loads, (HAL::CAN::CanDeviceId)b, bitrate);
+        }
+        return plan;
+    }
+
+    // 按最坏位填充估算，1 kHz下一路CAN上4个DJI电机就达到67.5%，云台和底盘电机需要分到两路CAN
+    namespace detail
+    {
+        constexpr MotorBusLoad kCheckLoads[] = {
+            DjiLoad(HAL::CAN::CanDeviceId::HAL_Can1, 4),
+            DjiLoad(HAL::CAN::CanDeviceId::HAL_Can2, 3),
+        };
+        static_assert(PredictUtilization(kCheckLoads, HAL::CAN::CanDeviceId::HAL_Can1) == 675,
+                      "4个DJI电机：4帧反馈 + 1帧控制，每帧135位");
+    } // namespace detail
+} // namespace BSP::Motor
+
+#endif
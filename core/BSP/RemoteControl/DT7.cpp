@@ -1,4 +1,5 @@
 #include "DT7.hpp"
+#include "../user/core/HAL/PROFILE/profile.hpp"
 #include <cstdlib>
 
 namespace BSP::REMOTE_CONTROL
@@ -36,9 +37,16 @@ static inline float discreteAxis(int16_t value, int16_t tolerance)
 // 解析原始 18 字节数据（提取通道/开关/鼠标/键盘并更新坐标与时间戳）
 void RemoteController::parseData(const uint8_t *data)
 {
+    PROFILE_ZONE("dt7_parse");
     if (data == nullptr)
         return;
 
+    if (!isValidFrame(data))
+    {
+        ++rejected_frames_;
+        return;
+    }
+
     // 更新时间戳
     updateTimestamp();
 
@@ -89,6 +97,21 @@ void RemoteController::parseData(const uint8_t *data)
 
 
 
+// 检查四个通道和两个开关的取值范围，DT7没有帧头和校验，错位的数据在这里丢弃
+bool RemoteController::isValidFrame(const uint8_t *data) const
+{
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        const uint16_t value = extractBits(data, i * 11, 11);
+        if (value < CHANNEL_VALUE_MIN || value > CHANNEL_VALUE_MAX)
+            return false;
+    }
+
+    const uint16_t s1 = extractBits(data, 44, 2);
+    const uint16_t s2 = extractBits(data, 46, 2);
+    return s1 != 0 && s2 != 0;
+}
+
 /**
  * @brief 按位提取数据（支持跨字节）
  * @param data 数据数组指针
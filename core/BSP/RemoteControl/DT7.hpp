@@ -104,7 +104,18 @@ namespace BSP::REMOTE_CONTROL
         // 核心函数：数据解析入口
         // ======================================================
 
-        void parseData(const uint8_t *data); // 解析接收到的原始数据
+        void parseData(const uint8_t *data); // 解析接收到的原始数据，通道或开关值不合法的帧被丢弃
+
+        /**
+         * @brief 检查18字节数据是否像一帧DT7数据
+         * @param data 原始数据
+         * @return 四个通道在364~1684之间且两个开关为1~3时返回true
+         * @note DT7没有帧头和校验，只能靠数值范围排除错位或残缺的数据
+         */
+        bool isValidFrame(const uint8_t *data) const;
+
+        // 因数值不合法被丢弃的帧数
+        inline uint32_t get_rejectedFrames() const { return rejected_frames_; }
 
         // ======================================================
         // 精简对外接口（仅保留这个外部接口）
@@ -196,6 +207,7 @@ namespace BSP::REMOTE_CONTROL
         uint16_t keyboard_;			   // 键盘数据
         StickPosition stick_position_; // 摇杆位置（-1.0~1.0）
         BSP::WATCH_STATE::StateWatch statewatch_;
+        uint32_t rejected_frames_ = 0;   // 被丢弃的帧数
 
     };
 
@@ -0,0 +1,30 @@
+/**
+ * @file board.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief 板级描述表入口，CanBus/UartBus按此表在编译期生成设备
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include "board_descriptor.hpp"
+
+// 机器人工程在CMake中定义HAL_BOARD_CONFIG="User/board_config.hpp"替换默认描述表，不需要修改core
+#ifdef HAL_BOARD_CONFIG
+#include HAL_BOARD_CONFIG
+#else
+#include "board_default.hpp"
+#endif
+
+namespace HAL::BOARD
+{
+
+static_assert(ids_unique(CAN_PORTS), "CAN_PORTS中有重复的CAN外设");
+static_assert(filter_banks_valid(CAN_PORTS), "CAN_PORTS的过滤器组越界或重叠");
+static_assert(ids_unique(UART_PORTS), "UART_PORTS中有重复的UART外设");
+static_assert(rx_buffers_valid(UART_PORTS), "UART_PORTS的接收缓冲区长度与接收方式不符");
+
+} // namespace HAL::BOARD
@@ -0,0 +1,31 @@
+/**
+ * @file board_default.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief 默认板级描述：DJI C板
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include "board_descriptor.hpp"
+
+namespace HAL::BOARD
+{
+
+// CAN1使用过滤器组0~13、FIFO0，CAN2使用过滤器组14~27、FIFO1
+inline constexpr CanPort CAN_PORTS[] = {
+    {CAN::CanDeviceId::HAL_Can1, &hcan1, 0, 14, CAN_FILTER_FIFO0},
+    {CAN::CanDeviceId::HAL_Can2, &hcan2, 14, 14, CAN_FILTER_FIFO1},
+};
+
+// 串口接收由各模块自行启动
+inline constexpr UartPort UART_PORTS[] = {
+    {UART::UartDeviceId::HAL_Uart1, &huart1, UartRxMode::Manual, 0},
+    {UART::UartDeviceId::HAL_Uart3, &huart3, UartRxMode::Manual, 0},
+    {UART::UartDeviceId::HAL_Uart6, &huart6, UartRxMode::Manual, 0},
+};
+
+} // namespace HAL::BOARD
@@ -0,0 +1,140 @@
+/**
+ * @file board_descriptor.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief 板级外设描述类型与编译期检查
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include "../CAN/interface/can_bus.hpp"
+#include "../UART/interface/uart_bus.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace HAL::BOARD
+{
+
+// bxCAN共28个过滤器组，CAN2从第14组开始（CanDevice配置SlaveStartFilterBank = 14）
+constexpr uint8_t CAN_FILTER_BANKS = 28;
+constexpr uint8_t CAN_SLAVE_START_FILTER_BANK = 14;
+
+// CAN外设描述
+struct CanPort
+{
+    CAN::CanDeviceId id;
+    CAN_HandleTypeDef *handle;
+    uint8_t filter_bank;       // 起始过滤器组
+    uint8_t filter_bank_count; // 可用的过滤器组数量
+    uint32_t fifo;             // 接收FIFO（CAN_FILTER_FIFO0/CAN_FILTER_FIFO1）
+};
+
+// UART接收方式
+enum class UartRxMode : uint8_t
+{
+    Manual, // 由用户调用receive_dma_idle()等接口启动接收
+    Ring,   // 总线初始化时启动循环DMA接收（start_rx_ring()），缓冲区由总线持有
+};
+
+// UART外设描述
+struct UartPort
+{
+    UART::UartDeviceId id;
+    UART_HandleTypeDef *handle;
+    UartRxMode rx_mode;
+    uint16_t rx_buffer_size; // Ring模式的接收缓冲区长度，Manual模式填0
+};
+
+// 返回id在描述表中的下标，不存在时返回N
+template <typename Port, size_t N, typename Id>
+constexpr size_t index_of(const Port (&ports)[N], Id id)
+{
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (ports[i].id == id)
+        {
+            return i;
+        }
+    }
+    return N;
+}
+
+// 同一外设不能出现两次
+template <typename Port, size_t N>
+constexpr bool ids_unique(const Port (&ports)[N])
+{
+    for (size_t i = 0; i < N; ++i)
+    {
+        for (size_t j = i + 1; j < N; ++j)
+        {
+            if (ports[i].id == ports[j].id || ports[i].handle == ports[j].handle)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 过滤器组不重叠，CAN1只用主过滤器组，CAN2只用从过滤器组
+template <size_t N>
+constexpr bool filter_banks_valid(const CanPort (&ports)[N])
+{
+    for (size_t i = 0; i < N; ++i)
+    {
+        const uint32_t begin = ports[i].filter_bank;
+        const uint32_t end = begin + ports[i].filter_bank_count;
+        if (ports[i].filter_bank_count == 0 || end > CAN_FILTER_BANKS)
+        {
+            return false;
+        }
+        if (ports[i].id == CAN::CanDeviceId::HAL_Can1 && end > CAN_SLAVE_START_FILTER_BANK)
+        {
+            return false;
+        }
+        if (ports[i].id == CAN::CanDeviceId::HAL_Can2 && begin < CAN_SLAVE_START_FILTER_BANK)
+        {
+            return false;
+        }
+        for (size_t j = i + 1; j < N; ++j)
+        {
+            if (begin < ports[j].filter_bank + ports[j].filter_bank_count && ports[j].filter_bank < end)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Ring模式至少2字节缓冲区，Manual模式不分配
+template <size_t N>
+constexpr bool rx_buffers_valid(const UartPort (&ports)[N])
+{
+    for (size_t i = 0; i < N; ++i)
+    {
+        const bool ring = ports[i].rx_mode == UartRxMode::Ring;
+        if (ring ? ports[i].rx_buffer_size < 2 : ports[i].rx_buffer_size != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 前count个UART的接收缓冲区总长度（即第count个缓冲区的偏移）
+template <size_t N>
+constexpr size_t rx_buffer_offset(const UartPort (&ports)[N], size_t count)
+{
+    size_t offset = 0;
+    for (size_t i = 0; i < count && i < N; ++i)
+    {
+        offset += ports[i].rx_buffer_size;
+    }
+    return offset;
+}
+
+} // namespace HAL::BOARD
@@ -1,70 +1,86 @@
+// 硬件实现，PC端（HAL_CAN_VIRTUAL）使用virtual/virtual_can.cpp
+#ifndef HAL_CAN_VIRTUAL
+
 #include "can_bus_impl.hpp"
 
-namespace HAL::CAN
+// 发送邮箱中止中断：从发送队列补发
+static void can_tx_mailbox_free(CAN_HandleTypeDef *hcan)
 {
+    HAL::CAN::CanDevice *device = HAL::CAN::BoardCanBus::instance().find_device(hcan);
+    if (device != nullptr)
+    {
+        device->on_tx_mailbox_free();
+    }
+}
 
-// CanBus实现
-CanBus &CanBus::instance()
+// 发送邮箱完成中断：累加发送位数后补发
+static void can_tx_mailbox_complete(CAN_HandleTypeDef *hcan, uint8_t mailbox)
 {
-    static CanBus instance;
-    // 懒汉模式：在第一次获取实例时初始化
-    if (!instance.initialized_)
+    HAL::CAN::CanDevice *device = HAL::CAN::BoardCanBus::instance().find_device(hcan);
+    if (device != nullptr)
     {
-        instance.init();
-        instance.initialized_ = true;
+        device->on_tx_complete(mailbox);
     }
-    return instance;
 }
 
-CanBus::CanBus()
-    // 初始化CAN1
-    : can1_(&hcan1, 0, CAN_FILTER_FIFO0),
-      // 初始化CAN2
-      can2_(&hcan2, 14, CAN_FILTER_FIFO1)
+// 接收FIFO满中断：计数并立即取空，避免下一帧溢出
+static void can_rx_fifo_full(CAN_HandleTypeDef *hcan, uint32_t fifo)
 {
-    // 注册现有的设备
-    register_device(CanDeviceId::HAL_Can1, &can1_);
-    register_device(CanDeviceId::HAL_Can2, &can2_);
+    HAL::CAN::CanDevice *device = HAL::CAN::BoardCanBus::instance().find_device(hcan);
+    if (device != nullptr)
+    {
+        device->on_rx_fifo_full(fifo);
+    }
+}
 
-    // 这里可以轻松注册更多设备，比如CAN3
-    // 例如: register_device(CanDeviceId::HAL_Can3, &can3_);
+extern "C" void HAL_CAN_RxFifo0FullCallback(CAN_HandleTypeDef *hcan)
+{
+    can_rx_fifo_full(hcan, CAN_RX_FIFO0);
 }
 
-void CanBus::init()
+extern "C" void HAL_CAN_RxFifo1FullCallback(CAN_HandleTypeDef *hcan)
 {
-    // 初始化所有已注册的设备
-    for (size_t i = 0; i < (size_t)CanDeviceId::MAX_DEVICES; ++i)
-    {
-        if (devices_[i] != nullptr)
-        {
-            devices_[i]->init();
-            devices_[i]->start();
-        }
-    }
+    can_rx_fifo_full(hcan, CAN_RX_FIFO1);
 }
 
-void CanBus::register_device(CanDeviceId id, CanDevice *device)
+// 错误中断：统计离线、FIFO溢出等错误事件
+extern "C" void HAL_CAN_ErrorCallback(CAN_HandleTypeDef *hcan)
 {
-    if (id < CanDeviceId::MAX_DEVICES && device != nullptr)
+    HAL::CAN::CanDevice *device = HAL::CAN::BoardCanBus::instance().find_device(hcan);
+    if (device != nullptr)
     {
-        devices_[(size_t)id] = device;
+        device->on_error();
     }
 }
 
-ICanDevice &CanBus::get_device(CanDeviceId id)
+extern "C" void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef *hcan)
 {
-    if (id < CanDeviceId::MAX_DEVICES && devices_[(size_t)id] != nullptr)
-    {
-        return *devices_[(size_t)id];
-    }
+    can_tx_mailbox_complete(hcan, 0);
+}
+
+extern "C" void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef *hcan)
+{
+    can_tx_mailbox_complete(hcan, 1);
+}
 
-    // 如果没有可用设备，返回can1_（保证永远有返回值）
-    return can1_;
+extern "C" void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef *hcan)
+{
+    can_tx_mailbox_complete(hcan, 2);
+}
+
+extern "C" void HAL_CAN_TxMailbox0AbortCallback(CAN_HandleTypeDef *hcan)
+{
+    can_tx_mailbox_free(hcan);
+}
+
+extern "C" void HAL_CAN_TxMailbox1AbortCallback(CAN_HandleTypeDef *hcan)
+{
+    can_tx_mailbox_free(hcan);
 }
 
-bool CanBus::has_device(CanDeviceId id) const
+extern "C" void HAL_CAN_TxMailbox2AbortCallback(CAN_HandleTypeDef *hcan)
 {
-    return id < CanDeviceId::MAX_DEVICES && devices_[(size_t)id] != nullptr;
+    can_tx_mailbox_free(hcan);
 }
 
-} // namespace HAL::CAN
\ No newline at end of file
+#endif // HAL_CAN_VIRTUAL
@@ -10,50 +10,131 @@
  */
 
 #pragma once
+#include "../../ASSERT/asster.hpp"
+#include "../../BOARD/board.hpp"
+#include "../../DWT/DWT.hpp"
 #include "../interface/can_bus.hpp"
 #include "can_device_impl.hpp"
-#include <unordered_map>
+#include <iterator>
+#include <utility>
 
 namespace HAL::CAN
 {
 
-// CAN总线管理实现类
-class CanBus : public ICanBus
+/**
+ * @brief CAN总线管理实现类
+ *
+ * Ports为板级描述表（BOARD::CanPort数组），每一项生成一个CanDevice，
+ * 描述表之外的外设用get_device<Id>()访问时编译失败
+ */
+template <const auto &Ports> class CanBus final : public ICanBus
 {
+    static constexpr size_t COUNT = std::size(Ports);
+
   public:
     // 获取单例实例
-    static CanBus &instance();
+    static CanBus &instance()
+    {
+        static CanBus instance;
+        // 懒汉模式：在第一次获取实例时初始化
+        if (!instance.initialized_)
+        {
+            instance.init();
+            instance.initialized_ = true;
+        }
+        return instance;
+    }
 
     // 析构函数
     ~CanBus() override = default;
 
-    // 实现ICanBus接口
-    ICanDevice &get_device(CanDeviceId id) override;
-    bool has_device(CanDeviceId id) const override;
+    // 编译期按ID取设备，不经过虚函数
+    template <CanDeviceId Id> CanDevice &device()
+    {
+        constexpr size_t index = BOARD::index_of(Ports, Id);
+        static_assert(index < COUNT, "板级描述表中没有该CAN外设");
+        return devices_[index];
+    }
+
+    // 实现ICanBus接口；ID不在描述表中时断言失败
+    ICanDevice &get_device(CanDeviceId id) override
+    {
+        const size_t index = BOARD::index_of(Ports, id);
+        assert_always(index < COUNT);
+        return devices_[index];
+    }
+
+    bool has_device(CanDeviceId id) const override
+    {
+        return BOARD::index_of(Ports, id) < COUNT;
+    }
 
-    // 初始化CAN总线（私有，由instance()调用）
-    void init();
+    // 按HAL句柄查找设备，中断回调中使用
+    CanDevice *find_device(const CAN_HandleTypeDef *handle) override
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            if (Ports[i].handle == handle)
+            {
+                return &devices_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    // 禁止拷贝构造和赋值操作
+    CanBus(const CanBus &) = delete;
+    CanBus &operator=(const CanBus &) = delete;
 
   private:
     // 私有构造函数（单例模式）
-    CanBus();
+    CanBus() : CanBus(std::make_index_sequence<COUNT>())
+    {
+    }
+
+    template <size_t... I>
+    explicit CanBus(std::index_sequence<I...>)
+        : devices_{CanDevice(Ports[I].handle, Ports[I].filter_bank, Ports[I].fifo, Ports[I].filter_bank_count)...}
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            devices_[i].set_trace_bus((uint8_t)Ports[i].id);
+        }
+    }
 
-    // 注册一个CAN设备
-    void register_device(CanDeviceId id, CanDevice *device);
+    // 初始化所有设备（由instance()调用）
+    void init()
+    {
+        // 接收时间戳来自DWT周期计数，先于CAN中断打开
+        HAL::DWTimer::getInstance();
+
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            devices_[i].init();
+            devices_[i].start();
+        }
+    }
 
     // 是否已初始化标志
     bool initialized_ = false;
 
-    // 禁止拷贝构造和赋值操作
-    CanBus(const CanBus &) = delete;
-    CanBus &operator=(const CanBus &) = delete;
+    // 设备实例，顺序与描述表相同
+    CanDevice devices_[COUNT];
+};
 
-    // 使用指针数组代替固定成员变量
-    CanDevice *devices_[(size_t)CanDeviceId::MAX_DEVICES] = {nullptr};
+// 按板级描述表生成的CAN总线
+using BoardCanBus = CanBus<BOARD::CAN_PORTS>;
 
-    // 实际设备实例
-    CanDevice can1_;
-    CanDevice can2_;
-};
+/**
+ * @brief 编译期取CAN设备，描述表中没有该外设时编译失败
+ *
+ * @code
+ * auto &can2 = HAL::CAN::get_device<HAL::CAN::CanDeviceId::HAL_Can2>();
+ * @endcode
+ */
+template <CanDeviceId Id> CanDevice &get_device()
+{
+    return BoardCanBus::instance().device<Id>();
+}
 
-} // namespace HAL::CAN
\ No newline at end of file
+} // namespace HAL::CAN
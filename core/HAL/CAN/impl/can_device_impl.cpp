@@ -1,11 +1,17 @@
 #include "can_device_impl.hpp"
+#include "../../DWT/DWT.hpp"
+#include "../../IRQ/irq_lock.hpp"
+#include "../trace/can_trace_recorder.hpp"
+
+// 硬件实现，PC端（HAL_CAN_VIRTUAL）使用virtual/virtual_can.cpp
+#ifndef HAL_CAN_VIRTUAL
 
 namespace HAL::CAN
 {
 
 // CanDevice实现
-CanDevice::CanDevice(CAN_HandleTypeDef *handle, uint32_t filter_bank, uint32_t fifo)
-    : handle_(handle), filter_bank_(filter_bank), fifo_(fifo), mailbox_(0)
+CanDevice::CanDevice(CAN_HandleTypeDef *handle, uint32_t filter_bank, uint32_t fifo, uint32_t filter_bank_count)
+    : handle_(handle), filter_bank_(filter_bank), fifo_(fifo), filter_bank_count_(filter_bank_count), mailbox_(0)
 {
 }
 
@@ -19,28 +25,354 @@ void CanDevice::start()
     HAL_CAN_Start(handle_);
 
     // 设置中断
-    if (fifo_ == CAN_FILTER_FIFO0)
+    activate_notifications();
+
+    stats_.bitrate = calc_bitrate();
+}
+
+void CanDevice::activate_notifications()
+{
+    activate_rx_notification(fifo_);
+
+    // 发送邮箱空中断，用于从发送队列补发
+    HAL_CAN_ActivateNotification(handle_, CAN_IT_TX_MAILBOX_EMPTY);
+
+    // 错误警告、错误被动和离线中断，离线时由on_error()开始恢复
+    // （不打开LEC中断，避免无应答时中断风暴，错误码在错误中断和每次supervise()中采样）
+    HAL_CAN_ActivateNotification(handle_, CAN_IT_ERROR_WARNING | CAN_IT_ERROR_PASSIVE | CAN_IT_BUSOFF | CAN_IT_ERROR);
+}
+
+uint32_t CanDevice::calc_bitrate() const
+{
+    const uint32_t bs1 = ((handle_->Init.TimeSeg1 & CAN_BTR_TS1) >> CAN_BTR_TS1_Pos) + 1;
+    const uint32_t bs2 = ((handle_->Init.TimeSeg2 & CAN_BTR_TS2) >> CAN_BTR_TS2_Pos) + 1;
+    const uint32_t tq = handle_->Init.Prescaler * (1 + bs1 + bs2);
+    return tq != 0 ? HAL_RCC_GetPCLK1Freq() / tq : 0;
+}
+
+void CanDevice::on_error()
+{
+    const uint32_t error = handle_->ErrorCode;
+
+    ++stats_.error_irq_count;
+    sample_lec();
+    if (error & HAL_CAN_ERROR_EWG)
+    {
+        ++stats_.warning_count;
+    }
+    if (error & HAL_CAN_ERROR_EPV)
+    {
+        ++stats_.passive_count;
+    }
+    if ((error & HAL_CAN_ERROR_BOF) && recovery_state_ == RecoveryState::Idle)
+    {
+        ++stats_.bus_off_count;
+        bus_off_cycles_ = HAL::DWTimer::GetCycles();
+        begin_recovery();
+    }
+    if (error & HAL_CAN_ERROR_RX_FOV0)
     {
-        HAL_CAN_ActivateNotification(handle_, CAN_IT_RX_FIFO0_MSG_PENDING);
+        ++stats_.fifo_overrun[0];
     }
-    else if (fifo_ == CAN_FILTER_FIFO1)
+    if (error & HAL_CAN_ERROR_RX_FOV1)
     {
-        HAL_CAN_ActivateNotification(handle_, CAN_IT_RX_FIFO1_MSG_PENDING);
+        ++stats_.fifo_overrun[1];
     }
+    HAL_CAN_ResetError(handle_);
+}
+
+void CanDevice::begin_recovery()
+{
+    // 邮箱中的帧在恢复后已经过时，直接中止；发送队列在恢复完成后补发
+    HAL_CAN_AbortTxRequest(handle_, CAN_TX_MAILBOX0 | CAN_TX_MAILBOX1 | CAN_TX_MAILBOX2);
+
+    // 未打开自动离线管理（ABOM）时，离线后需要软件进入再退出初始化模式，硬件才开始恢复序列。
+    // 这里只置位INRQ，不等待INAK，可以在中断中调用
+    SET_BIT(handle_->Instance->MCR, CAN_MCR_INRQ);
+
+    attempt_cycles_ = HAL::DWTimer::GetCycles();
+    recovery_state_ = RecoveryState::EnterInit;
+    stats_.recovering = true;
 }
 
-bool CanDevice::send(const Frame &frame)
+void CanDevice::supervise()
 {
-    if (HAL_CAN_GetTxMailboxesFreeLevel(handle_) == 0)
+    CAN_TypeDef *can = handle_->Instance;
+
+    // 每次调用都采样错误码，1 kHz调用时历史中相邻两项最多相隔1 ms
+    sample_lec();
+
+    switch (recovery_state_)
+    {
+    case RecoveryState::Idle:
+        // 离线中断被错过（例如中断未打开）时按状态寄存器补检
+        if (can->ESR & CAN_ESR_BOFF)
+        {
+            IrqLock lock;
+            if (recovery_state_ == RecoveryState::Idle)
+            {
+                ++stats_.bus_off_count;
+                bus_off_cycles_ = HAL::DWTimer::GetCycles();
+                begin_recovery();
+            }
+        }
+        return;
+
+    case RecoveryState::EnterInit:
+        // 已进入初始化模式，退出后硬件在检测到128次11个连续隐性位后离开离线状态
+        if (can->MSR & CAN_MSR_INAK)
+        {
+            CLEAR_BIT(can->MCR, CAN_MCR_INRQ);
+            attempt_cycles_ = HAL::DWTimer::GetCycles();
+            recovery_state_ = RecoveryState::WaitRecovered;
+            return;
+        }
+        break;
+
+    case RecoveryState::WaitRecovered:
+        if ((can->MSR & CAN_MSR_INAK) == 0 && (can->ESR & CAN_ESR_BOFF) == 0)
+        {
+            finish_recovery();
+            return;
+        }
+        break;
+    }
+
+    // 单次恢复超时（总线仍然短路或断开），重新请求初始化，每次请求的等待时间有上限
+    const uint32_t timeout_cycles = HAL_CAN_RECOVERY_TIMEOUT_US * HAL::DWTimer::getInstance().GetCyclesPerUs();
+    if (HAL::DWTimer::GetCycles() - attempt_cycles_ > timeout_cycles)
+    {
+        ++stats_.recovery_retry_count;
+        SET_BIT(can->MCR, CAN_MCR_INRQ);
+        attempt_cycles_ = HAL::DWTimer::GetCycles();
+        recovery_state_ = RecoveryState::EnterInit;
+    }
+}
+
+void CanDevice::finish_recovery()
+{
+    // 过滤器和中断使能在初始化模式下不会丢失，这里仍按离线前的配置重新写入，保证恢复后状态确定
+    if (filter_plan_.accept_all || filter_plan_.count != 0)
+    {
+        apply_id_filters();
+    }
+    else
+    {
+        configure_filter();
+    }
+    activate_notifications();
+
+    const uint32_t latency_us =
+        (HAL::DWTimer::GetCycles() - bus_off_cycles_) / HAL::DWTimer::getInstance().GetCyclesPerUs();
+    stats_.last_recovery_us = latency_us;
+    if (latency_us > stats_.max_recovery_us)
+    {
+        stats_.max_recovery_us = latency_us;
+    }
+    ++stats_.recovery_count;
+
+    IrqLock lock;
+    recovery_state_ = RecoveryState::Idle;
+    stats_.recovering = false;
+    pump_tx_queue();
+}
+
+void CanDevice::sample_lec()
+{
+    // 错误中断和任务都会调用，读出和写回之间不能被打断
+    IrqLock lock;
+
+    // 错误码：读出后写入7作为“已读”标记，硬件检测到新错误时会覆盖
+    const uint8_t lec = (handle_->Instance->ESR & CAN_ESR_LEC) >> CAN_ESR_LEC_Pos;
+    if (lec == 0 || lec == 7)
+    {
+        return;
+    }
+    for (uint8_t i = LEC_HISTORY_SIZE - 1; i > 0; --i)
+    {
+        stats_.lec_history[i] = stats_.lec_history[i - 1];
+    }
+    stats_.lec_history[0] = static_cast<LastErrorCode>(lec);
+    ++stats_.lec_count;
+    handle_->Instance->ESR = CAN_ESR_LEC;
+}
+
+void CanDevice::update_bus_stats(uint32_t now_ms)
+{
+    // 错误计数器和状态
+    const uint32_t esr = handle_->Instance->ESR;
+    stats_.tec = (esr & CAN_ESR_TEC) >> CAN_ESR_TEC_Pos;
+    stats_.rec = (esr & CAN_ESR_REC) >> CAN_ESR_REC_Pos;
+    stats_.error_warning = (esr & CAN_ESR_EWGF) != 0;
+    stats_.error_passive = (esr & CAN_ESR_EPVF) != 0;
+    stats_.bus_off = (esr & CAN_ESR_BOFF) != 0;
+
+    sample_lec();
+
+    // 帧率和占用率
+    const uint32_t elapsed = now_ms - stats_last_ms_;
+    if (elapsed == 0)
+    {
+        return;
+    }
+
+    const uint32_t rx_frames = stats_.rx_frames;
+    const uint32_t tx_frames = stats_.tx_frames;
+    const uint32_t bits = stats_.rx_bits + stats_.tx_bits;
+
+    stats_.rx_fps = (uint64_t)(rx_frames - stats_last_rx_frames_) * 1000 / elapsed;
+    stats_.tx_fps = (uint64_t)(tx_frames - stats_last_tx_frames_) * 1000 / elapsed;
+    if (stats_.bitrate != 0)
+    {
+        // 位数 / (波特率 * 时间)，单位‰
+        stats_.utilization_permille = (uint64_t)(bits - stats_last_bits_) * 1000000 / ((uint64_t)stats_.bitrate * elapsed);
+        if (stats_.utilization_permille > stats_.peak_utilization_permille)
+        {
+            stats_.peak_utilization_permille = stats_.utilization_permille;
+        }
+    }
+
+    stats_last_ms_ = now_ms;
+    stats_last_rx_frames_ = rx_frames;
+    stats_last_tx_frames_ = tx_frames;
+    stats_last_bits_ = bits;
+}
+
+BusStats CanDevice::get_bus_stats() const
+{
+    return stats_;
+}
+
+void CanDevice::activate_rx_notification(uint32_t fifo)
+{
+    // 同时打开FIFO满和溢出中断，用于及时取空和统计丢帧
+    if (fifo == CAN_FILTER_FIFO0)
+    {
+        HAL_CAN_ActivateNotification(handle_, CAN_IT_RX_FIFO0_MSG_PENDING | CAN_IT_RX_FIFO0_FULL |
+                                                  CAN_IT_RX_FIFO0_OVERRUN);
+    }
+    else if (fifo == CAN_FILTER_FIFO1)
+    {
+        HAL_CAN_ActivateNotification(handle_, CAN_IT_RX_FIFO1_MSG_PENDING | CAN_IT_RX_FIFO1_FULL |
+                                                  CAN_IT_RX_FIFO1_OVERRUN);
+    }
+}
+
+bool CanDevice::send(const Frame &frame, TxPriority priority)
+{
+    IrqLock lock;
+
+    // 队列为空且邮箱有空位时直接发送，不经过队列
+    bool queued = false;
+    for (const auto &queue : tx_queue_)
+    {
+        if (queue.size() != 0)
+        {
+            queued = true;
+            break;
+        }
+    }
+    if (!queued && recovery_state_ == RecoveryState::Idle && HAL_CAN_GetTxMailboxesFreeLevel(handle_) != 0 &&
+        !mailbox_has_id(frame))
+    {
+        return add_tx_message(frame);
+    }
+
+    const uint8_t index = static_cast<uint8_t>(priority);
+    if (!tx_queue_[index].push(frame))
     {
         return false;
     }
+    ++tx_enqueued_[index];
+
+    // 邮箱可能在入队前已经空出，这里补发一次
+    pump_tx_queue();
+    return true;
+}
+
+void CanDevice::on_tx_mailbox_free()
+{
+    IrqLock lock;
+    pump_tx_queue();
+}
+
+void CanDevice::on_tx_complete(uint8_t mailbox)
+{
+    IrqLock lock;
+    stats_.tx_bits += mailbox_bits_[mailbox];
+    mailbox_bits_[mailbox] = 0;
+    pump_tx_queue();
+}
+
+void CanDevice::pump_tx_queue()
+{
+    // 离线恢复期间帧留在队列中，恢复完成后补发
+    if (recovery_state_ != RecoveryState::Idle)
+    {
+        return;
+    }
+
+    Frame frame;
+    for (auto &queue : tx_queue_)
+    {
+        while (queue.peek(frame))
+        {
+            if (HAL_CAN_GetTxMailboxesFreeLevel(handle_) == 0)
+            {
+                return;
+            }
+            // 同ID的帧还在邮箱中时停止补发，保证同ID的帧按顺序发送；
+            // 空出的邮箱也不给低优先级的帧，否则它们会抢在等待中的高优先级帧之前
+            if (mailbox_has_id(frame))
+            {
+                return;
+            }
+            queue.pop(frame);
+            add_tx_message(frame);
+        }
+    }
+}
+
+bool CanDevice::mailbox_has_id(const Frame &frame) const
+{
+    // TIR寄存器：STID[31:21]，扩展帧时EXID占[31:3]，IDE为bit2
+    const uint32_t key = frame.is_extended_id ? (frame.id << CAN_TI0R_EXID_Pos) | CAN_TI0R_IDE
+                                              : (frame.id << CAN_TI0R_STID_Pos);
+    const uint32_t mask = frame.is_extended_id ? (CAN_TI0R_STID | CAN_TI0R_EXID | CAN_TI0R_IDE)
+                                               : (CAN_TI0R_STID | CAN_TI0R_IDE);
+
+    const CAN_TypeDef *can = handle_->Instance;
+    const uint32_t tsr = can->TSR;
+    const uint32_t empty[3] = {CAN_TSR_TME0, CAN_TSR_TME1, CAN_TSR_TME2};
+    for (uint8_t i = 0; i < 3; ++i)
+    {
+        if ((tsr & empty[i]) == 0 && (can->sTxMailBox[i].TIR & mask) == key)
+        {
+            return true;
+        }
+    }
+    return false;
+}
 
+TxQueueStats CanDevice::get_tx_queue_stats(TxPriority priority) const
+{
+    const uint8_t index = static_cast<uint8_t>(priority);
+    TxQueueStats stats;
+    stats.capacity = tx_queue_[index].capacity();
+    stats.depth = tx_queue_[index].size();
+    stats.enqueued = tx_enqueued_[index];
+    stats.dropped = tx_queue_[index].overflow();
+    stats.max_depth = tx_queue_[index].high_water();
+    return stats;
+}
+
+bool CanDevice::add_tx_message(const Frame &frame)
+{
     CAN_TxHeaderTypeDef tx_header;
     tx_header.DLC = frame.dlc;
     tx_header.IDE = frame.is_extended_id ? CAN_ID_EXT : CAN_ID_STD;
     tx_header.RTR = frame.is_remote_frame ? CAN_RTR_REMOTE : CAN_RTR_DATA;
-    uint32_t temp_mailbox = frame.mailbox;
+    uint32_t temp_mailbox = 0;
 
     if (frame.is_extended_id)
     {
@@ -60,19 +392,65 @@ bool CanDevice::send(const Frame &frame)
         return false;
     }
 
+    // 位数在发送完成中断中计入，被begin_recovery()中止的帧不占总线
+    const uint8_t index = temp_mailbox == CAN_TX_MAILBOX0 ? 0 : (temp_mailbox == CAN_TX_MAILBOX1 ? 1 : 2);
+    mailbox_bits_[index] = frame_bits_worst_case(frame.dlc, frame.is_extended_id, frame.is_remote_frame);
+    ++stats_.tx_frames;
+    HAL_CAN_TRACE_RECORD(trace_bus_, frame, true);
     return true;
 }
 
 bool CanDevice::receive(Frame &frame)
 {
-    CAN_RxHeaderTypeDef rx_header;
+    const uint32_t timestamp = HAL::DWTimer::GetCycles();
 
-    if (HAL_CAN_GetRxFifoFillLevel(handle_, fifo_) == 0)
+    // 启用ID过滤器后两个FIFO都可能有数据，默认FIFO优先
+    uint32_t fifo = fifo_;
+    if (HAL_CAN_GetRxFifoFillLevel(handle_, fifo) == 0)
     {
-        return false;
+        fifo = (fifo_ == CAN_RX_FIFO0) ? CAN_RX_FIFO1 : CAN_RX_FIFO0;
+        if (HAL_CAN_GetRxFifoFillLevel(handle_, fifo) == 0)
+        {
+            return false;
+        }
+    }
+
+    return read_fifo(fifo, frame, timestamp);
+}
+
+uint32_t CanDevice::receive_all()
+{
+    // 一次中断读出的所有帧使用同一个时间戳（中断入口），与FIFO中的排队时间无关
+    const uint32_t timestamp = HAL::DWTimer::GetCycles();
+    Frame frame;
+    uint32_t count = 0;
+
+    // 按进入中断时的填充级别读取，读取期间新到的帧会再次触发中断
+    for (uint32_t fifo : {CAN_RX_FIFO0, CAN_RX_FIFO1})
+    {
+        uint32_t level = HAL_CAN_GetRxFifoFillLevel(handle_, fifo);
+        while (level-- > 0)
+        {
+            if (read_fifo(fifo, frame, timestamp))
+            {
+                ++count;
+            }
+        }
     }
+    return count;
+}
+
+void CanDevice::on_rx_fifo_full(uint32_t fifo)
+{
+    ++stats_.fifo_full[fifo == CAN_RX_FIFO0 ? 0 : 1];
+    receive_all();
+}
+
+bool CanDevice::read_fifo(uint32_t fifo, Frame &frame, uint32_t timestamp)
+{
+    CAN_RxHeaderTypeDef rx_header;
 
-    if (HAL_CAN_GetRxMessage(handle_, fifo_, &rx_header, frame.data) != HAL_OK)
+    if (HAL_CAN_GetRxMessage(handle_, fifo, &rx_header, frame.data) != HAL_OK)
     {
         return false;
     }
@@ -82,11 +460,38 @@ bool CanDevice::receive(Frame &frame)
     frame.dlc = rx_header.DLC;
     frame.is_extended_id = (rx_header.IDE == CAN_ID_EXT);
     frame.is_remote_frame = (rx_header.RTR == CAN_RTR_REMOTE);
+    frame.timestamp = timestamp & Frame::TIMESTAMP_MASK;
 
-    // 自动触发所有注册的回调函数
-    trigger_rx_callbacks(frame);
+    ++stats_.rx_frames;
+    stats_.rx_bits += frame_bits_worst_case(frame.dlc, frame.is_extended_id, frame.is_remote_frame);
+    HAL_CAN_TRACE_RECORD(trace_bus_, frame, false);
 
-    return true;
+    // 中断里只做拷贝，解析放到drain_rx()中由任务完成
+    return rx_ring_.push(frame);
+}
+
+uint32_t CanDevice::drain_rx(uint32_t max_frames)
+{
+    Frame frame;
+    uint32_t count = 0;
+
+    while (count < max_frames && rx_ring_.pop(frame))
+    {
+        trigger_rx_callbacks(frame);
+        ++count;
+    }
+
+    return count;
+}
+
+RxRingStats CanDevice::get_rx_ring_stats() const
+{
+    RxRingStats stats;
+    stats.capacity = rx_ring_.capacity();
+    stats.depth = rx_ring_.size();
+    stats.high_water = rx_ring_.high_water();
+    stats.overflow = rx_ring_.overflow();
+    return stats;
 }
 
 CAN_HandleTypeDef *CanDevice::get_handle() const
@@ -111,23 +516,101 @@ void CanDevice::configure_filter()
     HAL_CAN_ConfigFilter(handle_, &filter);
 }
 
-void CanDevice::register_rx_callback(RxCallback callback)
+bool CanDevice::add_filter_id(ID_t id, bool is_extended, RxPriority priority)
 {
-    if (callback)
-    {
-        rx_callbacks_.push_back(callback);
-    }
+    return filter_planner_.add(id, is_extended, static_cast<uint8_t>(priority));
 }
 
-void CanDevice::trigger_rx_callbacks(const Frame &frame)
+bool CanDevice::apply_id_filters()
 {
-    for (auto &callback : rx_callbacks_)
+    CanFilterPlanner::Plan plan;
+    if (!filter_planner_.build(filter_bank_, filter_bank_count_, plan))
+    {
+        return false;
+    }
+
+    if (plan.accept_all)
     {
-        if (callback)
+        configure_filter();
+        filter_plan_ = plan;
+        return true;
+    }
+
+    for (uint8_t i = 0; i < plan.count; ++i)
+    {
+        const CanFilterPlanner::Bank &bank = plan.banks[i];
+
+        CAN_FilterTypeDef filter;
+        filter.FilterActivation = CAN_FILTER_ENABLE;
+        filter.FilterBank = bank.bank;
+        filter.FilterFIFOAssignment = bank.fifo ? CAN_FILTER_FIFO1 : CAN_FILTER_FIFO0;
+        filter.FilterIdHigh = bank.id_high;
+        filter.FilterIdLow = bank.id_low;
+        filter.FilterMaskIdHigh = bank.mask_high;
+        filter.FilterMaskIdLow = bank.mask_low;
+        filter.FilterMode = (bank.mode == CanFilterPlanner::Mode::List16 || bank.mode == CanFilterPlanner::Mode::List32)
+                                ? CAN_FILTERMODE_IDLIST
+                                : CAN_FILTERMODE_IDMASK;
+        filter.FilterScale = (bank.mode == CanFilterPlanner::Mode::List16 || bank.mode == CanFilterPlanner::Mode::Mask16)
+                                 ? CAN_FILTERSCALE_16BIT
+                                 : CAN_FILTERSCALE_32BIT;
+        filter.SlaveStartFilterBank = 14;
+
+        if (HAL_CAN_ConfigFilter(handle_, &filter) != HAL_OK)
         {
-            callback(frame);
+            return false;
         }
     }
+
+    // 关闭本设备范围内其余的过滤器组（包括原来的全部接收过滤器）
+    for (uint32_t bank = filter_bank_ + plan.count; bank < filter_bank_ + filter_bank_count_; ++bank)
+    {
+        CAN_FilterTypeDef filter = {};
+        filter.FilterActivation = CAN_FILTER_DISABLE;
+        filter.FilterBank = bank;
+        filter.FilterMode = CAN_FILTERMODE_IDMASK;
+        filter.FilterScale = CAN_FILTERSCALE_32BIT;
+        filter.SlaveStartFilterBank = 14;
+        HAL_CAN_ConfigFilter(handle_, &filter);
+    }
+
+    // 两个FIFO都可能收到数据，对应的接收中断都要打开
+    if (plan.uses_fifo[0])
+    {
+        activate_rx_notification(CAN_FILTER_FIFO0);
+    }
+    if (plan.uses_fifo[1])
+    {
+        activate_rx_notification(CAN_FILTER_FIFO1);
+    }
+
+    filter_plan_ = plan;
+    return true;
+}
+
+bool CanDevice::register_rx_callback(RxCallback callback)
+{
+    return rx_callbacks_.add(callback);
+}
+
+bool CanDevice::register_id_handler(ID_t id, bool is_extended, IdHandlerFn fn, void *ctx, uint8_t slot,
+                                    RxPriority priority)
+{
+    if (!id_router_.add(id, is_extended, fn, ctx, slot))
+    {
+        return false;
+    }
+    return add_filter_id(id, is_extended, priority);
 }
 
-} // namespace HAL::CAN
\ No newline at end of file
+void CanDevice::trigger_rx_callbacks(const Frame &frame)
+{
+    // 已注册ID的帧直接交给对应处理函数
+    id_router_.dispatch(frame);
+
+    rx_callbacks_.invoke(frame);
+}
+
+} // namespace HAL::CAN
+
+#endif // HAL_CAN_VIRTUAL
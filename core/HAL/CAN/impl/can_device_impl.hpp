@@ -11,17 +11,39 @@
 
 #pragma once
 #include "../interface/can_device.hpp"
-#include <vector>
+#include "../interface/can_id_router.hpp"
+#include "can_filter_planner.hpp"
+#include "can_frame_ring.hpp"
+
+// 每路CAN的接收队列容量（帧），需为2的幂，可在编译选项中覆盖
+#ifndef HAL_CAN_RX_RING_SIZE
+#define HAL_CAN_RX_RING_SIZE 32
+#endif
+
+// 每路CAN可注册的接收回调数量上限
+#ifndef HAL_CAN_MAX_RX_CALLBACKS
+#define HAL_CAN_MAX_RX_CALLBACKS 4
+#endif
+
+// 每路CAN每个发送优先级的队列容量（帧），需为2的幂，可在编译选项中覆盖
+#ifndef HAL_CAN_TX_QUEUE_SIZE
+#define HAL_CAN_TX_QUEUE_SIZE 8
+#endif
+
+// 单次离线恢复的超时时间（微秒）：请求重新初始化后超过该时间仍未恢复则重新请求，可在编译选项中覆盖
+#ifndef HAL_CAN_RECOVERY_TIMEOUT_US
+#define HAL_CAN_RECOVERY_TIMEOUT_US 20000
+#endif
 
 namespace HAL::CAN
 {
 
 // CAN硬件设备实现类
-class CanDevice : public ICanDevice
+class CanDevice final : public ICanDevice
 {
   public:
-    // 构造函数，初始化CAN设备
-    explicit CanDevice(CAN_HandleTypeDef *handle, uint32_t filter_bank, uint32_t fifo);
+    // 构造函数，初始化CAN设备；filter_bank_count为该设备可用的过滤器组数量
+    explicit CanDevice(CAN_HandleTypeDef *handle, uint32_t filter_bank, uint32_t fifo, uint32_t filter_bank_count = 14);
 
     // 析构函数
     ~CanDevice() override = default;
@@ -33,25 +55,124 @@ class CanDevice : public ICanDevice
     // 实现ICanDevice接口
     void init() override;
     void start() override;
-    bool send(const Frame &frame) override;
+    bool send(const Frame &frame, TxPriority priority = TxPriority::Control) override;
+    void on_tx_mailbox_free() override;
+
+    // 发送邮箱完成中断：累加已发送帧的位数并补发，mailbox为邮箱号（0~2）
+    void on_tx_complete(uint8_t mailbox);
+    TxQueueStats get_tx_queue_stats(TxPriority priority) const override;
     bool receive(Frame &frame) override;
+    uint32_t receive_all() override;
+    void on_rx_fifo_full(uint32_t fifo) override;
+    uint32_t drain_rx(uint32_t max_frames = UINT32_MAX) override;
+    RxRingStats get_rx_ring_stats() const override;
     CAN_HandleTypeDef *get_handle() const override;
 
+    // 总线统计
+    void on_error() override;
+    void supervise() override;
+    void update_bus_stats(uint32_t now_ms) override;
+    BusStats get_bus_stats() const override;
+
     // 实现回调机制
-    void register_rx_callback(RxCallback callback) override;
+    bool register_rx_callback(RxCallback callback) override;
+    bool register_id_handler(ID_t id, bool is_extended, IdHandlerFn fn, void *ctx, uint8_t slot,
+                             RxPriority priority = RxPriority::Low) override;
     void trigger_rx_callbacks(const Frame &frame) override;
 
+    // 硬件过滤器
+    bool add_filter_id(ID_t id, bool is_extended, RxPriority priority = RxPriority::Low) override;
+    bool apply_id_filters() override;
+
+    // 抓包时记录的总线编号，由CanBus注册设备时设置
+    void set_trace_bus(uint8_t bus)
+    {
+        trace_bus_ = bus;
+    }
+
+    // 获取最近一次生效的过滤器规划
+    const CanFilterPlanner::Plan &get_filter_plan() const
+    {
+        return filter_plan_;
+    }
+
   private:
     CAN_HandleTypeDef *handle_;
     uint32_t filter_bank_;
     uint32_t fifo_;
+    uint32_t filter_bank_count_;
     uint32_t mailbox_;
+    uint8_t trace_bus_ = 0xFF;
 
     // 存储注册的回调函数
-    std::vector<RxCallback> rx_callbacks_;
+    HAL::DELEGATE::CallbackRegistry<RxCallback, HAL_CAN_MAX_RX_CALLBACKS> rx_callbacks_;
+
+    // ID路由表
+    CanIdRouter id_router_;
+
+    // 中断到任务的接收队列
+    FrameRing<HAL_CAN_RX_RING_SIZE> rx_ring_;
+
+    // 按优先级划分的发送队列，任务和中断都会访问，操作时需关中断
+    FrameRing<HAL_CAN_TX_QUEUE_SIZE> tx_queue_[TX_PRIORITY_COUNT];
+    uint32_t tx_enqueued_[TX_PRIORITY_COUNT] = {0};
+
+    // 总线统计，帧和位计数在中断中累加
+    BusStats stats_ = {};
+    uint32_t stats_last_ms_ = 0;
+    uint32_t stats_last_rx_frames_ = 0;
+    uint32_t stats_last_tx_frames_ = 0;
+    uint32_t stats_last_bits_ = 0;
+    uint16_t mailbox_bits_[3] = {0}; // 各邮箱中帧的位数，发送完成时计入tx_bits
 
-    // 配置过滤器
+    // 硬件过滤器规划
+    CanFilterPlanner filter_planner_;
+    CanFilterPlanner::Plan filter_plan_ = {};
+
+    // 离线恢复状态：Idle -> EnterInit（等待进入初始化模式）-> WaitRecovered（等待硬件检测到128次11个隐性位）-> Idle
+    enum class RecoveryState : uint8_t
+    {
+        Idle,
+        EnterInit,
+        WaitRecovered,
+    };
+    volatile RecoveryState recovery_state_ = RecoveryState::Idle;
+    uint32_t bus_off_cycles_ = 0;  // 检测到离线时的周期计数
+    uint32_t attempt_cycles_ = 0;  // 本次请求重新初始化时的周期计数
+
+    // 配置过滤器（全部接收）
     void configure_filter();
+
+    // 把帧写入发送邮箱
+    bool add_tx_message(const Frame &frame);
+
+    // 按优先级把发送队列中的帧填入空闲邮箱（调用前需关中断），离线恢复期间不发送
+    void pump_tx_queue();
+
+    // 邮箱中是否有同ID的帧等待发送。bxCAN（TXFP=0）按ID决定邮箱发送顺序，ID相同时邮箱号小的先发，
+    // 同ID的帧同时进入多个邮箱会乱序，分段传输等依赖顺序的数据需要逐帧进入邮箱
+    bool mailbox_has_id(const Frame &frame) const;
+
+    // 由CAN初始化参数和PCLK1计算波特率
+    uint32_t calc_bitrate() const;
+
+    // 从指定硬件FIFO读出一帧并放入接收队列，timestamp为进入中断时的周期计数
+    bool read_fifo(uint32_t fifo, Frame &frame, uint32_t timestamp);
+
+    // 使能指定FIFO的接收中断
+    void activate_rx_notification(uint32_t fifo);
+
+    // 使能发送、错误和默认FIFO的接收中断
+    void activate_notifications();
+
+    // 离线后请求进入初始化模式（不等待），并中止邮箱中的帧
+    void begin_recovery();
+
+    // 硬件退出离线后重新配置过滤器和中断，记录恢复时间
+    void finish_recovery();
+
+    // 读取ESR寄存器的LEC，有新错误码时记入lec_history（错误中断、supervise()和update_bus_stats()中调用）
+    void sample_lec();
 };
 
 } // namespace HAL::CAN
\ No newline at end of file
@@ -0,0 +1,267 @@
+#include "can_filter_planner.hpp"
+
+namespace HAL::CAN
+{
+
+namespace
+{
+
+constexpr uint32_t STD_FULL_MASK = 0x7FF;
+constexpr uint32_t EXT_FULL_MASK = 0x1FFFFFFF;
+
+// 标准ID在16位过滤器中的位置：STID[10:0] RTR IDE EXID[17:15]
+constexpr uint16_t std16_id(uint32_t id)
+{
+    return static_cast<uint16_t>((id & STD_FULL_MASK) << 5);
+}
+
+// 掩码同时要求IDE位匹配，避免扩展帧漏进来
+constexpr uint16_t std16_mask(uint32_t mask)
+{
+    return static_cast<uint16_t>(((mask & STD_FULL_MASK) << 5) | 0x8);
+}
+
+// 扩展ID在32位过滤器中的位置：EXID[28:0] IDE RTR 0
+constexpr uint32_t ext32_id(uint32_t id)
+{
+    return ((id & EXT_FULL_MASK) << 3) | 0x4;
+}
+
+constexpr uint32_t ext32_mask(uint32_t mask)
+{
+    return ((mask & EXT_FULL_MASK) << 3) | 0x4;
+}
+
+constexpr uint8_t div_ceil(uint8_t a, uint8_t b)
+{
+    return static_cast<uint8_t>((a + b - 1) / b);
+}
+
+} // namespace
+
+bool CanFilterPlanner::add(ID_t id, bool is_extended, uint8_t fifo)
+{
+    for (uint8_t i = 0; i < count_; ++i)
+    {
+        if (entries_[i].id == id && entries_[i].is_extended == is_extended)
+        {
+            return true;
+        }
+    }
+
+    if (count_ >= MAX_IDS)
+    {
+        return false;
+    }
+
+    entries_[count_].id = id & (is_extended ? EXT_FULL_MASK : STD_FULL_MASK);
+    entries_[count_].is_extended = is_extended;
+    entries_[count_].fifo = fifo ? 1 : 0;
+    ++count_;
+    return true;
+}
+
+bool CanFilterPlanner::build(uint8_t first_bank, uint8_t bank_budget, Plan &plan) const
+{
+    plan.count = 0;
+    plan.merged = 0;
+    plan.accept_all = (count_ == 0);
+    plan.uses_fifo[0] = false;
+    plan.uses_fifo[1] = false;
+
+    if (count_ == 0)
+    {
+        return true;
+    }
+    if (bank_budget == 0)
+    {
+        return false;
+    }
+    if (bank_budget > MAX_BANKS)
+    {
+        bank_budget = MAX_BANKS;
+    }
+
+    // 四类：FIFO0标准帧、FIFO0扩展帧、FIFO1标准帧、FIFO1扩展帧
+    constexpr uint8_t CLASS_NUM = 4;
+    Group groups[CLASS_NUM][MAX_IDS];
+    uint8_t group_num[CLASS_NUM] = {0};
+
+    for (uint8_t i = 0; i < count_; ++i)
+    {
+        const Entry &e = entries_[i];
+        const uint8_t c = e.fifo * 2 + (e.is_extended ? 1 : 0);
+        groups[c][group_num[c]].value = e.id;
+        groups[c][group_num[c]].mask = e.is_extended ? EXT_FULL_MASK : STD_FULL_MASK;
+        ++group_num[c];
+    }
+
+    auto class_full_mask = [](uint8_t c) { return (c & 1) ? EXT_FULL_MASK : STD_FULL_MASK; };
+
+    // 计算一类ID需要的过滤器组数：精确ID走列表模式，合并后的掩码走掩码模式
+    auto class_banks = [&](uint8_t c) -> uint8_t {
+        const uint32_t full = class_full_mask(c);
+        uint8_t exact = 0;
+        uint8_t masked = 0;
+        for (uint8_t i = 0; i < group_num[c]; ++i)
+        {
+            if (groups[c][i].mask == full)
+            {
+                ++exact;
+            }
+            else
+            {
+                ++masked;
+            }
+        }
+        return (c & 1) ? static_cast<uint8_t>(div_ceil(exact, 2) + masked)
+                       : static_cast<uint8_t>(div_ceil(exact, 4) + div_ceil(masked, 2));
+    };
+
+    auto total_banks = [&]() -> uint8_t {
+        uint8_t total = 0;
+        for (uint8_t c = 0; c < CLASS_NUM; ++c)
+        {
+            total += class_banks(c);
+        }
+        return total;
+    };
+
+    // 组数超出预算时逐步合并
+    while (total_banks() > bank_budget)
+    {
+        bool found = false;
+        uint8_t best_c = 0, best_i = 0, best_j = 0;
+        int best_wild = 64;
+
+        for (uint8_t c = 0; c < CLASS_NUM; ++c)
+        {
+            const uint32_t full = class_full_mask(c);
+            for (uint8_t i = 0; i < group_num[c]; ++i)
+            {
+                for (uint8_t j = i + 1; j < group_num[c]; ++j)
+                {
+                    const Group &a = groups[c][i];
+                    const Group &b = groups[c][j];
+                    const uint32_t mask = a.mask & b.mask & ~(a.value ^ b.value);
+                    // 通配位越少，合并后多放行的ID越少
+                    const int wild = __builtin_popcount(full & ~mask);
+                    if (wild < best_wild)
+                    {
+                        best_wild = wild;
+                        best_c = c;
+                        best_i = i;
+                        best_j = j;
+                        found = true;
+                    }
+                }
+            }
+        }
+
+        if (!found)
+        {
+            return false;
+        }
+
+        Group *g = groups[best_c];
+        const uint32_t mask = g[best_i].mask & g[best_j].mask & ~(g[best_i].value ^ g[best_j].value);
+        g[best_i].mask = mask;
+        g[best_i].value &= mask;
+        g[best_j] = g[--group_num[best_c]];
+        ++plan.merged;
+
+        // 去掉已被新掩码覆盖的组
+        for (uint8_t k = 0; k < group_num[best_c];)
+        {
+            if (k != best_i && (g[k].mask & mask) == mask && (g[k].value & mask) == g[best_i].value)
+            {
+                g[k] = g[--group_num[best_c]];
+                if (best_i == group_num[best_c])
+                {
+                    best_i = k;
+                }
+                continue;
+            }
+            ++k;
+        }
+    }
+
+    // 生成过滤器组
+    auto emit = [&](uint8_t fifo, Mode mode, uint16_t id_high, uint16_t id_low, uint16_t mask_high, uint16_t mask_low) {
+        Bank &bank = plan.banks[plan.count];
+        bank.bank = static_cast<uint8_t>(first_bank + plan.count);
+        bank.fifo = fifo;
+        bank.mode = mode;
+        bank.id_high = id_high;
+        bank.id_low = id_low;
+        bank.mask_high = mask_high;
+        bank.mask_low = mask_low;
+        plan.uses_fifo[fifo] = true;
+        ++plan.count;
+    };
+
+    for (uint8_t c = 0; c < CLASS_NUM; ++c)
+    {
+        const uint8_t fifo = c / 2;
+        const bool is_extended = (c & 1) != 0;
+        const uint32_t full = class_full_mask(c);
+
+        Group exact[MAX_IDS];
+        Group masked[MAX_IDS];
+        uint8_t exact_num = 0;
+        uint8_t masked_num = 0;
+        for (uint8_t i = 0; i < group_num[c]; ++i)
+        {
+            if (groups[c][i].mask == full)
+            {
+                exact[exact_num++] = groups[c][i];
+            }
+            else
+            {
+                masked[masked_num++] = groups[c][i];
+            }
+        }
+
+        // 不足一整组时重复最后一个ID/掩码填充空位
+        if (!is_extended)
+        {
+            for (uint8_t i = 0; i < exact_num; i += 4)
+            {
+                uint16_t id[4];
+                for (uint8_t k = 0; k < 4; ++k)
+                {
+                    const uint8_t n = (i + k < exact_num) ? i + k : exact_num - 1;
+                    id[k] = std16_id(exact[n].value);
+                }
+                emit(fifo, Mode::List16, id[1], id[0], id[3], id[2]);
+            }
+            // 16位掩码模式下FR1为第一对（低16位ID、高16位掩码），FR2为第二对，
+            // HAL_CAN_ConfigFilter()把IdLow/MaskIdLow写入FR1，IdHigh/MaskIdHigh写入FR2
+            for (uint8_t i = 0; i < masked_num; i += 2)
+            {
+                const Group &a = masked[i];
+                const Group &b = masked[(i + 1 < masked_num) ? i + 1 : i];
+                emit(fifo, Mode::Mask16, std16_id(b.value), std16_id(a.value), std16_mask(b.mask), std16_mask(a.mask));
+            }
+        }
+        else
+        {
+            for (uint8_t i = 0; i < exact_num; i += 2)
+            {
+                const uint32_t a = ext32_id(exact[i].value);
+                const uint32_t b = ext32_id(exact[(i + 1 < exact_num) ? i + 1 : i].value);
+                emit(fifo, Mode::List32, a >> 16, a & 0xFFFF, b >> 16, b & 0xFFFF);
+            }
+            for (uint8_t i = 0; i < masked_num; ++i)
+            {
+                const uint32_t id = ext32_id(masked[i].value);
+                const uint32_t mask = ext32_mask(masked[i].mask);
+                emit(fifo, Mode::Mask32, id >> 16, id & 0xFFFF, mask >> 16, mask & 0xFFFF);
+            }
+        }
+    }
+
+    return true;
+}
+
+} // namespace HAL::CAN
@@ -0,0 +1,117 @@
+/**
+ * @file can_filter_planner.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief bxCAN硬件过滤器规划
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstdint>
+
+namespace HAL::CAN
+{
+
+// 与can_device.hpp中的定义保持一致，规划器不依赖HAL头文件，可以在PC上单独编译
+using ID_t = uint32_t;
+
+/**
+ * @brief 过滤器规划
+ *
+ * 把已注册的ID编译为STM32 bxCAN过滤器组（bank）的配置，纯计算，不访问寄存器：
+ * - 能放下时全部使用列表模式：16位列表每组4个标准ID，32位列表每组2个扩展ID
+ * - 组数不够时，贪心地把最相近的ID合并为掩码（16位掩码每组2个，32位掩码每组1个），
+ *   每次选择合并后放行ID数量最少的一对，直到组数满足预算
+ * - 高优先级（电机反馈）分到FIFO0，低优先级分到FIFO1
+ */
+class CanFilterPlanner
+{
+  public:
+    // 参与规划的ID上限
+    static constexpr uint8_t MAX_IDS = 48;
+    // 单个CAN能使用的过滤器组上限（CAN1/CAN2共28组）
+    static constexpr uint8_t MAX_BANKS = 28;
+
+    // 过滤器组模式
+    enum class Mode : uint8_t
+    {
+        List16, // 16位列表，4个标准ID
+        Mask16, // 16位掩码，2个标准ID/掩码对
+        List32, // 32位列表，2个扩展ID
+        Mask32, // 32位掩码，1个ID/掩码对
+    };
+
+    // 单个过滤器组配置，字段与HAL的CAN_FilterTypeDef一一对应
+    struct Bank
+    {
+        uint8_t bank;       // 过滤器组编号（绝对编号）
+        uint8_t fifo;       // 0: FIFO0, 1: FIFO1
+        Mode mode;          // 模式
+        uint16_t id_high;   // FilterIdHigh
+        uint16_t id_low;    // FilterIdLow
+        uint16_t mask_high; // FilterMaskIdHigh
+        uint16_t mask_low;  // FilterMaskIdLow
+    };
+
+    // 规划结果
+    struct Plan
+    {
+        Bank banks[MAX_BANKS];
+        uint8_t count;        // 使用的组数
+        uint8_t merged;       // 合并为掩码的次数（0表示全部为精确匹配）
+        bool accept_all;      // 未登记任何ID，退化为全部接收
+        bool uses_fifo[2];    // 各FIFO是否被使用
+    };
+
+    /**
+     * @brief 登记一个ID，重复登记会被忽略
+     *
+     * @param fifo 0: 高频数据（FIFO0），1: 低频数据（FIFO1）
+     * @return false 登记数量已满
+     */
+    bool add(ID_t id, bool is_extended, uint8_t fifo);
+
+    // 清空已登记的ID
+    void clear()
+    {
+        count_ = 0;
+    }
+
+    uint8_t size() const
+    {
+        return count_;
+    }
+
+    /**
+     * @brief 生成过滤器组配置
+     *
+     * @param first_bank 可用的第一个过滤器组编号
+     * @param bank_budget 可用的过滤器组数量
+     * @param plan 输出
+     * @return false 预算为0或不足以容纳最少的组数
+     */
+    bool build(uint8_t first_bank, uint8_t bank_budget, Plan &plan) const;
+
+  private:
+    struct Entry
+    {
+        ID_t id;
+        bool is_extended;
+        uint8_t fifo;
+    };
+
+    // 规划过程中的ID/掩码组
+    struct Group
+    {
+        uint32_t value;
+        uint32_t mask;
+    };
+
+    Entry entries_[MAX_IDS] = {};
+    uint8_t count_ = 0;
+};
+
+} // namespace HAL::CAN
@@ -0,0 +1,121 @@
+/**
+ * @file can_frame_ring.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief CAN帧环形队列（单生产者/单消费者，无锁）
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include "../interface/can_device.hpp"
+#include <atomic>
+#include <cstdint>
+
+namespace HAL::CAN
+{
+
+/**
+ * @brief 固定容量的CAN帧环形队列
+ *
+ * 只允许一个生产者（CAN接收中断）和一个消费者（电机任务），
+ * 读写指针使用原子变量，push/pop都不需要关中断。
+ * 用作发送队列时有多个生产者（多个任务），需在关中断下访问
+ *
+ * @tparam Capacity 队列容量（帧），必须是2的幂
+ */
+template <uint32_t Capacity> class FrameRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "FrameRing容量必须是2的幂");
+
+  public:
+    // 生产者调用：写入一帧，队列满时丢弃并计数
+    bool push(const Frame &frame)
+    {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        const uint32_t tail = tail_.load(std::memory_order_acquire);
+
+        if (head - tail >= Capacity)
+        {
+            overflow_ = overflow_ + 1;
+            return false;
+        }
+
+        slots_[head & (Capacity - 1)] = frame;
+        head_.store(head + 1, std::memory_order_release);
+
+        const uint32_t depth = head + 1 - tail;
+        if (depth > high_water_)
+        {
+            high_water_ = depth;
+        }
+        return true;
+    }
+
+    // 消费者调用：取出一帧，队列空时返回false
+    bool pop(Frame &frame)
+    {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const uint32_t head = head_.load(std::memory_order_acquire);
+
+        if (head == tail)
+        {
+            return false;
+        }
+
+        frame = slots_[tail & (Capacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者调用：读取队首的帧但不取出，队列空时返回false
+    bool peek(Frame &frame) const
+    {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const uint32_t head = head_.load(std::memory_order_acquire);
+
+        if (head == tail)
+        {
+            return false;
+        }
+
+        frame = slots_[tail & (Capacity - 1)];
+        return true;
+    }
+
+    // 当前积压帧数
+    uint32_t size() const
+    {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    // 历史最高积压帧数
+    uint32_t high_water() const
+    {
+        return high_water_;
+    }
+
+    // 队列满导致丢弃的帧数
+    uint32_t overflow() const
+    {
+        return overflow_;
+    }
+
+    static constexpr uint32_t capacity()
+    {
+        return Capacity;
+    }
+
+  private:
+    Frame slots_[Capacity];
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint32_t> tail_{0};
+
+    // 统计量只由生产者写入
+    volatile uint32_t high_water_ = 0;
+    volatile uint32_t overflow_ = 0;
+};
+
+} // namespace HAL::CAN
@@ -1,13 +1,114 @@
 #include "can_bus.hpp"
+#ifdef HAL_CAN_VIRTUAL
+#include "../virtual/virtual_can.hpp"
+#include <cstdio>
+#else
+#include "../../LOGGER/logger.hpp"
 #include "../impl/can_bus_impl.hpp"
+#endif
 
 namespace HAL::CAN
 {
 
+namespace
+{
+#ifdef HAL_CAN_VIRTUAL
+// PC端直接打印到标准输出
+struct StdoutLogger
+{
+    enum class Level
+    {
+        INFO,
+        WARNING
+    };
+
+    template <typename... Args> void log(Level level, const char *fmt, Args... args)
+    {
+        std::printf("%s", level == Level::WARNING ? "[WARN] " : "[INFO] ");
+        std::printf(fmt, args...);
+        std::printf("\n");
+    }
+};
+using LogLevel = StdoutLogger::Level;
+
+StdoutLogger &get_logger()
+{
+    static StdoutLogger logger;
+    return logger;
+}
+#else
+using LogLevel = HAL::LOGGER::LogLevel;
+
+HAL::LOGGER::Logger &get_logger()
+{
+    return HAL::LOGGER::Logger::getInstance();
+}
+#endif
+} // namespace
+
 // 全局函数实现
 ICanBus &get_can_bus_instance()
 {
-    return CanBus::instance();
+#ifdef HAL_CAN_VIRTUAL
+    return VirtualCanBus::instance();
+#else
+    return BoardCanBus::instance();
+#endif
+}
+
+void supervise_buses()
+{
+    auto &bus = get_can_bus_instance();
+    for (uint8_t i = 0; i < (uint8_t)CanDeviceId::MAX_DEVICES; ++i)
+    {
+        const auto id = static_cast<CanDeviceId>(i);
+        if (bus.has_device(id))
+        {
+            bus.get_device(id).supervise();
+        }
+    }
+}
+
+void log_bus_stats(uint32_t period_ms)
+{
+    static uint32_t last_log_ms = 0;
+
+    const uint32_t now = HAL_GetTick();
+    if (now - last_log_ms < period_ms)
+    {
+        return;
+    }
+    last_log_ms = now;
+
+    auto &bus = get_can_bus_instance();
+    auto &log = get_logger();
+
+    for (uint8_t i = 0; i < (uint8_t)CanDeviceId::MAX_DEVICES; ++i)
+    {
+        const auto id = static_cast<CanDeviceId>(i);
+        if (!bus.has_device(id))
+        {
+            continue;
+        }
+
+        auto &device = bus.get_device(id);
+        device.update_bus_stats(now);
+        const BusStats stats = device.get_bus_stats();
+
+        const auto level = stats.utilization_permille > 700 || stats.bus_off || stats.recovering ? LogLevel::WARNING
+                                                                                                 : LogLevel::INFO;
+        log.log(level, "CAN%u %ukbps load %u.%u%% (peak %u.%u%%) rx %ufps tx %ufps TEC %u REC %u busoff %u lec %u ovr %u/%u",
+                i + 1, stats.bitrate / 1000, stats.utilization_permille / 10, stats.utilization_permille % 10,
+                stats.peak_utilization_permille / 10, stats.peak_utilization_permille % 10, stats.rx_fps, stats.tx_fps,
+                stats.tec, stats.rec, stats.bus_off_count, (unsigned)stats.lec_history[0], stats.fifo_overrun[0],
+                stats.fifo_overrun[1]);
+        if (stats.bus_off_count != 0)
+        {
+            log.log(level, "CAN%u recovered %u/%u retry %u last %uus max %uus warn %u passive %u", i + 1,
+                    stats.recovery_count, stats.bus_off_count, stats.recovery_retry_count, stats.last_recovery_us,
+                    stats.max_recovery_us, stats.warning_count, stats.passive_count);
+        }
+    }
 }
 
 } // namespace HAL::CAN
\ No newline at end of file
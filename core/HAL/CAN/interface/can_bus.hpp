@@ -36,9 +36,24 @@ class ICanBus
 
     // 检查指定ID的设备是否存在
     virtual bool has_device(CanDeviceId id) const = 0;
+
+    // 按HAL句柄查找设备，用于HAL中断回调，找不到时返回nullptr
+    virtual ICanDevice *find_device(const CAN_HandleTypeDef *handle) = 0;
 };
 
 // 获取CAN总线单例实例
 ICanBus &get_can_bus_instance();
 
+/**
+ * @brief 在任务中周期调用（建议1 kHz）：对所有CAN设备调用supervise()，推进离线自动恢复
+ */
+void supervise_buses();
+
+/**
+ * @brief 周期调用：刷新所有CAN设备的总线统计，并每隔period_ms打印一次到日志（RTT）
+ *
+ * 占用率超过70%时以警告级别打印
+ */
+void log_bus_stats(uint32_t period_ms = 1000);
+
 } // namespace HAL::CAN
\ No newline at end of file
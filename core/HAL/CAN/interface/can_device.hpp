@@ -1,6 +1,8 @@
 #pragma once
+#include "../../DELEGATE/delegate.hpp"
 #include "can.h"
-#include <functional>
+#include <cstdint>
+#include <cstring>
 
 namespace HAL::CAN
 {
@@ -8,21 +10,204 @@ namespace HAL::CAN
 // CAN消息ID类型
 using ID_t = uint32_t;
 
-// CAN数据帧结构体
-struct Frame
+// CAN数据帧结构体（16字节）
+//
+// 布局：8字节数据（8字节对齐，可整体按64位读写）+ ID与帧类型标志共用一个字 + 时间戳与DLC共用一个字。
+// 接收队列、发送队列和回调都按值或引用传递该结构体，压缩后每次拷贝只有两条LDRD/STRD。
+struct alignas(8) Frame
 {
     uint8_t data[8];
-    ID_t id;
-    uint8_t dlc;
-    uint32_t mailbox;
+    // CAN ID（标准帧11位，扩展帧29位）
+    uint32_t id : 29;
     // 是否是扩展ID
-    bool is_extended_id;
+    uint32_t is_extended_id : 1;
     // 是否是远程帧
-    bool is_remote_frame;
+    uint32_t is_remote_frame : 1;
+    uint32_t : 1;
+    // 接收时刻（DWT CYCCNT周期数的低28位），在接收中断入口读取；发送帧不使用
+    uint32_t timestamp : 28;
+    // 数据长度（0 ~ 8）
+    uint32_t dlc : 4;
+
+    // 时间戳有效位，168 MHz下约1.6秒回绕一次
+    static constexpr uint32_t TIMESTAMP_MASK = 0x0FFFFFFF;
+
+    /**
+     * @brief 构造一帧数据帧，数据清零
+     *
+     * @param id CAN ID
+     * @param dlc 数据长度
+     * @param is_extended 是否是扩展ID
+     */
+    static Frame make(ID_t id, uint8_t dlc = 8, bool is_extended = false)
+    {
+        Frame frame = {};
+        frame.id = id;
+        frame.dlc = dlc;
+        frame.is_extended_id = is_extended;
+        return frame;
+    }
+
+    // 按小端写入16位数据
+    void put_u16_le(uint8_t offset, uint16_t value)
+    {
+        data[offset] = value & 0xFF;
+        data[offset + 1] = value >> 8;
+    }
+
+    // 按大端写入16位数据（DJI电调控制帧）
+    void put_u16_be(uint8_t offset, uint16_t value)
+    {
+        data[offset] = value >> 8;
+        data[offset + 1] = value & 0xFF;
+    }
+
+    // 按小端写入32位数据
+    void put_u32_le(uint8_t offset, uint32_t value)
+    {
+        data[offset] = value & 0xFF;
+        data[offset + 1] = (value >> 8) & 0xFF;
+        data[offset + 2] = (value >> 16) & 0xFF;
+        data[offset + 3] = value >> 24;
+    }
+
+    // 按内存布局写入float（达妙位置速度模式，小端）
+    void put_f32(uint8_t offset, float value)
+    {
+        memcpy(data + offset, &value, sizeof(value));
+    }
+
+    // 整体写入8字节数据
+    void put_u64(uint64_t value)
+    {
+        memcpy(data, &value, sizeof(value));
+    }
+
+    // 整体读取8字节数据
+    uint64_t get_u64() const
+    {
+        uint64_t value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+};
+
+static_assert(sizeof(Frame) == 16, "Frame应为16字节");
+static_assert(alignof(Frame) == 8, "Frame数据区应8字节对齐");
+
+// CAN接收回调函数类型（不分配堆内存，可放下函数指针或捕获两个指针的lambda）
+using RxCallback = HAL::DELEGATE::InplaceFunction<void(const Frame &)>;
+
+// 接收优先级：高频的电机反馈分到FIFO0，低频数据分到FIFO1
+enum class RxPriority : uint8_t
+{
+    High = 0,
+    Low = 1
 };
 
-// CAN接收回调函数类型
-using RxCallback = std::function<void(const Frame &)>;
+// 发送优先级：队列中高优先级的帧总是先进入发送邮箱
+enum class TxPriority : uint8_t
+{
+    Control = 0,    // 电机控制帧
+    Normal = 1,     // 普通数据
+    Diagnostic = 2, // 诊断/调试数据
+};
+
+// 发送优先级数量
+constexpr uint8_t TX_PRIORITY_COUNT = 3;
+
+// 按ID分发的处理函数：ctx为注册时传入的上下文指针，slot为注册时指定的槽位号
+using IdHandlerFn = void (*)(void *ctx, const Frame &frame, uint8_t slot);
+
+// 接收环形队列统计
+struct RxRingStats
+{
+    uint32_t capacity;   // 队列容量（帧）
+    uint32_t depth;      // 当前积压帧数
+    uint32_t high_water; // 历史最高积压帧数
+    uint32_t overflow;   // 队列满导致丢弃的帧数
+};
+
+// 发送队列统计（单个优先级）
+struct TxQueueStats
+{
+    uint32_t capacity;  // 队列容量（帧）
+    uint32_t depth;     // 当前排队帧数
+    uint32_t enqueued;  // 进入队列的帧数（邮箱有空位直接发送的帧不计入）
+    uint32_t dropped;   // 队列满导致丢弃的帧数
+    uint32_t max_depth; // 历史最大排队帧数
+};
+
+// 最近错误码，与bxCAN ESR寄存器LEC字段一致
+enum class LastErrorCode : uint8_t
+{
+    None = 0,
+    Stuff = 1,        // 位填充错误
+    Form = 2,         // 格式错误
+    Ack = 3,          // 无应答
+    BitRecessive = 4, // 隐性位错误
+    BitDominant = 5,  // 显性位错误
+    Crc = 6,          // CRC错误
+};
+
+// 错误码历史记录长度
+constexpr uint8_t LEC_HISTORY_SIZE = 8;
+
+// 总线统计（只统计本节点收发的帧，启用ID过滤器后被过滤掉的帧不计入）
+struct BusStats
+{
+    uint32_t bitrate;   // 波特率（bit/s），由CAN初始化参数和PCLK1计算
+    uint32_t rx_frames; // 累计接收帧数
+    uint32_t tx_frames; // 累计发送帧数（写入邮箱）
+    uint32_t rx_bits;   // 累计接收位数（按最坏位填充估算，会回绕）
+    uint32_t tx_bits;   // 累计发送位数（发送完成时累加，离线恢复中止的帧不计入；按最坏位填充估算，会回绕）
+
+    // 最近一个统计窗口的值，由update_bus_stats()刷新
+    uint32_t rx_fps;                    // 接收帧率
+    uint32_t tx_fps;                    // 发送帧率
+    uint32_t utilization_permille;      // 总线占用率（‰）
+    uint32_t peak_utilization_permille; // 历史最高占用率（‰）
+
+    // 错误状态（ESR寄存器）
+    uint8_t tec;        // 发送错误计数
+    uint8_t rec;        // 接收错误计数
+    bool error_warning; // 错误警告（TEC或REC >= 96）
+    bool error_passive; // 错误被动（TEC或REC > 127）
+    bool bus_off;       // 离线
+    uint32_t bus_off_count;   // 离线次数
+    uint32_t error_irq_count; // 错误中断次数
+    uint32_t warning_count;   // 进入错误警告次数（中断统计）
+    uint32_t passive_count;   // 进入错误被动次数（中断统计）
+
+    // 离线自动恢复，由supervise()推进
+    bool recovering;               // 正在恢复
+    uint32_t recovery_count;       // 恢复成功次数
+    uint32_t recovery_retry_count; // 单次恢复超时后重新请求的次数
+    uint32_t last_recovery_us;     // 最近一次从离线中断到恢复收发（过滤器、中断已重新生效）的时间
+    uint32_t max_recovery_us;      // 历史最长恢复时间
+
+    // 硬件接收FIFO（每个FIFO只有3级）
+    uint32_t fifo_full[2];    // FIFO满次数
+    uint32_t fifo_overrun[2]; // FIFO溢出次数（有帧丢失）
+
+    LastErrorCode lec_history[LEC_HISTORY_SIZE]; // 最近的错误码，[0]为最新（错误中断和supervise()中采样）
+    uint32_t lec_count;                          // 累计记录的错误码数
+};
+
+/**
+ * @brief 计算一帧在总线上的最大位数（含最坏情况下的位填充和帧间隔）
+ *
+ * 标准帧可填充区域为34位+数据位，扩展帧为54位+数据位，每4位最多插入1个填充位，
+ * 再加上CRC界定符、ACK、EOF和帧间隔共13位
+ */
+constexpr uint32_t frame_bits_worst_case(uint8_t dlc, bool is_extended, bool is_remote = false)
+{
+    const uint32_t data_bits = is_remote ? 0 : 8u * (dlc > 8 ? 8 : dlc);
+    const uint32_t stuffed = (is_extended ? 54u : 34u) + data_bits;
+    return stuffed + 13u + (stuffed - 1u) / 4u;
+}
+
+static_assert(frame_bits_worst_case(8, false) == 135, "8字节标准帧最坏为135位");
 
 // CAN设备抽象接口
 class ICanDevice
@@ -36,19 +221,60 @@ class ICanDevice
     // 启动CAN设备
     virtual void start() = 0;
 
-    // 发送CAN帧
-    virtual bool send(const Frame &frame) = 0;
+    // 发送CAN帧：邮箱有空位时直接发送，否则按优先级进入发送队列，队列满时返回false
+    virtual bool send(const Frame &frame, TxPriority priority = TxPriority::Control) = 0;
+
+    // 在发送邮箱完成/中止中断中调用，把发送队列中的帧填入空闲邮箱
+    virtual void on_tx_mailbox_free() = 0;
 
-    // 接收CAN帧（非阻塞）
+    // 获取发送队列统计
+    virtual TxQueueStats get_tx_queue_stats(TxPriority priority) const = 0;
+
+    // 接收CAN帧（非阻塞），在接收中断中调用，只把帧拷入接收队列
     virtual bool receive(Frame &frame) = 0;
 
+    // 在接收中断中调用，一次取空两个硬件FIFO，返回放入接收队列的帧数
+    virtual uint32_t receive_all() = 0;
+
+    // 在FIFO满中断中调用，计数并立即取空FIFO
+    virtual void on_rx_fifo_full(uint32_t fifo) = 0;
+
+    // 在任务中调用，取出接收队列中的帧并依次触发回调，返回处理的帧数
+    virtual uint32_t drain_rx(uint32_t max_frames = UINT32_MAX) = 0;
+
+    // 获取接收队列统计
+    virtual RxRingStats get_rx_ring_stats() const = 0;
+
+    // 在错误中断（HAL_CAN_ErrorCallback）中调用，记录错误警告/被动/离线等事件，离线时立即开始恢复
+    virtual void on_error() = 0;
+
+    // 在任务中周期调用（建议与drain_rx()同频），推进离线恢复：请求重新初始化、等待硬件退出离线、
+    // 恢复后重新配置过滤器和中断并补发发送队列；没有离线时只读一次状态寄存器
+    virtual void supervise() = 0;
+
+    // 周期调用（建议1s），刷新帧率、占用率并读取错误计数器和错误码
+    virtual void update_bus_stats(uint32_t now_ms) = 0;
+
+    // 获取总线统计
+    virtual BusStats get_bus_stats() const = 0;
+
     // 获取CAN句柄
     virtual CAN_HandleTypeDef *get_handle() const = 0;
 
-    // 注册接收回调函数
-    virtual void register_rx_callback(RxCallback callback) = 0;
+    // 注册接收回调函数，回调数量达到HAL_CAN_MAX_RX_CALLBACKS时返回false
+    virtual bool register_rx_callback(RxCallback callback) = 0;
+
+    // 按精确ID注册处理函数，接收时直接查表分发，不再逐个回调比较ID；ID同时登记到硬件过滤器
+    virtual bool register_id_handler(ID_t id, bool is_extended, IdHandlerFn fn, void *ctx, uint8_t slot,
+                                     RxPriority priority = RxPriority::Low) = 0;
+
+    // 只登记硬件过滤器ID（用于通过register_rx_callback()接收的帧）
+    virtual bool add_filter_id(ID_t id, bool is_extended, RxPriority priority = RxPriority::Low) = 0;
+
+    // 把登记的ID编译为硬件过滤器并生效，未登记任何ID时保持全部接收
+    virtual bool apply_id_filters() = 0;
 
-    // 触发所有注册的回调函数
+    // 先按ID路由表分发，再触发所有注册的回调函数
     virtual void trigger_rx_callbacks(const Frame &frame) = 0;
 
     // 从RX头提取CAN ID
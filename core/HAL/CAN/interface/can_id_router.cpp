@@ -0,0 +1,102 @@
+#include "can_id_router.hpp"
+
+namespace HAL::CAN
+{
+
+bool CanIdRouter::add(ID_t id, bool is_extended, IdHandlerFn fn, void *ctx, uint8_t slot)
+{
+    if (fn == nullptr || route_count_ >= MAX_ROUTES)
+    {
+        return false;
+    }
+
+    if (!is_extended)
+    {
+        if (id >= STD_ID_COUNT || std_index_[id] != 0)
+        {
+            return false;
+        }
+        std_index_[id] = route_count_ + 1;
+    }
+    else
+    {
+        if (id > 0x1FFFFFFF || ext_count_ >= MAX_EXT_ROUTES)
+        {
+            return false;
+        }
+
+        // 插入排序，保持扩展帧表有序
+        uint8_t pos = 0;
+        while (pos < ext_count_ && ext_index_[pos].id < id)
+        {
+            ++pos;
+        }
+        if (pos < ext_count_ && ext_index_[pos].id == id)
+        {
+            return false;
+        }
+        for (uint8_t i = ext_count_; i > pos; --i)
+        {
+            ext_index_[i] = ext_index_[i - 1];
+        }
+        ext_index_[pos].id = id;
+        ext_index_[pos].route = route_count_;
+        ++ext_count_;
+    }
+
+    Route &route = routes_[route_count_++];
+    route.fn = fn;
+    route.ctx = ctx;
+    route.id = id;
+    route.slot = slot;
+    route.is_extended = is_extended;
+    return true;
+}
+
+const CanIdRouter::Route *CanIdRouter::find(const Frame &frame) const
+{
+    if (!frame.is_extended_id)
+    {
+        if (frame.id >= STD_ID_COUNT)
+        {
+            return nullptr;
+        }
+        const uint8_t index = std_index_[frame.id];
+        return index != 0 ? &routes_[index - 1] : nullptr;
+    }
+
+    // 扩展帧二分查找
+    uint8_t lo = 0;
+    uint8_t hi = ext_count_;
+    while (lo < hi)
+    {
+        const uint8_t mid = (lo + hi) / 2;
+        if (ext_index_[mid].id < frame.id)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    if (lo < ext_count_ && ext_index_[lo].id == frame.id)
+    {
+        return &routes_[ext_index_[lo].route];
+    }
+    return nullptr;
+}
+
+bool CanIdRouter::dispatch(const Frame &frame) const
+{
+    const Route *route = find(frame);
+    if (route == nullptr)
+    {
+        return false;
+    }
+
+    route->fn(route->ctx, frame, route->slot);
+    return true;
+}
+
+} // namespace HAL::CAN
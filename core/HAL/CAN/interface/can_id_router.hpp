@@ -0,0 +1,101 @@
+/**
+ * @file can_id_router.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief CAN ID路由表
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include "can_device.hpp"
+#include <cstdint>
+
+// 每路CAN可注册的ID路由条目上限（标准帧+扩展帧）
+#ifndef HAL_CAN_MAX_ID_ROUTES
+#define HAL_CAN_MAX_ID_ROUTES 32
+#endif
+
+// 每路CAN可注册的扩展帧ID上限
+#ifndef HAL_CAN_MAX_EXT_ROUTES
+#define HAL_CAN_MAX_EXT_ROUTES 16
+#endif
+
+namespace HAL::CAN
+{
+
+/**
+ * @brief CAN ID到处理函数的路由表
+ *
+ * 标准帧（11位）使用2048项直接索引表，一次查表即可找到处理函数；
+ * 扩展帧使用按ID排序的小表二分查找。
+ * 索引表只存1字节的路由下标，每路CAN占用约2 KB内存。
+ *
+ * 注册只应在初始化阶段进行，分发在drain_rx()所在任务中执行
+ */
+class CanIdRouter
+{
+  public:
+    static constexpr uint16_t STD_ID_COUNT = 0x800;
+    static constexpr uint8_t MAX_ROUTES = HAL_CAN_MAX_ID_ROUTES;
+    static constexpr uint8_t MAX_EXT_ROUTES = HAL_CAN_MAX_EXT_ROUTES;
+
+    static_assert(MAX_ROUTES < 0xFF, "路由下标使用uint8_t存储");
+
+    /**
+     * @brief 注册一个ID的处理函数
+     *
+     * @param id CAN ID
+     * @param is_extended 是否为扩展帧ID
+     * @param fn 处理函数
+     * @param ctx 处理函数的上下文指针
+     * @param slot 交给处理函数的槽位号
+     * @return false 表已满、ID越界或该ID已被注册
+     */
+    bool add(ID_t id, bool is_extended, IdHandlerFn fn, void *ctx, uint8_t slot);
+
+    /**
+     * @brief 按帧ID分发
+     *
+     * @return true 找到并执行了处理函数
+     */
+    bool dispatch(const Frame &frame) const;
+
+    // 已注册的路由条目数
+    uint8_t size() const
+    {
+        return route_count_;
+    }
+
+  private:
+    struct Route
+    {
+        IdHandlerFn fn;
+        void *ctx;
+        ID_t id;
+        uint8_t slot;
+        bool is_extended;
+    };
+
+    struct ExtEntry
+    {
+        ID_t id;
+        uint8_t route;
+    };
+
+    // 标准帧直接索引表，存放路由下标+1，0表示未注册（可以直接放在.bss段）
+    uint8_t std_index_[STD_ID_COUNT] = {0};
+
+    // 扩展帧表，按ID升序排列
+    ExtEntry ext_index_[MAX_EXT_ROUTES] = {};
+    uint8_t ext_count_ = 0;
+
+    Route routes_[MAX_ROUTES] = {};
+    uint8_t route_count_ = 0;
+
+    const Route *find(const Frame &frame) const;
+};
+
+} // namespace HAL::CAN
@@ -0,0 +1,237 @@
+#include "can_time_sync.hpp"
+#include "../../DWT/DWT.hpp"
+#include "main.h"
+
+namespace HAL::CAN::TIMESYNC
+{
+
+namespace
+{
+// 帧类型（第一个字节高4位），低4位为序号
+constexpr uint8_t TYPE_REQUEST = 0x1;
+constexpr uint8_t TYPE_RESPONSE = 0x2;
+
+// 应答中的t2只传低40位（约12.7天）
+constexpr uint64_t TIME_MASK = (1ull << 40) - 1;
+
+// 偏移和漂移的环路增益（右移位数）：偏移每个样本修正1/4，漂移修正1/16
+constexpr int OFFSET_GAIN_SHIFT = 2;
+constexpr float DRIFT_GAIN = 1.0f / 16.0f;
+
+// 漂移估计上限（ppm），晶振误差一般在±50 ppm以内
+constexpr float DRIFT_LIMIT_PPM = 500.0f;
+
+// 请求超过该时间（微秒）没有应答则作废
+constexpr uint64_t RESPONSE_TIMEOUT_US = 50000;
+} // namespace
+
+CanTimeSync::CanTimeSync(ID_t tx_id, ID_t rx_id, uint32_t period_ms, ClockFn clock)
+    : tx_id_(tx_id), rx_id_(rx_id), period_ms_(period_ms), clock_(clock)
+{
+}
+
+bool CanTimeSync::start(ICanDevice &device)
+{
+    device_ = &device;
+    return device.register_id_handler(rx_id_, false, &CanTimeSync::on_frame, this, 0);
+}
+
+uint64_t CanTimeSync::local_time_us() const
+{
+    if (clock_ != nullptr)
+    {
+        return clock_();
+    }
+    return HAL::DWTimer::GetTimeline_us();
+}
+
+uint64_t CanTimeSync::frame_time_us(const Frame &frame)
+{
+    // 帧时间戳只有28位，用当前时刻减去帧的“年龄”换算到本地时间
+    const uint32_t age_cycles = (HAL::DWTimer::GetCycles() - frame.timestamp) & Frame::TIMESTAMP_MASK;
+    return local_time_us() - HAL::DWTimer::CyclesToUs(age_cycles);
+}
+
+void CanTimeSync::poll()
+{
+    const uint64_t now_us = local_time_us();
+
+    if (pending_ && now_us - pending_t1_ > RESPONSE_TIMEOUT_US)
+    {
+        pending_ = false;
+    }
+
+    const uint32_t now_ms = HAL_GetTick();
+    if (period_ms_ == 0 || device_ == nullptr || now_ms - last_request_ms_ < period_ms_)
+    {
+        return;
+    }
+    last_request_ms_ = now_ms;
+
+    sequence_ = (sequence_ + 1) & 0x0F;
+    // 请求与应答同为8字节，两个方向的传输时间相同，偏移估计不受帧长影响
+    Frame frame = Frame::make(tx_id_, 8);
+    frame.data[0] = TYPE_REQUEST << 4 | sequence_;
+
+    // t1尽量贴近写入邮箱的时刻，使用控制帧优先级避免在队列中排队
+    pending_t1_ = local_time_us();
+    pending_ = device_->send(frame, TxPriority::Control);
+    if (pending_)
+    {
+        ++stats_.requests;
+    }
+}
+
+void CanTimeSync::on_frame(void *ctx, const Frame &frame, uint8_t slot)
+{
+    (void)slot;
+    auto *self = static_cast<CanTimeSync *>(ctx);
+    if (frame.dlc == 0 || frame.is_remote_frame)
+    {
+        return;
+    }
+
+    switch (frame.data[0] >> 4)
+    {
+    case TYPE_REQUEST:
+        self->handle_request(frame);
+        break;
+    case TYPE_RESPONSE:
+        self->handle_response(frame);
+        break;
+    default:
+        break;
+    }
+}
+
+void CanTimeSync::handle_request(const Frame &frame)
+{
+    if (device_ == nullptr)
+    {
+        return;
+    }
+
+    const uint64_t t2 = frame_time_us(frame);
+
+    Frame response = Frame::make(tx_id_, 8);
+    response.data[0] = TYPE_RESPONSE << 4 | (frame.data[0] & 0x0F);
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        response.data[1 + i] = (t2 >> (8 * i)) & 0xFF;
+    }
+
+    // t3在写入帧之前读取，处理时间超过65 ms时饱和（对端会因往返时间过大丢弃该样本）
+    const uint64_t turnaround = local_time_us() - t2;
+    response.put_u16_le(6, turnaround > 0xFFFF ? 0xFFFF : (uint16_t)turnaround);
+
+    if (device_->send(response, TxPriority::Control))
+    {
+        ++stats_.answered;
+    }
+}
+
+void CanTimeSync::handle_response(const Frame &frame)
+{
+    if (!pending_ || frame.dlc < 8 || (frame.data[0] & 0x0F) != sequence_)
+    {
+        return;
+    }
+    pending_ = false;
+
+    const uint64_t t4 = frame_time_us(frame);
+
+    uint64_t t2 = 0;
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        t2 |= (uint64_t)frame.data[1 + i] << (8 * i);
+    }
+    const uint64_t t3 = t2 + (frame.data[6] | (uint16_t)frame.data[7] << 8);
+
+    ++stats_.responses;
+    add_sample(pending_t1_, t2 & TIME_MASK, t3, t4);
+}
+
+void CanTimeSync::add_sample(uint64_t t1, uint64_t t2, uint64_t t3, uint64_t t4)
+{
+    const int64_t rtt = (int64_t)(t4 - t1) - (int64_t)(t3 - t2);
+    if (rtt < 0)
+    {
+        ++stats_.rejected;
+        return;
+    }
+    stats_.last_rtt_us = (uint32_t)rtt;
+
+    // 近期最小往返时间：每个样本放宽1 us，总线负载变化后能逐渐跟上
+    if (stats_.responses == 1 || (uint32_t)rtt < stats_.min_rtt_us)
+    {
+        stats_.min_rtt_us = (uint32_t)rtt;
+    }
+    else
+    {
+        ++stats_.min_rtt_us;
+    }
+    if ((uint32_t)rtt > stats_.min_rtt_us + HAL_CAN_TIMESYNC_RTT_SLACK_US)
+    {
+        ++stats_.rejected;
+        return;
+    }
+
+    const int64_t sample = ((int64_t)(t2 - t1) + (int64_t)(t3 - t4)) / 2;
+    const uint64_t mid = t1 + (t4 - t1) / 2;
+
+    if (!synced_)
+    {
+        ref_local_us_ = mid;
+        offset_us_ = sample;
+        drift_ppm_ = 0.0f;
+        synced_ = true;
+        return;
+    }
+
+    const int64_t dt = (int64_t)(mid - ref_local_us_);
+    const int64_t predicted = offset_us_ + (int64_t)(drift_ppm_ * (float)dt * 1e-6f);
+    const int64_t error = sample - predicted;
+    stats_.last_error_us = (int32_t)error;
+
+    // 偏移突变：对端重启或时钟被重置，直接采用新样本
+    if (error > HAL_CAN_TIMESYNC_STEP_US || error < -HAL_CAN_TIMESYNC_STEP_US)
+    {
+        ++stats_.resets;
+        ref_local_us_ = mid;
+        offset_us_ = sample;
+        drift_ppm_ = 0.0f;
+        return;
+    }
+
+    offset_us_ = predicted + error / (1 << OFFSET_GAIN_SHIFT);
+    if (dt > 0)
+    {
+        drift_ppm_ += (float)error * 1e6f / (float)dt * DRIFT_GAIN;
+        drift_ppm_ = drift_ppm_ > DRIFT_LIMIT_PPM ? DRIFT_LIMIT_PPM : drift_ppm_;
+        drift_ppm_ = drift_ppm_ < -DRIFT_LIMIT_PPM ? -DRIFT_LIMIT_PPM : drift_ppm_;
+    }
+    ref_local_us_ = mid;
+}
+
+uint64_t CanTimeSync::to_remote_time(uint64_t local_us) const
+{
+    if (!synced_)
+    {
+        return local_us;
+    }
+    const int64_t dt = (int64_t)(local_us - ref_local_us_);
+    return local_us + offset_us_ + (int64_t)(drift_ppm_ * (float)dt * 1e-6f);
+}
+
+uint64_t CanTimeSync::to_local_time(uint64_t remote_us) const
+{
+    if (!synced_)
+    {
+        return remote_us;
+    }
+    // 漂移项很小，用未修正漂移的本地时间估计距参考点的时间即可
+    const int64_t dt = (int64_t)(remote_us - offset_us_ - ref_local_us_);
+    return remote_us - offset_us_ - (int64_t)(drift_ppm_ * (float)dt * 1e-6f);
+}
+
+} // namespace HAL::CAN::TIMESYNC
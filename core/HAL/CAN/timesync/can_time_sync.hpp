@@ -0,0 +1,150 @@
+/**
+ * @file can_time_sync.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief 板间时钟同步（CAN双向时间戳交换，估计偏移与漂移）
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include "../interface/can_device.hpp"
+#include <cstdint>
+
+// 往返时间比近期最小值大多少（微秒）以上的样本视为排队延迟，丢弃
+#ifndef HAL_CAN_TIMESYNC_RTT_SLACK_US
+#define HAL_CAN_TIMESYNC_RTT_SLACK_US 100
+#endif
+
+// 偏移误差超过该值（微秒）时认为对端重启或时钟跳变，重新同步
+#ifndef HAL_CAN_TIMESYNC_STEP_US
+#define HAL_CAN_TIMESYNC_STEP_US 2000
+#endif
+
+namespace HAL::CAN::TIMESYNC
+{
+
+// 同步统计
+struct SyncStats
+{
+    uint32_t requests;   // 发出的请求数
+    uint32_t responses;  // 收到的有效应答数
+    uint32_t answered;   // 应答对端的请求数
+    uint32_t rejected;   // 往返时间过大被丢弃的样本数
+    uint32_t resets;     // 重新同步次数
+    uint32_t last_rtt_us; // 最近一次往返时间（扣除对端处理时间）
+    uint32_t min_rtt_us;  // 近期最小往返时间
+    int32_t last_error_us; // 最近一个样本与预测偏移的差
+};
+
+/**
+ * @brief 两块板之间的时钟同步
+ *
+ * 请求方按周期发出请求并记录发送时刻t1，应答方回复请求到达时刻t2（接收中断时间戳）和处理时间t3 - t2，
+ * 请求方在应答到达时刻t4计算：
+ * - 偏移 = ((t2 - t1) + (t3 - t4)) / 2
+ * - 往返时间 = (t4 - t1) - (t3 - t2)
+ *
+ * 只采用往返时间接近近期最小值的样本，偏移和漂移（ppm）用二阶环路滤波平滑，
+ * to_remote_time()按"偏移 + 漂移 × 距上次样本的时间"换算。
+ *
+ * 两块板都创建一个实例并互换ID，需要对端时间的一方把period_ms设为非0：
+ * @code
+ * // 云台板：只应答
+ * HAL::CAN::TIMESYNC::CanTimeSync sync(0x321, 0x320, 0);
+ * // 底盘板：每100 ms请求一次，估计云台板的时间
+ * HAL::CAN::TIMESYNC::CanTimeSync sync(0x320, 0x321, 100);
+ *
+ * sync.start(HAL::CAN::get_can_bus_instance().get_can2()); // 在apply_id_filters()之前
+ * sync.poll();                                              // 与drain_rx()同一个任务中周期调用
+ * @endcode
+ *
+ * 本地时间为DWTimer::GetTimeline_us()（由节拍钩子DWTimer::Tick()维护，不回绕），对poll()的调用间隔没有要求
+ *
+ * t1、t3在帧进入发送队列时读取，排在其他帧后面的等待时间会算进单向延迟。
+ * 偶尔排队的样本会被往返时间过滤掉，但如果请求总是紧跟在电机控制帧之后发出，偏移会有固定误差（约半个帧长），
+ * poll()应放在总线空闲的时段调用（例如电机控制帧发出半个周期之后）
+ */
+class CanTimeSync
+{
+  public:
+    // 本地时钟（微秒），用于替换DWT（例如PC端模拟两块板的时钟差）
+    using ClockFn = uint64_t (*)();
+
+    CanTimeSync(ID_t tx_id, ID_t rx_id, uint32_t period_ms = 100, ClockFn clock = nullptr);
+
+    CanTimeSync(const CanTimeSync &) = delete;
+    CanTimeSync &operator=(const CanTimeSync &) = delete;
+
+    // 绑定CAN设备并登记rx_id
+    bool start(ICanDevice &device);
+
+    // 周期调用：按周期发出请求
+    void poll();
+
+    // 本地时间（微秒）
+    uint64_t local_time_us() const;
+
+    // 是否已经得到至少一个有效样本
+    bool synced() const
+    {
+        return synced_;
+    }
+
+    // 本地时间换算为对端时间，未同步时原样返回
+    uint64_t to_remote_time(uint64_t local_us) const;
+
+    // 对端时间换算为本地时间，未同步时原样返回
+    uint64_t to_local_time(uint64_t remote_us) const;
+
+    // 当前偏移估计（对端 - 本地，微秒）
+    int64_t offset_us() const
+    {
+        return offset_us_;
+    }
+
+    // 当前漂移估计（对端相对本地，ppm）
+    float drift_ppm() const
+    {
+        return drift_ppm_;
+    }
+
+    SyncStats get_stats() const
+    {
+        return stats_;
+    }
+
+  private:
+    ICanDevice *device_ = nullptr;
+    const ID_t tx_id_;
+    const ID_t rx_id_;
+    const uint32_t period_ms_;
+    const ClockFn clock_;
+
+    // 等待应答的请求
+    uint8_t sequence_ = 0;
+    bool pending_ = false;
+    uint64_t pending_t1_ = 0;
+    uint32_t last_request_ms_ = 0;
+
+    // 估计结果：remote = local + offset + drift × (local - ref)
+    bool synced_ = false;
+    uint64_t ref_local_us_ = 0;
+    int64_t offset_us_ = 0;
+    float drift_ppm_ = 0.0f;
+
+    SyncStats stats_ = {};
+
+    static void on_frame(void *ctx, const Frame &frame, uint8_t slot);
+
+    // 帧到达（接收中断）时的本地时间
+    uint64_t frame_time_us(const Frame &frame);
+
+    void handle_request(const Frame &frame);
+    void handle_response(const Frame &frame);
+    void add_sample(uint64_t t1, uint64_t t2, uint64_t t3, uint64_t t4);
+};
+
+} // namespace HAL::CAN::TIMESYNC
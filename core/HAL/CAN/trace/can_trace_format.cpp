@@ -0,0 +1,152 @@
+#include "can_trace_format.hpp"
+#include <cstring>
+
+namespace HAL::CAN::TRACE
+{
+
+namespace
+{
+void put_u16(uint8_t *out, uint16_t value)
+{
+    out[0] = value & 0xFF;
+    out[1] = value >> 8;
+}
+
+void put_u32(uint8_t *out, uint32_t value)
+{
+    out[0] = value & 0xFF;
+    out[1] = (value >> 8) & 0xFF;
+    out[2] = (value >> 16) & 0xFF;
+    out[3] = value >> 24;
+}
+
+uint16_t get_u16(const uint8_t *in)
+{
+    return in[0] | (in[1] << 8);
+}
+
+uint32_t get_u32(const uint8_t *in)
+{
+    return in[0] | (in[1] << 8) | (in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+} // namespace
+
+void encode_header(uint8_t *out, uint32_t clock_hz)
+{
+    memset(out, 0, HEADER_SIZE);
+    memcpy(out, MAGIC, sizeof(MAGIC));
+    out[4] = VERSION;
+    out[5] = HEADER_SIZE;
+    put_u32(out + 8, clock_hz);
+}
+
+bool decode_header(const uint8_t *in, size_t size, uint32_t &clock_hz)
+{
+    if (size < HEADER_SIZE || memcmp(in, MAGIC, sizeof(MAGIC)) != 0 || in[4] != VERSION || in[5] < HEADER_SIZE)
+    {
+        return false;
+    }
+    clock_hz = get_u32(in + 8);
+    return true;
+}
+
+size_t encode_record(uint8_t *out, uint64_t delta, uint8_t bus, bool is_tx, const Frame &frame)
+{
+    size_t n = 0;
+
+    // LEB128：每字节7位，最高位表示后面还有字节
+    do
+    {
+        uint8_t byte = delta & 0x7F;
+        delta >>= 7;
+        out[n++] = delta != 0 ? (byte | 0x80) : byte;
+    } while (delta != 0);
+
+    const uint8_t dlc = frame.dlc > 8 ? 8 : frame.dlc;
+    uint8_t flags = dlc;
+    if (frame.is_remote_frame)
+    {
+        flags |= FLAG_REMOTE;
+    }
+    if (frame.is_extended_id)
+    {
+        flags |= FLAG_EXTENDED;
+    }
+    if (is_tx)
+    {
+        flags |= FLAG_TX;
+    }
+    out[n++] = flags;
+    out[n++] = bus;
+
+    if (frame.is_extended_id)
+    {
+        put_u32(out + n, frame.id);
+        n += 4;
+    }
+    else
+    {
+        put_u16(out + n, static_cast<uint16_t>(frame.id));
+        n += 2;
+    }
+
+    if (!frame.is_remote_frame)
+    {
+        memcpy(out + n, frame.data, dlc);
+        n += dlc;
+    }
+    return n;
+}
+
+bool decode_record(const uint8_t *in, size_t size, uint64_t &delta, Record &record, size_t &used)
+{
+    size_t n = 0;
+    delta = 0;
+    for (uint8_t shift = 0;; shift += 7)
+    {
+        if (n >= size || shift > 63)
+        {
+            return false;
+        }
+        const uint8_t byte = in[n++];
+        delta |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            break;
+        }
+    }
+
+    if (n + 2 > size)
+    {
+        return false;
+    }
+    const uint8_t flags = in[n++];
+    record.bus = in[n++];
+    record.is_tx = (flags & FLAG_TX) != 0;
+
+    Frame &frame = record.frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.dlc = flags & FLAG_DLC_MASK;
+    frame.is_remote_frame = (flags & FLAG_REMOTE) != 0;
+    frame.is_extended_id = (flags & FLAG_EXTENDED) != 0;
+    if (frame.dlc > 8)
+    {
+        return false;
+    }
+
+    const size_t id_size = frame.is_extended_id ? 4 : 2;
+    const size_t data_size = frame.is_remote_frame ? 0 : frame.dlc;
+    if (n + id_size + data_size > size)
+    {
+        return false;
+    }
+    frame.id = frame.is_extended_id ? get_u32(in + n) : get_u16(in + n);
+    n += id_size;
+    memcpy(frame.data, in + n, data_size);
+    n += data_size;
+
+    used = n;
+    return true;
+}
+
+} // namespace HAL::CAN::TRACE
@@ -0,0 +1,94 @@
+/**
+ * @file can_trace_format.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief CAN抓包二进制格式
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include "../interface/can_device.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace HAL::CAN::TRACE
+{
+
+/*
+ * 文件格式（小端）：
+ *
+ * 文件头（16字节）
+ *   0  char[4]  magic "RCAN"
+ *   4  uint8    版本号（1）
+ *   5  uint8    文件头长度（16）
+ *   6  uint16   保留
+ *   8  uint32   时间戳时钟频率（Hz），目标板上为内核时钟（DWT CYCCNT）
+ *   12 uint32   保留
+ *
+ * 记录（变长，每帧一条）
+ *   varint      与上一条记录的时间差（时钟周期，64位LEB128，最长10字节），第一条相对于开始记录的时刻
+ *   uint8       标志：bit0~3 DLC，bit4 远程帧，bit5 扩展帧，bit6 发送方向
+ *   uint8       总线编号（CanDeviceId）
+ *   uint16/32   ID：标准帧2字节，扩展帧4字节
+ *   uint8[DLC]  数据（远程帧没有数据）
+ */
+
+constexpr uint8_t MAGIC[4] = {'R', 'C', 'A', 'N'};
+constexpr uint8_t VERSION = 1;
+constexpr size_t HEADER_SIZE = 16;
+
+// 单条记录的最大长度：10字节varint + 2字节标志/总线 + 4字节ID + 8字节数据
+constexpr size_t MAX_RECORD_SIZE = 24;
+
+// 记录标志位
+constexpr uint8_t FLAG_DLC_MASK = 0x0F;
+constexpr uint8_t FLAG_REMOTE = 0x10;
+constexpr uint8_t FLAG_EXTENDED = 0x20;
+constexpr uint8_t FLAG_TX = 0x40;
+
+// 解码后的记录
+struct Record
+{
+    uint64_t timestamp; // 从抓包开始累计的时钟周期
+    uint8_t bus;        // 总线编号
+    bool is_tx;         // true: 本机发送，false: 本机接收
+    Frame frame;
+};
+
+/**
+ * @brief 写文件头
+ *
+ * @param out 至少HEADER_SIZE字节
+ * @param clock_hz 时间戳时钟频率
+ */
+void encode_header(uint8_t *out, uint32_t clock_hz);
+
+/**
+ * @brief 解析文件头
+ *
+ * @return false 魔数或版本不匹配
+ */
+bool decode_header(const uint8_t *in, size_t size, uint32_t &clock_hz);
+
+/**
+ * @brief 编码一条记录
+ *
+ * @param out 至少MAX_RECORD_SIZE字节
+ * @param delta 与上一条记录的时间差（时钟周期）
+ * @return 写入的字节数
+ */
+size_t encode_record(uint8_t *out, uint64_t delta, uint8_t bus, bool is_tx, const Frame &frame);
+
+/**
+ * @brief 解码一条记录
+ *
+ * @param delta 输出的时间差
+ * @param used 输出的记录长度
+ * @return false 数据不完整或格式错误
+ */
+bool decode_record(const uint8_t *in, size_t size, uint64_t &delta, Record &record, size_t &used);
+
+} // namespace HAL::CAN::TRACE
@@ -0,0 +1,177 @@
+#include "can_trace_recorder.hpp"
+#include "../../DWT/DWT.hpp"
+#include "../../IRQ/irq_lock.hpp"
+#include "main.h"
+
+#ifdef HAL_CAN_VIRTUAL
+#include "../virtual/virtual_can.hpp"
+#else
+#include "../../LOGGER/SEGGER/RTT/SEGGER_RTT.h"
+#endif
+
+namespace HAL::CAN::TRACE
+{
+
+CanTraceRecorder &CanTraceRecorder::instance()
+{
+    static CanTraceRecorder recorder;
+    return recorder;
+}
+
+uint64_t CanTraceRecorder::now()
+{
+#ifdef HAL_CAN_VIRTUAL
+    return VirtualClock::now_us();
+#else
+    return HAL::DWTimer::GetCycles64();
+#endif
+}
+
+uint32_t CanTraceRecorder::clock_hz() const
+{
+#ifdef HAL_CAN_VIRTUAL
+    return 1000000;
+#else
+    return SystemCoreClock;
+#endif
+}
+
+void CanTraceRecorder::start()
+{
+#ifndef HAL_CAN_VIRTUAL
+    // 打开周期计数器，不清零（DWTimer可能已经在使用）
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    uint8_t header[HEADER_SIZE];
+    encode_header(header, clock_hz());
+
+    IrqLock lock;
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    recorded_ = 0;
+    dropped_ = 0;
+    bytes_ = 0;
+    write(header, HEADER_SIZE);
+
+    // 第一条记录的时间差相对于开始记录的时刻
+    last_timestamp_ = now();
+    recording_.store(true, std::memory_order_release);
+}
+
+void CanTraceRecorder::stop()
+{
+    recording_.store(false, std::memory_order_release);
+}
+
+void CanTraceRecorder::write(const uint8_t *data, uint32_t size)
+{
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        buffer_[(head + i) & MASK] = data[i];
+    }
+    head_.store(head + size, std::memory_order_release);
+    bytes_ += size;
+}
+
+void CanTraceRecorder::record(uint8_t bus, const Frame &frame, bool is_tx)
+{
+    if (bus == UNTRACED_BUS || !is_recording())
+    {
+        return;
+    }
+
+    uint8_t encoded[MAX_RECORD_SIZE];
+
+    IrqLock lock;
+    const uint64_t timestamp = now();
+    const size_t size = encode_record(encoded, timestamp - last_timestamp_, bus, is_tx, frame);
+
+    const uint32_t used = head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_acquire);
+    if (SIZE - used < size)
+    {
+        // 丢弃时不更新last_timestamp_，下一条记录的时间差仍相对于上一条已写入的记录
+        ++dropped_;
+        return;
+    }
+
+    write(encoded, size);
+    last_timestamp_ = timestamp;
+    ++recorded_;
+}
+
+size_t CanTraceRecorder::read(uint8_t *out, size_t max_size)
+{
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    const uint32_t head = head_.load(std::memory_order_acquire);
+
+    uint32_t size = head - tail;
+    if (size > max_size)
+    {
+        size = max_size;
+    }
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        out[i] = buffer_[(tail + i) & MASK];
+    }
+
+    tail_.store(tail + size, std::memory_order_release);
+    return size;
+}
+
+size_t CanTraceRecorder::dump_rtt()
+{
+#ifdef HAL_CAN_VIRTUAL
+    return 0;
+#else
+    static uint8_t rtt_buffer[HAL_CAN_TRACE_RTT_BUFFER_SIZE];
+    if (!rtt_configured_)
+    {
+        SEGGER_RTT_ConfigUpBuffer(HAL_CAN_TRACE_RTT_CHANNEL, "cantrace", rtt_buffer, sizeof(rtt_buffer),
+                                  SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+        rtt_configured_ = true;
+    }
+
+    size_t total = 0;
+    // 环形缓冲区最多分两段连续写入
+    for (int part = 0; part < 2; ++part)
+    {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const uint32_t head = head_.load(std::memory_order_acquire);
+        const uint32_t offset = tail & MASK;
+
+        uint32_t size = head - tail;
+        if (size > SIZE - offset)
+        {
+            size = SIZE - offset;
+        }
+        if (size == 0)
+        {
+            break;
+        }
+
+        const unsigned written = SEGGER_RTT_Write(HAL_CAN_TRACE_RTT_CHANNEL, buffer_ + offset, size);
+        tail_.store(tail + written, std::memory_order_release);
+        total += written;
+        if (written < size)
+        {
+            break;
+        }
+    }
+    return total;
+#endif
+}
+
+RecorderStats CanTraceRecorder::get_stats() const
+{
+    RecorderStats stats;
+    stats.recorded = recorded_;
+    stats.dropped = dropped_;
+    stats.pending = head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    stats.bytes = bytes_;
+    return stats;
+}
+
+} // namespace HAL::CAN::TRACE
@@ -0,0 +1,133 @@
+/**
+ * @file can_trace_recorder.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief CAN抓包记录器（RAM环形缓冲，可通过RTT导出）
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include "can_trace_format.hpp"
+#include <atomic>
+
+// 抓包缓冲区大小（字节），需为2的幂；8字节标准帧每条约13字节，4 KB约可缓存300帧
+#ifndef HAL_CAN_TRACE_BUFFER_SIZE
+#define HAL_CAN_TRACE_BUFFER_SIZE 4096
+#endif
+
+// 导出抓包使用的RTT通道（0号通道为日志）
+#ifndef HAL_CAN_TRACE_RTT_CHANNEL
+#define HAL_CAN_TRACE_RTT_CHANNEL 1
+#endif
+
+// RTT通道缓冲区大小（字节）
+#ifndef HAL_CAN_TRACE_RTT_BUFFER_SIZE
+#define HAL_CAN_TRACE_RTT_BUFFER_SIZE 1024
+#endif
+
+namespace HAL::CAN::TRACE
+{
+
+// 不记录的总线编号（CanDevice默认值，由CanBus注册设备时设置为CanDeviceId）
+constexpr uint8_t UNTRACED_BUS = 0xFF;
+
+struct RecorderStats
+{
+    uint32_t recorded; // 已写入缓冲区的帧数
+    uint32_t dropped;  // 缓冲区已满丢弃的帧数
+    uint32_t pending;  // 缓冲区中尚未导出的字节数
+    uint32_t bytes;    // 累计写入的字节数（含文件头）
+};
+
+/**
+ * @brief CAN抓包记录器
+ *
+ * - CanDevice在定义HAL_CAN_TRACE时于接收中断和写入发送邮箱处调用record()，未定义时没有任何开销
+ * - 记录按can_trace_format.hpp的格式编码后写入字节环形缓冲区，缓冲区满时丢弃新帧并计数
+ * - 写入在关中断下完成，可以在多个中断和任务中调用；read()/dump_rtt()只能在一个任务中调用
+ */
+class CanTraceRecorder
+{
+  public:
+    static CanTraceRecorder &instance();
+
+    CanTraceRecorder(const CanTraceRecorder &) = delete;
+    CanTraceRecorder &operator=(const CanTraceRecorder &) = delete;
+
+    // 清空缓冲区，写入文件头并开始记录
+    void start();
+
+    // 停止记录，缓冲区中的数据仍可导出
+    void stop();
+
+    bool is_recording() const
+    {
+        return recording_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 记录一帧（中断安全）
+     *
+     * @param bus 总线编号（CanDeviceId）
+     * @param frame 帧
+     * @param is_tx true: 本机发送，false: 本机接收
+     */
+    void record(uint8_t bus, const Frame &frame, bool is_tx);
+
+    /**
+     * @brief 取出缓冲区中的数据
+     *
+     * @return 取出的字节数
+     */
+    size_t read(uint8_t *out, size_t max_size);
+
+    /**
+     * @brief 把缓冲区中的数据写入RTT通道HAL_CAN_TRACE_RTT_CHANNEL，在低优先级任务中周期调用
+     *
+     * RTT通道满时只写入能写入的部分，剩余数据留到下次
+     *
+     * @return 写入的字节数
+     */
+    size_t dump_rtt();
+
+    RecorderStats get_stats() const;
+
+    // 时间戳时钟频率（Hz）
+    uint32_t clock_hz() const;
+
+  private:
+    static constexpr uint32_t SIZE = HAL_CAN_TRACE_BUFFER_SIZE;
+    static constexpr uint32_t MASK = SIZE - 1;
+    static_assert(SIZE >= 64 && (SIZE & MASK) == 0, "HAL_CAN_TRACE_BUFFER_SIZE必须是2的幂");
+
+    CanTraceRecorder() = default;
+
+    // 当前时间戳：目标板为DWTimer的64位周期数（CYCCNT回绕后仍连续），PC端为仿真时钟（微秒）
+    static uint64_t now();
+
+    // 写入一段数据，调用前需关中断并确认空间足够
+    void write(const uint8_t *data, uint32_t size);
+
+    uint8_t buffer_[SIZE] = {};
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint32_t> tail_{0};
+    std::atomic<bool> recording_{false};
+
+    uint64_t last_timestamp_ = 0;
+    uint32_t recorded_ = 0;
+    uint32_t dropped_ = 0;
+    uint32_t bytes_ = 0;
+    bool rtt_configured_ = false;
+};
+
+} // namespace HAL::CAN::TRACE
+
+// 定义HAL_CAN_TRACE时，CanDevice在收发处记录帧；未定义时展开为空
+#ifdef HAL_CAN_TRACE
+#define HAL_CAN_TRACE_RECORD(bus, frame, is_tx) ::HAL::CAN::TRACE::CanTraceRecorder::instance().record(bus, frame, is_tx)
+#else
+#define HAL_CAN_TRACE_RECORD(bus, frame, is_tx) ((void)0)
+#endif
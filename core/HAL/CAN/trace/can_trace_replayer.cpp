@@ -0,0 +1,172 @@
+#include "can_trace_replayer.hpp"
+#include "../../DWT/DWT.hpp"
+
+#ifdef HAL_CAN_VIRTUAL
+#include "../virtual/virtual_can.hpp"
+#include <chrono>
+#include <thread>
+#endif
+
+namespace HAL::CAN::TRACE
+{
+
+// CanTraceReader实现
+bool CanTraceReader::open(const uint8_t *data, size_t size)
+{
+    data_ = nullptr;
+    size_ = 0;
+    if (data == nullptr || !decode_header(data, size, clock_hz_) || clock_hz_ == 0)
+    {
+        return false;
+    }
+
+    data_ = data;
+    size_ = size;
+    rewind();
+    return true;
+}
+
+void CanTraceReader::rewind()
+{
+    offset_ = data_ != nullptr ? data_[5] : 0;
+    timestamp_ = 0;
+    truncated_ = false;
+}
+
+bool CanTraceReader::next(Record &record)
+{
+    if (data_ == nullptr || offset_ >= size_)
+    {
+        return false;
+    }
+
+    uint64_t delta = 0;
+    size_t used = 0;
+    if (!decode_record(data_ + offset_, size_ - offset_, delta, record, used))
+    {
+        // RTT导出中途停止时最后一条记录可能不完整
+        truncated_ = true;
+        offset_ = size_;
+        return false;
+    }
+
+    offset_ += used;
+    timestamp_ += delta;
+    record.timestamp = timestamp_;
+    return true;
+}
+
+// CanTraceReplayer实现
+bool CanTraceReplayer::open(const uint8_t *data, size_t size)
+{
+    has_pending_ = false;
+    replayed_ = 0;
+#ifdef HAL_CAN_VIRTUAL
+    clock_base_ns_ = VirtualClock::now_ns();
+#endif
+    return reader_.open(data, size);
+}
+
+void CanTraceReplayer::attach(uint8_t bus, ICanDevice *device)
+{
+    if (bus < MAX_BUSES)
+    {
+        devices_[bus] = device;
+    }
+}
+
+uint64_t CanTraceReplayer::to_ns(uint64_t timestamp) const
+{
+    const uint64_t hz = reader_.clock_hz();
+    return timestamp / hz * 1000000000ULL + timestamp % hz * 1000000000ULL / hz;
+}
+
+bool CanTraceReplayer::fetch()
+{
+    while (!has_pending_)
+    {
+        if (!reader_.next(pending_))
+        {
+            return false;
+        }
+        has_pending_ = (include_tx_ || !pending_.is_tx) && pending_.bus < MAX_BUSES &&
+                       devices_[pending_.bus] != nullptr;
+    }
+    return true;
+}
+
+bool CanTraceReplayer::peek_time_ns(uint64_t &t_ns)
+{
+    if (!fetch())
+    {
+        return false;
+    }
+    t_ns = to_ns(pending_.timestamp);
+    return true;
+}
+
+void CanTraceReplayer::dispatch(const Record &record)
+{
+#ifdef HAL_CAN_VIRTUAL
+    const uint64_t t = clock_base_ns_ + to_ns(record.timestamp);
+    if (t > VirtualClock::now_ns())
+    {
+        VirtualClock::set_ns(t);
+    }
+#endif
+    // 接收时间戳按回放时刻重新生成，与接收中断中的行为一致
+    Frame frame = record.frame;
+    frame.timestamp = HAL::DWTimer::GetCycles() & Frame::TIMESTAMP_MASK;
+    devices_[record.bus]->trigger_rx_callbacks(frame);
+    ++replayed_;
+}
+
+uint32_t CanTraceReplayer::run_until(uint64_t t_ns)
+{
+    uint32_t count = 0;
+    while (fetch() && to_ns(pending_.timestamp) <= t_ns)
+    {
+        has_pending_ = false;
+        dispatch(pending_);
+        ++count;
+    }
+    return count;
+}
+
+uint32_t CanTraceReplayer::run_all()
+{
+    return run_until(UINT64_MAX);
+}
+
+#ifdef HAL_CAN_VIRTUAL
+uint32_t CanTraceReplayer::run_realtime(float speed)
+{
+    if (speed <= 0.0f)
+    {
+        return run_all();
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto wall_start = Clock::now();
+    uint64_t first_ns = 0;
+    bool first = true;
+    uint32_t count = 0;
+
+    uint64_t t_ns = 0;
+    while (peek_time_ns(t_ns))
+    {
+        if (first)
+        {
+            first_ns = t_ns;
+            first = false;
+        }
+
+        const auto due = wall_start + std::chrono::nanoseconds((uint64_t)((t_ns - first_ns) / speed));
+        std::this_thread::sleep_until(due);
+        count += run_until(t_ns);
+    }
+    return count;
+}
+#endif
+
+} // namespace HAL::CAN::TRACE
@@ -0,0 +1,127 @@
+/**
+ * @file can_trace_replayer.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief CAN抓包读取与回放
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include "../interface/can_bus.hpp"
+#include "can_trace_format.hpp"
+
+namespace HAL::CAN::TRACE
+{
+
+/**
+ * @brief 顺序读取抓包数据（不拷贝，数据需在读取期间保持有效）
+ */
+class CanTraceReader
+{
+  public:
+    // 打开抓包数据，文件头不正确时返回false
+    bool open(const uint8_t *data, size_t size);
+
+    // 读取下一条记录，读完或数据损坏时返回false
+    bool next(Record &record);
+
+    // 回到第一条记录
+    void rewind();
+
+    uint32_t clock_hz() const
+    {
+        return clock_hz_;
+    }
+
+    // 数据在记录中间截断或损坏
+    bool truncated() const
+    {
+        return truncated_;
+    }
+
+  private:
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    size_t offset_ = 0;
+    uint32_t clock_hz_ = 0;
+    uint64_t timestamp_ = 0;
+    bool truncated_ = false;
+};
+
+/**
+ * @brief 把抓包中的帧按原始时间顺序送入ICanDevice::trigger_rx_callbacks()
+ *
+ * 电机等代码注册的回调与现场运行时完全相同，用于在PC端复现和测量现场数据下的控制代码。
+ * 默认只回放本机接收的帧，发送帧（本机的控制输出）会被跳过。
+ */
+class CanTraceReplayer
+{
+  public:
+    bool open(const uint8_t *data, size_t size);
+
+    // 把抓包中的总线bus回放到device，未关联的总线上的帧被跳过
+    void attach(uint8_t bus, ICanDevice *device);
+
+    // 是否同时回放发送帧
+    void set_include_tx(bool include_tx)
+    {
+        include_tx_ = include_tx;
+    }
+
+    /**
+     * @brief 回放时间戳不晚于t_ns（相对于开始记录的时刻）的所有帧
+     *
+     * 不等待真实时间，结果完全确定。定义HAL_CAN_VIRTUAL时仿真时钟同步推进到每一帧的时刻，
+     * 回调中HAL_GetTick()看到的时间与现场一致（相对于回放开始时的仿真时钟）
+     *
+     * @return 本次回放的帧数
+     */
+    uint32_t run_until(uint64_t t_ns);
+
+    // 回放全部剩余帧
+    uint32_t run_all();
+
+#ifdef HAL_CAN_VIRTUAL
+    /**
+     * @brief 按真实时间回放全部剩余帧
+     *
+     * @param speed 回放倍速，1为原速，2为两倍速；不大于0时不等待
+     * @return 回放的帧数
+     */
+    uint32_t run_realtime(float speed = 1.0f);
+#endif
+
+    // 下一帧的时间（纳秒），没有剩余帧时返回false
+    bool peek_time_ns(uint64_t &t_ns);
+
+    uint32_t replayed() const
+    {
+        return replayed_;
+    }
+
+    const CanTraceReader &reader() const
+    {
+        return reader_;
+    }
+
+  private:
+    static constexpr uint8_t MAX_BUSES = (uint8_t)CanDeviceId::MAX_DEVICES;
+
+    CanTraceReader reader_;
+    ICanDevice *devices_[MAX_BUSES] = {nullptr};
+    bool include_tx_ = false;
+
+    Record pending_ = {};
+    bool has_pending_ = false;
+    uint64_t clock_base_ns_ = 0;
+    uint32_t replayed_ = 0;
+
+    uint64_t to_ns(uint64_t timestamp) const;
+    bool fetch();
+    void dispatch(const Record &record);
+};
+
+} // namespace HAL::CAN::TRACE
@@ -0,0 +1,354 @@
+#include "can_transport.hpp"
+#include "../../DWT/DWT.hpp"
+#include "main.h"
+
+namespace HAL::CAN::TRANSPORT
+{
+
+namespace
+{
+// 单帧最多携带的数据
+constexpr uint16_t SINGLE_FRAME_MAX = 7;
+// 首帧携带的数据
+constexpr uint16_t FIRST_FRAME_DATA = 6;
+// 连续帧携带的数据
+constexpr uint16_t CONSECUTIVE_FRAME_DATA = 7;
+// 12位长度上限
+constexpr uint16_t MESSAGE_MAX = 4095;
+
+static_assert(HAL_CAN_TRANSPORT_MAX_PAYLOAD <= MESSAGE_MAX, "首帧长度字段只有12位");
+static_assert(HAL_CAN_TRANSPORT_MAX_PAYLOAD > SINGLE_FRAME_MAX, "缓冲区至少要能放下一条多帧消息");
+
+Pci pci_of(const Frame &frame)
+{
+    return static_cast<Pci>(frame.data[0] >> 4);
+}
+} // namespace
+
+CanTransport::CanTransport(ID_t tx_id, ID_t rx_id, Mode mode, TxPriority priority)
+    : tx_id_(tx_id), rx_id_(rx_id), mode_(mode), priority_(priority)
+{
+}
+
+bool CanTransport::start(ICanDevice &device)
+{
+    device_ = &device;
+    return device.register_id_handler(rx_id_, false, &CanTransport::on_frame, this, 0);
+}
+
+bool CanTransport::send(const uint8_t *data, uint16_t size)
+{
+    if (tx_state_ != TxState::Idle)
+    {
+        ++stats_.tx_busy;
+        return false;
+    }
+    if (device_ == nullptr || size == 0 || size > HAL_CAN_TRANSPORT_MAX_PAYLOAD)
+    {
+        return false;
+    }
+
+    // 单帧
+    if (size <= SINGLE_FRAME_MAX)
+    {
+        Frame frame = Frame::make(tx_id_, 1 + size);
+        frame.data[0] = (uint8_t)Pci::Single << 4 | size;
+        memcpy(frame.data + 1, data, size);
+        if (!send_frame(frame))
+        {
+            return false;
+        }
+        ++stats_.tx_messages;
+        stats_.tx_bytes += size;
+        return true;
+    }
+
+    // 首帧
+    Frame frame = Frame::make(tx_id_);
+    frame.data[0] = (uint8_t)Pci::First << 4 | (size >> 8);
+    frame.data[1] = size & 0xFF;
+    memcpy(frame.data + 2, data, FIRST_FRAME_DATA);
+    if (!send_frame(frame))
+    {
+        return false;
+    }
+
+    memcpy(tx_buffer_, data, size);
+    tx_size_ = size;
+    tx_offset_ = FIRST_FRAME_DATA;
+    tx_sequence_ = 1;
+
+    if (mode_ == Mode::Fast)
+    {
+        tx_block_size_ = 0;
+        tx_wait_start_ms_ = HAL_GetTick();
+        tx_state_ = TxState::Sending;
+        pump_tx();
+    }
+    else
+    {
+        tx_wait_start_ms_ = HAL_GetTick();
+        tx_state_ = TxState::WaitFlowControl;
+    }
+    return true;
+}
+
+void CanTransport::poll()
+{
+    const uint32_t now = HAL_GetTick();
+
+    if (tx_state_ == TxState::Sending)
+    {
+        pump_tx();
+        // 发送队列长时间没有空位（总线离线、被高优先级帧占满），放弃这条消息
+        if (tx_state_ == TxState::Sending && HAL_GetTick() - tx_wait_start_ms_ > HAL_CAN_TRANSPORT_TIMEOUT_MS)
+        {
+            ++stats_.tx_timeouts;
+            tx_state_ = TxState::Idle;
+        }
+    }
+    else if (tx_state_ == TxState::WaitFlowControl && now - tx_wait_start_ms_ > HAL_CAN_TRANSPORT_TIMEOUT_MS)
+    {
+        ++stats_.tx_timeouts;
+        tx_state_ = TxState::Idle;
+    }
+
+    if (rx_active_ && now - rx_last_ms_ > HAL_CAN_TRANSPORT_TIMEOUT_MS)
+    {
+        ++stats_.rx_timeouts;
+        rx_active_ = false;
+    }
+}
+
+void CanTransport::pump_tx()
+{
+    while (tx_offset_ < tx_size_)
+    {
+        // 流控模式下本块已发完，等待下一个流控帧
+        if (tx_block_size_ != 0 && tx_block_remaining_ == 0)
+        {
+            tx_wait_start_ms_ = HAL_GetTick();
+            tx_state_ = TxState::WaitFlowControl;
+            return;
+        }
+
+        // 发送队列已满时留到下一次poll()，不让send()计入丢帧
+        const TxQueueStats queue = device_->get_tx_queue_stats(priority_);
+        if (queue.depth >= queue.capacity)
+        {
+            return;
+        }
+
+        const uint16_t remaining = tx_size_ - tx_offset_;
+        const uint16_t n = remaining < CONSECUTIVE_FRAME_DATA ? remaining : CONSECUTIVE_FRAME_DATA;
+
+        Frame frame = Frame::make(tx_id_, 1 + n);
+        frame.data[0] = (uint8_t)Pci::Consecutive << 4 | tx_sequence_;
+        memcpy(frame.data + 1, tx_buffer_ + tx_offset_, n);
+        if (!send_frame(frame))
+        {
+            return;
+        }
+
+        tx_offset_ += n;
+        tx_sequence_ = (tx_sequence_ + 1) & 0x0F;
+        tx_wait_start_ms_ = HAL_GetTick();
+        if (tx_block_remaining_ != 0)
+        {
+            --tx_block_remaining_;
+        }
+    }
+
+    ++stats_.tx_messages;
+    stats_.tx_bytes += tx_size_;
+    tx_state_ = TxState::Idle;
+}
+
+void CanTransport::on_frame(void *ctx, const Frame &frame, uint8_t slot)
+{
+    (void)slot;
+    auto *self = static_cast<CanTransport *>(ctx);
+    if (frame.dlc == 0 || frame.is_remote_frame)
+    {
+        return;
+    }
+
+    ++self->stats_.rx_frames;
+    switch (pci_of(frame))
+    {
+    case Pci::Single:
+        self->handle_single(frame);
+        break;
+    case Pci::First:
+        self->handle_first(frame);
+        break;
+    case Pci::Consecutive:
+        self->handle_consecutive(frame);
+        break;
+    case Pci::FlowControl:
+        self->handle_flow_control(frame);
+        break;
+    default:
+        ++self->stats_.rx_sequence_errors;
+        break;
+    }
+}
+
+void CanTransport::handle_single(const Frame &frame)
+{
+    const uint8_t size = frame.data[0] & 0x0F;
+    if (size == 0 || size > SINGLE_FRAME_MAX || size + 1 > frame.dlc)
+    {
+        ++stats_.rx_sequence_errors;
+        return;
+    }
+
+    // 单帧会打断正在接收的多帧消息
+    rx_active_ = false;
+    deliver(frame.data + 1, size);
+}
+
+void CanTransport::handle_first(const Frame &frame)
+{
+    const uint16_t size = (uint16_t)(frame.data[0] & 0x0F) << 8 | frame.data[1];
+    if (frame.dlc < 8 || size <= SINGLE_FRAME_MAX)
+    {
+        ++stats_.rx_sequence_errors;
+        return;
+    }
+    if (size > HAL_CAN_TRANSPORT_MAX_PAYLOAD)
+    {
+        ++stats_.rx_overflow;
+        rx_active_ = false;
+        if (mode_ == Mode::FlowControl)
+        {
+            send_flow_control(FlowStatus::Overflow);
+        }
+        return;
+    }
+
+    memcpy(rx_buffer_, frame.data + 2, FIRST_FRAME_DATA);
+    rx_size_ = size;
+    rx_offset_ = FIRST_FRAME_DATA;
+    rx_sequence_ = 1;
+    rx_block_count_ = 0;
+    rx_first_timestamp_ = frame.timestamp;
+    rx_last_ms_ = HAL_GetTick();
+    rx_active_ = true;
+
+    if (mode_ == Mode::FlowControl)
+    {
+        send_flow_control(FlowStatus::ContinueToSend);
+    }
+}
+
+void CanTransport::handle_consecutive(const Frame &frame)
+{
+    if (!rx_active_)
+    {
+        return;
+    }
+    if ((frame.data[0] & 0x0F) != rx_sequence_)
+    {
+        // 丢了连续帧，整条消息作废
+        ++stats_.rx_sequence_errors;
+        rx_active_ = false;
+        return;
+    }
+
+    const uint16_t remaining = rx_size_ - rx_offset_;
+    const uint16_t n = remaining < CONSECUTIVE_FRAME_DATA ? remaining : CONSECUTIVE_FRAME_DATA;
+    if (frame.dlc < 1 + n)
+    {
+        ++stats_.rx_sequence_errors;
+        rx_active_ = false;
+        return;
+    }
+
+    memcpy(rx_buffer_ + rx_offset_, frame.data + 1, n);
+    rx_offset_ += n;
+    rx_sequence_ = (rx_sequence_ + 1) & 0x0F;
+    rx_last_ms_ = HAL_GetTick();
+
+    if (rx_offset_ >= rx_size_)
+    {
+        rx_active_ = false;
+
+        const uint32_t cycles = (frame.timestamp - rx_first_timestamp_) & Frame::TIMESTAMP_MASK;
+        const uint32_t latency_us = cycles / HAL::DWTimer::getInstance().GetCyclesPerUs();
+        stats_.last_rx_latency_us = latency_us;
+        if (latency_us > stats_.max_rx_latency_us)
+        {
+            stats_.max_rx_latency_us = latency_us;
+        }
+
+        deliver(rx_buffer_, rx_size_);
+        return;
+    }
+
+#if HAL_CAN_TRANSPORT_BLOCK_SIZE != 0
+    if (mode_ == Mode::FlowControl && ++rx_block_count_ >= HAL_CAN_TRANSPORT_BLOCK_SIZE)
+    {
+        rx_block_count_ = 0;
+        send_flow_control(FlowStatus::ContinueToSend);
+    }
+#endif
+}
+
+void CanTransport::handle_flow_control(const Frame &frame)
+{
+    if (tx_state_ != TxState::WaitFlowControl || frame.dlc < 3)
+    {
+        return;
+    }
+
+    switch (static_cast<FlowStatus>(frame.data[0] & 0x0F))
+    {
+    case FlowStatus::ContinueToSend:
+        tx_block_size_ = frame.data[1];
+        tx_block_remaining_ = frame.data[1];
+        tx_wait_start_ms_ = HAL_GetTick();
+        tx_state_ = TxState::Sending;
+        pump_tx();
+        break;
+    case FlowStatus::Wait:
+        tx_wait_start_ms_ = HAL_GetTick();
+        break;
+    case FlowStatus::Overflow:
+    default:
+        ++stats_.tx_aborted;
+        tx_state_ = TxState::Idle;
+        break;
+    }
+}
+
+void CanTransport::send_flow_control(FlowStatus status)
+{
+    Frame frame = Frame::make(tx_id_, 3);
+    frame.data[0] = (uint8_t)Pci::FlowControl << 4 | (uint8_t)status;
+    frame.data[1] = HAL_CAN_TRANSPORT_BLOCK_SIZE;
+    frame.data[2] = 0; // 最小间隔：发送节奏由发送队列决定
+    send_frame(frame);
+}
+
+bool CanTransport::send_frame(const Frame &frame)
+{
+    if (device_ == nullptr || !device_->send(frame, priority_))
+    {
+        return false;
+    }
+    ++stats_.tx_frames;
+    return true;
+}
+
+void CanTransport::deliver(const uint8_t *data, uint16_t size)
+{
+    ++stats_.rx_messages;
+    stats_.rx_bytes += size;
+    if (rx_handler_)
+    {
+        rx_handler_(data, size);
+    }
+}
+
+} // namespace HAL::CAN::TRANSPORT
@@ -0,0 +1,201 @@
+/**
+ * @file can_transport.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief CAN分段传输（ISO-TP风格），用于板间超过8字节的数据块
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include "../interface/can_device.hpp"
+#include <cstdint>
+
+// 单条消息的最大长度（字节），收发缓冲区各占一份，可在编译选项中覆盖（协议上限4095）
+#ifndef HAL_CAN_TRANSPORT_MAX_PAYLOAD
+#define HAL_CAN_TRANSPORT_MAX_PAYLOAD 128
+#endif
+
+// 流控模式下接收方每收到多少帧连续帧再发一次流控帧，0表示只在首帧后发一次
+#ifndef HAL_CAN_TRANSPORT_BLOCK_SIZE
+#define HAL_CAN_TRANSPORT_BLOCK_SIZE 0
+#endif
+
+// 等待流控帧/连续帧、连续帧等待进入发送队列的超时时间（毫秒）
+#ifndef HAL_CAN_TRANSPORT_TIMEOUT_MS
+#define HAL_CAN_TRANSPORT_TIMEOUT_MS 50
+#endif
+
+namespace HAL::CAN::TRANSPORT
+{
+
+// 协议控制信息（每帧第一个字节的高4位）
+enum class Pci : uint8_t
+{
+    Single = 0x0,      // 单帧：低4位为长度（1~7）
+    First = 0x1,       // 首帧：低4位 + 第二字节为12位总长度，携带6字节数据
+    Consecutive = 0x2, // 连续帧：低4位为序号（从1开始，0~15循环），携带7字节数据
+    FlowControl = 0x3, // 流控帧：低4位为状态，第二字节为块大小，第三字节为最小间隔（不使用）
+};
+
+// 流控帧状态
+enum class FlowStatus : uint8_t
+{
+    ContinueToSend = 0,
+    Wait = 1,
+    Overflow = 2,
+};
+
+// 传输模式，收发双方必须一致
+enum class Mode : uint8_t
+{
+    FlowControl, // 首帧后等待接收方的流控帧再发送连续帧
+    Fast,        // 不使用流控帧，首帧后立即发送所有连续帧，只用于可靠的板间链路
+};
+
+// 传输统计
+struct TransportStats
+{
+    uint32_t tx_messages; // 发送完成（全部帧进入发送队列）的消息数
+    uint32_t tx_bytes;    // 发送完成的消息字节数
+    uint32_t tx_frames;   // 发送的帧数（含流控帧）
+    uint32_t tx_busy;     // 上一条消息未发完时send()被拒绝的次数
+    uint32_t tx_timeouts; // 等待流控帧超时，或连续帧超时未能进入发送队列
+    uint32_t tx_aborted;  // 接收方回复溢出而放弃的消息数
+
+    uint32_t rx_messages;        // 接收完成的消息数
+    uint32_t rx_bytes;           // 接收完成的消息字节数
+    uint32_t rx_frames;          // 接收的帧数（含流控帧）
+    uint32_t rx_sequence_errors; // 连续帧序号不连续（丢帧）或格式错误
+    uint32_t rx_timeouts;        // 等待连续帧超时
+    uint32_t rx_overflow;        // 消息长度超过HAL_CAN_TRANSPORT_MAX_PAYLOAD
+
+    uint32_t last_rx_latency_us; // 最近一条多帧消息从首帧到达到最后一帧到达的时间
+    uint32_t max_rx_latency_us;  // 历史最大值
+};
+
+// 消息接收回调，在调用drain_rx()的任务中执行，data只在回调期间有效
+using RxHandler = HAL::DELEGATE::InplaceFunction<void(const uint8_t *data, uint16_t size)>;
+
+/**
+ * @brief 点对点的分段传输通道
+ *
+ * 发送使用tx_id，接收（含对方的流控帧）使用rx_id，收发双方的ID互换：
+ * @code
+ * // 云台板
+ * HAL::CAN::TRANSPORT::CanTransport link(0x300, 0x301, HAL::CAN::TRANSPORT::Mode::Fast);
+ * // 底盘板
+ * HAL::CAN::TRANSPORT::CanTransport link(0x301, 0x300, HAL::CAN::TRANSPORT::Mode::Fast);
+ *
+ * link.start(HAL::CAN::get_can_bus_instance().get_can2());
+ * @endcode
+ *
+ * 构造时不访问CAN设备，可以定义为全局对象
+ *
+ * - 不超过7字节的消息用单帧发送，否则用首帧 + 连续帧
+ * - 发送队列放不下的连续帧由poll()继续发送，同一时间只能有一条消息在发送
+ * - 默认使用Normal优先级，电机控制帧（Control）总是先于分段数据进入邮箱
+ */
+class CanTransport
+{
+  public:
+    CanTransport(ID_t tx_id, ID_t rx_id, Mode mode = Mode::FlowControl, TxPriority priority = TxPriority::Normal);
+
+    CanTransport(const CanTransport &) = delete;
+    CanTransport &operator=(const CanTransport &) = delete;
+
+    /**
+     * @brief 绑定CAN设备并登记rx_id，需要在apply_id_filters()之前调用
+     *
+     * @return false ID路由表或过滤器已满
+     */
+    bool start(ICanDevice &device);
+
+    // 设置消息接收回调
+    void set_rx_handler(RxHandler handler)
+    {
+        rx_handler_ = handler;
+    }
+
+    /**
+     * @brief 发送一条消息，数据会被拷贝
+     *
+     * @return false 未调用start()、上一条消息还未发完、长度超出或首帧进入发送队列失败
+     */
+    bool send(const uint8_t *data, uint16_t size);
+
+    // 周期调用（建议与drain_rx()同频）：继续发送连续帧并检查超时
+    void poll();
+
+    // 是否有消息正在发送
+    bool tx_busy() const
+    {
+        return tx_state_ != TxState::Idle;
+    }
+
+    TransportStats get_stats() const
+    {
+        return stats_;
+    }
+
+    Mode mode() const
+    {
+        return mode_;
+    }
+
+  private:
+    enum class TxState : uint8_t
+    {
+        Idle,
+        WaitFlowControl,
+        Sending,
+    };
+
+    ICanDevice *device_ = nullptr;
+    const ID_t tx_id_;
+    const ID_t rx_id_;
+    const Mode mode_;
+    const TxPriority priority_;
+
+    RxHandler rx_handler_;
+    TransportStats stats_ = {};
+
+    // 发送状态
+    TxState tx_state_ = TxState::Idle;
+    uint8_t tx_buffer_[HAL_CAN_TRANSPORT_MAX_PAYLOAD];
+    uint16_t tx_size_ = 0;
+    uint16_t tx_offset_ = 0;
+    uint8_t tx_sequence_ = 0;
+    uint8_t tx_block_size_ = 0;      // 对方要求的块大小，0表示不限
+    uint8_t tx_block_remaining_ = 0; // 本块还可发送的连续帧数
+    uint32_t tx_wait_start_ms_ = 0; // 开始等待流控帧，或最近一个连续帧进入发送队列的时刻
+
+    // 接收状态
+    bool rx_active_ = false;
+    uint8_t rx_buffer_[HAL_CAN_TRANSPORT_MAX_PAYLOAD];
+    uint16_t rx_size_ = 0;
+    uint16_t rx_offset_ = 0;
+    uint8_t rx_sequence_ = 0;
+    uint8_t rx_block_count_ = 0;
+    uint32_t rx_first_timestamp_ = 0; // 首帧的接收时间戳（Frame::timestamp）
+    uint32_t rx_last_ms_ = 0;
+
+    // ID路由表的处理函数
+    static void on_frame(void *ctx, const Frame &frame, uint8_t slot);
+
+    void handle_single(const Frame &frame);
+    void handle_first(const Frame &frame);
+    void handle_consecutive(const Frame &frame);
+    void handle_flow_control(const Frame &frame);
+
+    // 发送连续帧，直到发完、发送队列已满或需要等待流控帧
+    void pump_tx();
+
+    void send_flow_control(FlowStatus status);
+    bool send_frame(const Frame &frame);
+    void deliver(const uint8_t *data, uint16_t size);
+};
+
+} // namespace HAL::CAN::TRANSPORT
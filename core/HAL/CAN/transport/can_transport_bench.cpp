@@ -0,0 +1,152 @@
+#include "can_transport_bench.hpp"
+
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../virtual/virtual_can.hpp"
+#include <cstdio>
+
+namespace HAL::CAN::TRANSPORT
+{
+
+namespace
+{
+// 单条消息等待接收的上限（微秒）
+constexpr uint64_t MESSAGE_TIMEOUT_US = 100000;
+
+// 收发两端，ID在ID路由表中无法注销，每种模式只创建一次
+struct BenchPair
+{
+    CanTransport *sender;
+    CanTransport *receiver;
+};
+
+BenchPair get_pair(Mode mode, CanDeviceId bus)
+{
+    auto &virtual_bus = VirtualCanBus::instance();
+    auto &local = virtual_bus.get_device(bus);
+    auto &peer = virtual_bus.peer(bus);
+
+    if (mode == Mode::Fast)
+    {
+        static CanTransport sender(0x7E0, 0x7E1, Mode::Fast);
+        static CanTransport receiver(0x7E1, 0x7E0, Mode::Fast);
+        static bool started = sender.start(local) && receiver.start(peer);
+        (void)started;
+        return {&sender, &receiver};
+    }
+
+    static CanTransport sender(0x7E2, 0x7E3, Mode::FlowControl);
+    static CanTransport receiver(0x7E3, 0x7E2, Mode::FlowControl);
+    static bool started = sender.start(local) && receiver.start(peer);
+    (void)started;
+    return {&sender, &receiver};
+}
+
+struct Received
+{
+    const uint8_t *expected;
+    uint16_t size;
+    bool done;
+    bool match;
+};
+} // namespace
+
+BenchResult run_benchmark(uint16_t payload, uint32_t messages, Mode mode, CanDeviceId bus, uint32_t step_us)
+{
+    BenchResult result = {};
+    result.payload = payload;
+    if (payload == 0 || payload > HAL_CAN_TRANSPORT_MAX_PAYLOAD || step_us == 0)
+    {
+        return result;
+    }
+
+    auto &virtual_bus = VirtualCanBus::instance();
+    auto &local = virtual_bus.get_device(bus);
+    auto &peer = virtual_bus.peer(bus);
+    const BenchPair pair = get_pair(mode, bus);
+
+    uint8_t data[HAL_CAN_TRANSPORT_MAX_PAYLOAD];
+    Received received = {};
+    pair.receiver->set_rx_handler([&received](const uint8_t *rx, uint16_t size) {
+        received.done = true;
+        received.match = size == received.size && memcmp(rx, received.expected, size) == 0;
+    });
+
+    const uint32_t frames_before = pair.sender->get_stats().tx_frames + pair.receiver->get_stats().tx_frames;
+    const uint64_t start_us = VirtualClock::now_us();
+    uint64_t latency_sum = 0;
+
+    for (uint32_t i = 0; i < messages; ++i)
+    {
+        for (uint16_t k = 0; k < payload; ++k)
+        {
+            data[k] = (uint8_t)(i + k);
+        }
+        received = {data, payload, false, false};
+
+        const uint64_t send_us = VirtualClock::now_us();
+        bool sent = pair.sender->send(data, payload);
+        while (!received.done && VirtualClock::now_us() - send_us < MESSAGE_TIMEOUT_US)
+        {
+            virtual_bus.run_for_us(step_us);
+            peer.drain_rx();
+            local.drain_rx();
+            if (!sent)
+            {
+                sent = pair.sender->send(data, payload);
+            }
+            pair.sender->poll();
+            pair.receiver->poll();
+        }
+
+        if (!received.done || !received.match)
+        {
+            ++result.errors;
+            continue;
+        }
+
+        const uint32_t latency = (uint32_t)(VirtualClock::now_us() - send_us);
+        latency_sum += latency;
+        result.max_latency_us = latency > result.max_latency_us ? latency : result.max_latency_us;
+        ++result.messages;
+    }
+
+    const uint64_t elapsed_us = VirtualClock::now_us() - start_us;
+    if (result.messages != 0)
+    {
+        result.avg_latency_us = (uint32_t)(latency_sum / result.messages);
+        result.frames_per_message =
+            (pair.sender->get_stats().tx_frames + pair.receiver->get_stats().tx_frames - frames_before) / messages;
+    }
+    if (elapsed_us != 0)
+    {
+        result.throughput_Bps = (uint32_t)((uint64_t)result.messages * payload * 1000000 / elapsed_us);
+    }
+
+    pair.receiver->set_rx_handler(RxHandler());
+    return result;
+}
+
+void print_benchmark(uint32_t messages)
+{
+    static const uint16_t payloads[] = {7, 18, 32, 37, 41, 64, 128};
+
+    std::printf("mode  payload  frames  avg_us  max_us  B/s     errors\n");
+    for (Mode mode : {Mode::Fast, Mode::FlowControl})
+    {
+        for (uint16_t payload : payloads)
+        {
+            if (payload > HAL_CAN_TRANSPORT_MAX_PAYLOAD)
+            {
+                continue;
+            }
+            const BenchResult r = run_benchmark(payload, messages, mode);
+            std::printf("%-5s %-8u %-7u %-7u %-7u %-7u %u\n", mode == Mode::Fast ? "fast" : "fc", r.payload,
+                        r.frames_per_message, r.avg_latency_us, r.max_latency_us, r.throughput_Bps, r.errors);
+        }
+    }
+}
+
+} // namespace HAL::CAN::TRANSPORT
+
+#endif // HAL_CAN_VIRTUAL
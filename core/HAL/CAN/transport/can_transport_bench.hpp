@@ -0,0 +1,48 @@
+/**
+ * @file can_transport_bench.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief CAN分段传输在虚拟总线上的延迟与吞吐量测量（只在PC端编译）
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../interface/can_bus.hpp"
+#include "can_transport.hpp"
+
+namespace HAL::CAN::TRANSPORT
+{
+
+// 一组测量结果
+struct BenchResult
+{
+    uint16_t payload;            // 消息长度（字节）
+    uint32_t messages;           // 完成的消息数
+    uint32_t errors;             // 内容不一致或超时的消息数
+    uint32_t frames_per_message; // 每条消息占用的帧数（含流控帧）
+    uint32_t avg_latency_us;     // 平均端到端延迟：send()到接收回调
+    uint32_t max_latency_us;     // 最大端到端延迟
+    uint32_t throughput_Bps;     // 连续发送时的有效载荷吞吐量（字节/秒）
+};
+
+/**
+ * @brief 在虚拟总线上连续发送messages条消息（上一条收到后再发下一条），测量延迟与吞吐量
+ *
+ * 本机节点发送、对端节点接收，两端都在每个step_us后调用drain_rx()和poll()，
+ * 因此延迟包含最多一个step_us的调度粒度。总线上不能有其他占用0x7E0~0x7E3的节点。
+ */
+BenchResult run_benchmark(uint16_t payload, uint32_t messages, Mode mode,
+                          CanDeviceId bus = CanDeviceId::HAL_Can2, uint32_t step_us = 10);
+
+// 按常用消息长度（含BoardLink的37/41字节控制块）分别测量两种模式，打印到标准输出
+void print_benchmark(uint32_t messages = 100);
+
+} // namespace HAL::CAN::TRANSPORT
+
+#endif // HAL_CAN_VIRTUAL
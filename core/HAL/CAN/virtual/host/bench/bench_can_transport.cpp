@@ -0,0 +1,17 @@
+// CAN分段传输在虚拟总线上的延迟与吞吐量（CAN/README.md中“分段传输”的性能表）
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../user/core/HAL/CAN/transport/can_transport_bench.hpp"
+
+int main()
+{
+    using namespace HAL::CAN::TRANSPORT;
+    print_benchmark();
+
+    // 两种模式下每条消息都必须完整收到
+    const BenchResult fast = run_benchmark(128, 20, Mode::Fast);
+    const BenchResult flow_control = run_benchmark(128, 20, Mode::FlowControl);
+    return fast.errors == 0 && fast.messages == 20 && flow_control.errors == 0 && flow_control.messages == 20 ? 0 : 1;
+}
+
+#endif // HAL_CAN_VIRTUAL
@@ -0,0 +1,11 @@
+// CRC单帧耗时（Alg/CRC/README.md中的性能表）；bench_crc_slice_by_4为同一文件按ALG_CRC_SLICE_BY_4=1编译
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../user/core/Alg/CRC/crc_bench.hpp"
+
+int main()
+{
+    return ALG::CHECKSUM::print_benchmark() ? 0 : 1;
+}
+
+#endif // HAL_CAN_VIRTUAL
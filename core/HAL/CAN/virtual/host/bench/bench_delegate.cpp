@@ -0,0 +1,18 @@
+// 接收回调分发开销：CallbackRegistry与std::vector<std::function>
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../user/core/HAL/DELEGATE/delegate_bench.hpp"
+
+int main()
+{
+    const uint8_t callbacks[] = {1, 4, 8};
+    bool ok = true;
+    for (uint8_t n : callbacks)
+    {
+        HAL::DELEGATE::LogDelegateBenchmark(1000000, n);
+        ok = ok && HAL::DELEGATE::RunDelegateBenchmark(1000, n).same_result;
+    }
+    return ok ? 0 : 1;
+}
+
+#endif // HAL_CAN_VIRTUAL
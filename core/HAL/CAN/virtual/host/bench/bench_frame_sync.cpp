@@ -0,0 +1,16 @@
+// 帧同步器吞吐量（BSP/Common/FrameSync/README.md中的性能表）
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../user/core/BSP/Common/FrameSync/FrameSync_bench.hpp"
+
+int main()
+{
+    BSP::FrameSync::print_benchmark();
+
+    // 完好的帧必须全部收到
+    const auto r = BSP::FrameSync::run_benchmark(BSP::FrameSync::BenchInput::Chunks, BSP::FrameSync::BenchCheck::Crc16,
+                                                 true, 2000, 1);
+    return r.received == r.good_frames ? 0 : 1;
+}
+
+#endif // HAL_CAN_VIRTUAL
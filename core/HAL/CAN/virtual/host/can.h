@@ -0,0 +1,51 @@
+/**
+ * @file can.h
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief PC端编译用的CAN外设声明（替代CubeMX生成的can.h）
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include "main.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 只保留CAN接口头文件用到的类型和常量，取值与STM32 HAL一致
+typedef struct
+{
+    uint32_t StdId;
+    uint32_t ExtId;
+    uint32_t IDE;
+    uint32_t RTR;
+    uint32_t DLC;
+    uint32_t Timestamp;
+    uint32_t FilterMatchIndex;
+} CAN_RxHeaderTypeDef;
+
+typedef struct
+{
+    void *Instance;
+    uint32_t ErrorCode;
+} CAN_HandleTypeDef;
+
+#define CAN_ID_STD 0x00000000U
+#define CAN_ID_EXT 0x00000004U
+#define CAN_RTR_DATA 0x00000000U
+#define CAN_RTR_REMOTE 0x00000002U
+#define CAN_RX_FIFO0 0x00000000U
+#define CAN_RX_FIFO1 0x00000001U
+#define CAN_FILTER_FIFO0 0x00000000U
+#define CAN_FILTER_FIFO1 0x00000001U
+
+extern CAN_HandleTypeDef hcan1;
+extern CAN_HandleTypeDef hcan2;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,29 @@
+/**
+ * @file cmsis_os.h
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief PC端编译用的CMSIS-RTOS声明
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    osOK = 0
+} osStatus;
+
+// PC端不推进仿真时钟，直接返回
+osStatus osDelay(uint32_t millisec);
+
+#ifdef __cplusplus
+}
+#endif
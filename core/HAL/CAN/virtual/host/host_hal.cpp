@@ -0,0 +1,62 @@
+// PC端的HAL/RTOS函数实现，只在定义HAL_CAN_VIRTUAL时编译
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../../../DWT/DWT.hpp"
+#include "../virtual_can.hpp"
+#include "cmsis_os.h"
+#include "tim.h"
+
+CAN_HandleTypeDef hcan1;
+CAN_HandleTypeDef hcan2;
+TIM_HandleTypeDef htim4;
+
+extern "C" uint32_t HAL_GetTick(void)
+{
+    return static_cast<uint32_t>(HAL::CAN::VirtualClock::now_ns() / 1000000);
+}
+
+// DWTimer只实现CAN驱动和电机使用的部分，周期计数由仿真时钟换算
+namespace HAL
+{
+DWTimer::DWTimer(uint32_t CPU_mHz) : CPU_Freq_mHz(CPU_mHz)
+{
+    Init();
+}
+
+void DWTimer::Init()
+{
+    CPU_FREQ_Hz = CPU_Freq_mHz * 1000000;
+    CPU_FREQ_Hz_ms = CPU_FREQ_Hz / 1000;
+    CPU_FREQ_Hz_us = CPU_FREQ_Hz / 1000000;
+    MakeReciprocal(CPU_FREQ_Hz_us, us_mult_, us_shift_);
+    MakeReciprocal(CPU_FREQ_Hz_ms, ms_mult_, ms_shift_);
+}
+
+// 仿真时钟不回绕，不需要节拍钩子维护基准
+void DWTimer::Tick()
+{
+}
+
+uint64_t DWTimer::GetCycles64()
+{
+    return HAL::CAN::VirtualClock::now_ns() * DWTimer::getInstance().GetCyclesPerUs() / 1000;
+}
+
+uint64_t DWTimer::GetTimeline_us()
+{
+    return HAL::CAN::VirtualClock::now_ns() / 1000;
+}
+
+uint32_t DWTimer::GetCycles()
+{
+    return static_cast<uint32_t>(GetCycles64());
+}
+} // namespace HAL
+
+extern "C" osStatus osDelay(uint32_t millisec)
+{
+    (void)millisec;
+    return osOK;
+}
+
+#endif // HAL_CAN_VIRTUAL
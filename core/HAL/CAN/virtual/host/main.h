@@ -0,0 +1,37 @@
+/**
+ * @file main.h
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief PC端编译用的main.h（替代CubeMX生成的main.h）
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 返回仿真时钟（毫秒），见virtual_can.hpp中的VirtualClock
+uint32_t HAL_GetTick(void);
+
+// 串口：只保留BSP头文件（HI12Base.hpp等）用到的类型和宏，PC端不收发数据
+typedef struct
+{
+    uint32_t ErrorCode;
+} UART_HandleTypeDef;
+
+#define RESET 0U
+#define UART_FLAG_ORE 0x00000008U
+#define __HAL_UART_GET_FLAG(handle, flag) ((void)(handle), RESET)
+#define __HAL_UART_CLEAR_OREFLAG(handle) ((void)(handle))
+#define HAL_UARTEx_ReceiveToIdle_DMA(handle, data, size) ((void)(handle), (void)(data), (void)(size))
+
+#ifdef __cplusplus
+}
+#endif
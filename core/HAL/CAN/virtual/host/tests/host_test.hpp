@@ -0,0 +1,67 @@
+/**
+ * @file host_test.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief PC端单元测试用的检查宏
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include <cmath>
+#include <cstdio>
+
+namespace HOST_TEST
+{
+inline int failures = 0;
+inline int checks = 0;
+
+// 测试结束时调用，打印结果并作为main()的返回值
+inline int report(const char *name)
+{
+    std::printf("%s: %d checks, %d failed\n", name, checks, failures);
+    return failures == 0 ? 0 : 1;
+}
+} // namespace HOST_TEST
+
+#define HOST_CHECK(cond)                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        ++HOST_TEST::checks;                                                                                           \
+        if (!(cond))                                                                                                   \
+        {                                                                                                              \
+            ++HOST_TEST::failures;                                                                                     \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);                                       \
+        }                                                                                                              \
+    } while (0)
+
+// 按整数比较并打印两边的值
+#define HOST_CHECK_EQ(a, b)                                                                                            \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        ++HOST_TEST::checks;                                                                                           \
+        const long long host_check_a = (long long)(a);                                                                 \
+        const long long host_check_b = (long long)(b);                                                                 \
+        if (host_check_a != host_check_b)                                                                              \
+        {                                                                                                              \
+            ++HOST_TEST::failures;                                                                                     \
+            std::printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, host_check_a,   \
+                        host_check_b);                                                                                 \
+        }                                                                                                              \
+    } while (0)
+
+#define HOST_CHECK_NEAR(a, b, eps)                                                                                     \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        ++HOST_TEST::checks;                                                                                           \
+        const double host_check_a = (double)(a);                                                                       \
+        const double host_check_b = (double)(b);                                                                       \
+        if (std::fabs(host_check_a - host_check_b) > (eps))                                                            \
+        {                                                                                                              \
+            ++HOST_TEST::failures;                                                                                     \
+            std::printf("%s:%d: CHECK_NEAR(%s, %s) failed: %g != %g\n", __FILE__, __LINE__, #a, #b, host_check_a,      \
+                        host_check_b);                                                                                 \
+        }                                                                                                              \
+    } while (0)
@@ -0,0 +1,261 @@
+// 过滤器规划：各机器人工程登记的ID集合、FIFO分配和过滤器组预算
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../user/core/HAL/CAN/impl/can_filter_planner.hpp"
+#include "host_test.hpp"
+
+using namespace HAL::CAN;
+using Mode = CanFilterPlanner::Mode;
+
+namespace
+{
+// 与board_default.hpp一致：CAN1使用过滤器组0~13，CAN2使用14~27
+constexpr uint8_t CAN1_FIRST_BANK = 0;
+constexpr uint8_t CAN2_FIRST_BANK = 14;
+constexpr uint8_t BANKS_PER_CAN = 14;
+
+constexpr uint8_t HIGH = 0;
+constexpr uint8_t LOW = 1;
+
+struct Id
+{
+    ID_t id;
+    bool is_extended;
+    uint8_t fifo;
+};
+
+// 帧ID在16位过滤器中的映像：STID[10:0] RTR IDE EXID[17:15]
+uint16_t image16(ID_t id, bool is_extended)
+{
+    return is_extended ? (uint16_t)(((id >> 18) << 5) | 0x8 | ((id >> 15) & 0x7)) : (uint16_t)(id << 5);
+}
+
+// 帧ID在32位过滤器中的映像：STID[10:0] EXID[17:0] IDE RTR 0
+uint32_t image32(ID_t id, bool is_extended)
+{
+    return is_extended ? ((id << 3) | 0x4) : (id << 21);
+}
+
+// 按HAL_CAN_ConfigFilter()写入FR1/FR2的方式和参考手册的匹配规则判断一个过滤器组是否放行
+bool bank_accepts(const CanFilterPlanner::Bank &bank, ID_t id, bool is_extended)
+{
+    if (bank.mode == Mode::List16 || bank.mode == Mode::Mask16)
+    {
+        const uint32_t fr1 = ((uint32_t)bank.mask_low << 16) | bank.id_low;
+        const uint32_t fr2 = ((uint32_t)bank.mask_high << 16) | bank.id_high;
+        const uint16_t image = image16(id, is_extended);
+        if (bank.mode == Mode::List16)
+        {
+            return image == (fr1 & 0xFFFF) || image == (fr1 >> 16) || image == (fr2 & 0xFFFF) || image == (fr2 >> 16);
+        }
+        return ((image ^ fr1) & (fr1 >> 16) & 0xFFFF) == 0 || ((image ^ fr2) & (fr2 >> 16) & 0xFFFF) == 0;
+    }
+
+    const uint32_t fr1 = ((uint32_t)bank.id_high << 16) | bank.id_low;
+    const uint32_t fr2 = ((uint32_t)bank.mask_high << 16) | bank.mask_low;
+    const uint32_t image = image32(id, is_extended);
+    if (bank.mode == Mode::List32)
+    {
+        return image == fr1 || image == fr2;
+    }
+    return ((image ^ fr1) & fr2) == 0;
+}
+
+// 放行该ID的过滤器组数，fifo_ok为所有放行的组是否都分到了期望的FIFO
+uint8_t accepting_banks(const CanFilterPlanner::Plan &plan, const Id &id, bool &fifo_ok)
+{
+    uint8_t n = 0;
+    fifo_ok = true;
+    for (uint8_t i = 0; i < plan.count; ++i)
+    {
+        if (bank_accepts(plan.banks[i], id.id, id.is_extended))
+        {
+            ++n;
+            fifo_ok = fifo_ok && plan.banks[i].fifo == id.fifo;
+        }
+    }
+    return n;
+}
+
+template <uint8_t N> bool build(const Id (&ids)[N], uint8_t first_bank, CanFilterPlanner::Plan &plan)
+{
+    CanFilterPlanner planner;
+    for (const Id &id : ids)
+    {
+        HOST_CHECK(planner.add(id.id, id.is_extended, id.fifo));
+    }
+    return planner.build(first_bank, BANKS_PER_CAN, plan);
+}
+
+// 每个登记的ID都被放行且进入登记时的FIFO，组数和编号在本CAN的范围内
+template <uint8_t N> void check_plan(const Id (&ids)[N], uint8_t first_bank, const CanFilterPlanner::Plan &plan)
+{
+    HOST_CHECK(!plan.accept_all);
+    HOST_CHECK(plan.count <= BANKS_PER_CAN);
+    for (uint8_t i = 0; i < plan.count; ++i)
+    {
+        HOST_CHECK_EQ(plan.banks[i].bank, first_bank + i);
+    }
+    for (const Id &id : ids)
+    {
+        bool fifo_ok = false;
+        HOST_CHECK(accepting_banks(plan, id, fifo_ok) > 0);
+        HOST_CHECK(fifo_ok);
+    }
+}
+
+void check_rejects(const CanFilterPlanner::Plan &plan, ID_t id, bool is_extended)
+{
+    bool fifo_ok = false;
+    HOST_CHECK_EQ(accepting_banks(plan, {id, is_extended, HIGH}, fifo_ok), 0);
+}
+
+void check_list16(const CanFilterPlanner::Bank &bank, uint8_t fifo, ID_t a, ID_t b, ID_t c, ID_t d)
+{
+    HOST_CHECK(bank.mode == Mode::List16);
+    HOST_CHECK_EQ(bank.fifo, fifo);
+    HOST_CHECK_EQ(bank.id_low, a << 5);
+    HOST_CHECK_EQ(bank.id_high, b << 5);
+    HOST_CHECK_EQ(bank.mask_low, c << 5);
+    HOST_CHECK_EQ(bank.mask_high, d << 5);
+}
+
+// InfantryOmni-No2云台板（C板）与InfantryOmni-No1底盘板（A板）的MotorTask.cpp登记相同的电机：
+// CAN1：GM3508<4>(0x200, {1, 4}) -> 0x201/0x204，GM6020<1>(0x204, {2}) -> 0x206，GM2006<1>(0x200, {5}) -> 0x205
+// CAN2：J4310<1>(0x00, {2}) -> 0x002（LK4005未接入CAN回调，不登记）
+void test_infantry_boards()
+{
+    const Id can1_ids[] = {{0x201, false, HIGH}, {0x204, false, HIGH}, {0x206, false, HIGH}, {0x205, false, HIGH}};
+    const Id can2_ids[] = {{0x002, false, HIGH}};
+
+    CanFilterPlanner::Plan plan;
+    HOST_CHECK(build(can1_ids, CAN1_FIRST_BANK, plan));
+    check_plan(can1_ids, CAN1_FIRST_BANK, plan);
+    HOST_CHECK_EQ(plan.count, 1);
+    HOST_CHECK_EQ(plan.merged, 0);
+    HOST_CHECK(plan.uses_fifo[0] && !plan.uses_fifo[1]);
+    check_list16(plan.banks[0], HIGH, 0x201, 0x204, 0x206, 0x205);
+    check_rejects(plan, 0x202, false);
+    check_rejects(plan, 0x203, false);
+    check_rejects(plan, 0x201, true);
+
+    HOST_CHECK(build(can2_ids, CAN2_FIRST_BANK, plan));
+    check_plan(can2_ids, CAN2_FIRST_BANK, plan);
+    HOST_CHECK_EQ(plan.count, 1);
+    HOST_CHECK_EQ(plan.banks[0].bank, 14);
+    // 不足4个ID时重复最后一个填充
+    check_list16(plan.banks[0], HIGH, 0x002, 0x002, 0x002, 0x002);
+    check_rejects(plan, 0x001, false);
+}
+
+// Drone：CAN1为GM6020<1>(0x204, {2}) -> 0x206，CAN2为J4310<1>(0x04, {1}) -> 0x005
+void test_drone()
+{
+    const Id can1_ids[] = {{0x206, false, HIGH}};
+    const Id can2_ids[] = {{0x005, false, HIGH}};
+
+    CanFilterPlanner::Plan plan;
+    HOST_CHECK(build(can1_ids, CAN1_FIRST_BANK, plan));
+    check_plan(can1_ids, CAN1_FIRST_BANK, plan);
+    HOST_CHECK_EQ(plan.count, 1);
+    check_list16(plan.banks[0], HIGH, 0x206, 0x206, 0x206, 0x206);
+    check_rejects(plan, 0x205, false);
+
+    HOST_CHECK(build(can2_ids, CAN2_FIRST_BANK, plan));
+    check_plan(can2_ids, CAN2_FIRST_BANK, plan);
+    HOST_CHECK_EQ(plan.count, 1);
+    check_list16(plan.banks[0], HIGH, 0x005, 0x005, 0x005, 0x005);
+}
+
+// 云台板CAN1再接入板间链路（CanTransport）和对时（CanTimeSync），两者按默认的低优先级登记
+void test_fifo_split()
+{
+    const Id can1_ids[] = {{0x201, false, HIGH}, {0x204, false, HIGH}, {0x206, false, HIGH},
+                           {0x205, false, HIGH}, {0x310, false, LOW},  {0x320, false, LOW}};
+
+    CanFilterPlanner::Plan plan;
+    HOST_CHECK(build(can1_ids, CAN1_FIRST_BANK, plan));
+    check_plan(can1_ids, CAN1_FIRST_BANK, plan);
+    HOST_CHECK_EQ(plan.count, 2);
+    HOST_CHECK(plan.uses_fifo[0] && plan.uses_fifo[1]);
+    check_list16(plan.banks[0], HIGH, 0x201, 0x204, 0x206, 0x205);
+    check_list16(plan.banks[1], LOW, 0x310, 0x320, 0x320, 0x320);
+}
+
+// ID多于14组列表能容纳时合并为掩码，组数不超过预算，登记的ID仍全部放行
+void test_bank_budget()
+{
+    Id ids[CanFilterPlanner::MAX_IDS];
+    uint8_t n = 0;
+    const ID_t motor_ids[] = {0x201, 0x204, 0x206, 0x205};
+    for (ID_t id : motor_ids)
+    {
+        ids[n++] = {id, false, HIGH};
+    }
+    // 低优先级标准帧：40个需要10组列表
+    for (uint8_t i = 0; i < 40; ++i)
+    {
+        ids[n++] = {(ID_t)(0x400 + i * 5), false, LOW};
+    }
+    // 扩展帧：4个需要2组列表
+    for (uint8_t i = 0; i < 4; ++i)
+    {
+        ids[n++] = {(ID_t)(0x18FF5000 + i * 0x11), true, LOW};
+    }
+    HOST_CHECK_EQ(n, CanFilterPlanner::MAX_IDS);
+
+    CanFilterPlanner planner;
+    for (uint8_t i = 0; i < n; ++i)
+    {
+        HOST_CHECK(planner.add(ids[i].id, ids[i].is_extended, ids[i].fifo));
+    }
+    HOST_CHECK(!planner.add(0x7FF, false, LOW));
+    // 重复登记不占位置
+    HOST_CHECK(planner.add(0x201, false, HIGH));
+
+    CanFilterPlanner::Plan plan;
+    HOST_CHECK(planner.build(CAN2_FIRST_BANK, BANKS_PER_CAN, plan));
+    check_plan(ids, CAN2_FIRST_BANK, plan);
+    HOST_CHECK_EQ(plan.count, 13);
+    HOST_CHECK_EQ(plan.merged, 0);
+
+    // 预算减少到4组时必须合并出掩码组
+    HOST_CHECK(planner.build(CAN2_FIRST_BANK, 4, plan));
+    check_plan(ids, CAN2_FIRST_BANK, plan);
+    HOST_CHECK(plan.count <= 4);
+    HOST_CHECK(plan.merged > 0);
+    bool has_mask16 = false;
+    bool has_mask32 = false;
+    for (uint8_t i = 0; i < plan.count; ++i)
+    {
+        has_mask16 = has_mask16 || plan.banks[i].mode == Mode::Mask16;
+        has_mask32 = has_mask32 || plan.banks[i].mode == Mode::Mask32;
+        // 掩码同时匹配IDE位：标准帧的掩码组不放行扩展帧
+        if (plan.banks[i].mode == Mode::Mask16)
+        {
+            HOST_CHECK(!bank_accepts(plan.banks[i], 0x201, true));
+        }
+    }
+    HOST_CHECK(has_mask16);
+    HOST_CHECK(has_mask32);
+
+    HOST_CHECK(!planner.build(CAN2_FIRST_BANK, 0, plan));
+
+    // 未登记任何ID时全部接收
+    CanFilterPlanner empty;
+    HOST_CHECK(empty.build(CAN1_FIRST_BANK, BANKS_PER_CAN, plan));
+    HOST_CHECK(plan.accept_all);
+    HOST_CHECK_EQ(plan.count, 0);
+}
+} // namespace
+
+int main()
+{
+    test_infantry_boards();
+    test_drone();
+    test_fifo_split();
+    test_bank_budget();
+    return HOST_TEST::report("test_can_filter_planner");
+}
+
+#endif // HAL_CAN_VIRTUAL
@@ -0,0 +1,87 @@
+// CAN对时：请求方时钟有固定偏移和50 ppm漂移，应答方使用DWT时间轴；长时间不调用poll()后仍保持同步
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../user/core/HAL/CAN/timesync/can_time_sync.hpp"
+#include "../user/core/HAL/CAN/virtual/virtual_can.hpp"
+#include "../user/core/HAL/DWT/DWT.hpp"
+#include "host_test.hpp"
+
+using namespace HAL::CAN;
+using namespace HAL::CAN::TIMESYNC;
+
+namespace
+{
+constexpr int64_t CLIENT_OFFSET_US = 123456;
+
+// 请求方本地时钟：比仿真时钟快50 ppm
+uint64_t client_clock()
+{
+    const uint64_t t = VirtualClock::now_us();
+    return t + t / 20000 + CLIENT_OFFSET_US;
+}
+
+CanTimeSync client(0x320, 0x321, 100, client_clock);
+CanTimeSync server(0x321, 0x320, 0);
+
+void run_ms(VirtualCanBus &bus, ICanDevice &local, ICanDevice &peer, uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms * 10; ++i)
+    {
+        bus.run_for_us(100);
+        local.drain_rx();
+        peer.drain_rx();
+        client.poll();
+        server.poll();
+    }
+}
+
+// 应答方时间（即仿真时钟）的估计误差
+int64_t remote_error_us()
+{
+    return (int64_t)client.to_remote_time(client.local_time_us()) - (int64_t)server.local_time_us();
+}
+
+void test_sync(VirtualCanBus &bus, ICanDevice &local, ICanDevice &peer)
+{
+    HOST_CHECK(!client.synced());
+    run_ms(bus, local, peer, 5000);
+    HOST_CHECK(client.synced());
+    HOST_CHECK(client.get_stats().responses > 0);
+    // 最后一个请求可能还在途中
+    HOST_CHECK(server.get_stats().answered + 1 >= client.get_stats().requests);
+    HOST_CHECK(remote_error_us() >= -20 && remote_error_us() <= 20);
+    HOST_CHECK_NEAR(client.drift_ppm(), -50.0, 10.0);
+
+    // 应答方的本地时间就是DWT时间轴
+    HOST_CHECK_EQ(server.local_time_us(), HAL::DWTimer::GetTimeline_us());
+}
+
+// 两块板都超过一次CYCCNT回绕（168 MHz下约25.6秒）没有调用poll()，本地时间不丢失回绕
+void test_long_gap(VirtualCanBus &bus, ICanDevice &local, ICanDevice &peer)
+{
+    const uint32_t resets = client.get_stats().resets;
+    VirtualClock::set_ns(VirtualClock::now_ns() + 30ull * 1000000000);
+    HOST_CHECK_EQ(server.local_time_us(), VirtualClock::now_us());
+
+    run_ms(bus, local, peer, 2000);
+    HOST_CHECK(client.synced());
+    HOST_CHECK_EQ(client.get_stats().resets, resets);
+    HOST_CHECK(remote_error_us() >= -20 && remote_error_us() <= 20);
+}
+} // namespace
+
+int main()
+{
+    auto &bus = VirtualCanBus::instance();
+    auto &local = bus.get_device(CanDeviceId::HAL_Can2);
+    auto &peer = bus.peer(CanDeviceId::HAL_Can2);
+
+    HOST_CHECK(client.start(local));
+    HOST_CHECK(server.start(peer));
+
+    test_sync(bus, local, peer);
+    test_long_gap(bus, local, peer);
+    return HOST_TEST::report("test_can_time_sync");
+}
+
+#endif // HAL_CAN_VIRTUAL
@@ -0,0 +1,247 @@
+// CAN抓包往返：虚拟总线上记录 → read()导出 → 回放，帧内容、总线编号和时间戳不变，倍速回放的节奏正确
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../user/core/HAL/CAN/trace/can_trace_recorder.hpp"
+#include "../user/core/HAL/CAN/trace/can_trace_replayer.hpp"
+#include "../user/core/HAL/CAN/virtual/virtual_can.hpp"
+#include "host_test.hpp"
+#include <chrono>
+#include <cstring>
+
+using namespace HAL::CAN;
+using namespace HAL::CAN::TRACE;
+
+namespace
+{
+constexpr uint8_t MAX_CAPTURED = 8;
+constexpr uint8_t CAN1 = (uint8_t)CanDeviceId::HAL_Can1;
+constexpr uint8_t CAN2 = (uint8_t)CanDeviceId::HAL_Can2;
+// 超过2^32微秒（约72分钟）的空闲，时间差的varint为5字节
+constexpr uint64_t LONG_GAP_US = 5000000000ull;
+
+struct Captured
+{
+    uint8_t bus;
+    Frame frame;
+    uint64_t clock_ns;                               // 回调时的仿真时钟
+    std::chrono::steady_clock::time_point wall_time; // 回调时的真实时间
+};
+
+Captured captured[MAX_CAPTURED];
+uint8_t captured_count = 0;
+bool capturing = false;
+
+uint8_t trace[HAL_CAN_TRACE_BUFFER_SIZE];
+size_t trace_size = 0;
+
+void capture(uint8_t bus, const Frame &frame)
+{
+    if (capturing && captured_count < MAX_CAPTURED)
+    {
+        captured[captured_count++] = {bus, frame, VirtualClock::now_ns(), std::chrono::steady_clock::now()};
+    }
+}
+
+void advance_us(uint64_t us)
+{
+    VirtualClock::set_ns(VirtualClock::now_ns() + us * 1000);
+}
+
+bool same_frame(const Frame &a, const Frame &b)
+{
+    return a.id == b.id && a.is_extended_id == b.is_extended_id && a.is_remote_frame == b.is_remote_frame &&
+           a.dlc == b.dlc && (a.is_remote_frame || memcmp(a.data, b.data, a.dlc) == 0);
+}
+
+// 停止记录并导出全部数据
+void finish_trace()
+{
+    auto &recorder = CanTraceRecorder::instance();
+    recorder.stop();
+    trace_size = recorder.read(trace, sizeof(trace));
+    HOST_CHECK_EQ(recorder.get_stats().pending, 0);
+    HOST_CHECK_EQ(recorder.get_stats().dropped, 0);
+}
+
+// 记录的各帧及其相对于start()的时刻（微秒）；接收帧的时刻由总线决定，记为0并单独检查
+Frame sent[4];
+uint64_t sent_at_us[4];
+
+void record_frames(VirtualCanBus &bus, ICanDevice &can1, ICanDevice &can2)
+{
+    auto &recorder = CanTraceRecorder::instance();
+    recorder.start();
+    HOST_CHECK_EQ(recorder.clock_hz(), 1000000);
+
+    // 标准数据帧，CAN1发送
+    advance_us(100);
+    sent[0] = Frame::make(0x123, 8);
+    sent[0].put_u64(0x0807060504030201ull);
+    sent_at_us[0] = 100;
+    HOST_CHECK(can1.send(sent[0]));
+    bus.run_for_us(400);
+
+    // 扩展帧，CAN2发送
+    sent[1] = Frame::make(0x1ABCDE01, 3, true);
+    sent[1].data[0] = 0xA5;
+    sent[1].data[1] = 0x5A;
+    sent[1].data[2] = 0xFF;
+    sent_at_us[1] = 500;
+    HOST_CHECK(can2.send(sent[1]));
+    bus.run_for_us(500);
+
+    // 远程帧，对端发送、CAN1接收
+    sent[2] = Frame::make(0x456, 2);
+    sent[2].is_remote_frame = 1;
+    sent_at_us[2] = 0;
+    HOST_CHECK(bus.peer(CanDeviceId::HAL_Can1).send(sent[2]));
+    bus.run_for_us(500);
+
+    // 长时间空闲后CAN1再发送一帧
+    advance_us(LONG_GAP_US);
+    sent[3] = Frame::make(0x124, 1);
+    sent[3].data[0] = 0x42;
+    sent_at_us[3] = 1500 + LONG_GAP_US;
+    HOST_CHECK(can1.send(sent[3]));
+    bus.run_for_us(500);
+
+    finish_trace();
+    HOST_CHECK_EQ(recorder.get_stats().recorded, 4);
+}
+
+// 读出的记录与发送的帧、总线编号和时间戳一致
+void test_read_back()
+{
+    CanTraceReader reader;
+    HOST_CHECK(reader.open(trace, trace_size));
+    HOST_CHECK_EQ(reader.clock_hz(), 1000000);
+
+    const uint8_t expected_bus[] = {CAN1, CAN2, CAN1, CAN1};
+    const bool expected_tx[] = {true, true, false, true};
+    Record record;
+    uint8_t count = 0;
+    while (reader.next(record) && count < 4)
+    {
+        HOST_CHECK(same_frame(record.frame, sent[count]));
+        HOST_CHECK_EQ(record.bus, expected_bus[count]);
+        HOST_CHECK_EQ(record.is_tx, expected_tx[count]);
+        if (expected_tx[count])
+        {
+            HOST_CHECK_EQ(record.timestamp, sent_at_us[count]);
+        }
+        else
+        {
+            // 1000 us时进入对端邮箱，一帧远程帧在1 Mbps下不到100 us
+            HOST_CHECK(record.timestamp > 1000 && record.timestamp < 1200);
+        }
+        ++count;
+    }
+    HOST_CHECK_EQ(count, 4);
+    HOST_CHECK(!reader.next(record));
+    HOST_CHECK(!reader.truncated());
+
+    // 文件头 + 各记录（时间差、标志/总线、ID、数据）：扩展ID占4字节，远程帧不带数据，长时间差的varint占5字节
+    HOST_CHECK_EQ(trace_size, 16 + (1 + 2 + 2 + 8) + (2 + 2 + 4 + 3) + (2 + 2 + 2) + (5 + 2 + 2 + 1));
+}
+
+// run_until()按记录的时刻回放到原来的总线，仿真时钟与记录时的相对时间一致
+void test_replay(ICanDevice &can1, ICanDevice &can2)
+{
+    CanTraceReplayer replayer;
+    HOST_CHECK(replayer.open(trace, trace_size));
+    replayer.attach(CAN1, &can1);
+    replayer.attach(CAN2, &can2);
+    replayer.set_include_tx(true);
+    const uint64_t base_ns = VirtualClock::now_ns();
+
+    captured_count = 0;
+    capturing = true;
+    HOST_CHECK_EQ(replayer.run_until(2000000), 3);
+    HOST_CHECK_EQ(captured_count, 3);
+    HOST_CHECK_EQ(replayer.run_all(), 1);
+    capturing = false;
+
+    HOST_CHECK_EQ(captured_count, 4);
+    const uint8_t expected_bus[] = {CAN1, CAN2, CAN1, CAN1};
+    for (uint8_t i = 0; i < 4 && i < captured_count; ++i)
+    {
+        HOST_CHECK(same_frame(captured[i].frame, sent[i]));
+        HOST_CHECK_EQ(captured[i].bus, expected_bus[i]);
+        if (sent_at_us[i] != 0)
+        {
+            HOST_CHECK_EQ(captured[i].clock_ns - base_ns, sent_at_us[i] * 1000);
+        }
+    }
+
+    // 默认跳过发送帧，只回放接收的远程帧
+    CanTraceReplayer rx_only;
+    HOST_CHECK(rx_only.open(trace, trace_size));
+    rx_only.attach(CAN1, &can1);
+    rx_only.attach(CAN2, &can2);
+    HOST_CHECK_EQ(rx_only.run_all(), 1);
+}
+
+// 每20 ms一帧，4倍速回放时相邻两帧间隔5 ms
+void test_realtime(VirtualCanBus &bus, ICanDevice &can1, ICanDevice &can2)
+{
+    CanTraceRecorder::instance().start();
+    for (uint8_t i = 0; i < 3; ++i)
+    {
+        Frame frame = Frame::make(0x200, 1);
+        frame.data[0] = i;
+        HOST_CHECK(can1.send(frame));
+        bus.run_for_us(20000);
+    }
+    finish_trace();
+
+    CanTraceReplayer replayer;
+    HOST_CHECK(replayer.open(trace, trace_size));
+    replayer.attach(CAN1, &can1);
+    replayer.attach(CAN2, &can2);
+    replayer.set_include_tx(true);
+
+    captured_count = 0;
+    capturing = true;
+    HOST_CHECK_EQ(replayer.run_realtime(4.0f), 3);
+    capturing = false;
+
+    HOST_CHECK_EQ(captured_count, 3);
+    for (uint8_t i = 1; i < 3 && i < captured_count; ++i)
+    {
+        const auto wall_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(captured[i].wall_time - captured[i - 1].wall_time)
+                .count();
+        // sleep_until()不会提前返回，上限留出调度余量
+        HOST_CHECK(wall_us >= 4900 && wall_us < 20000);
+        HOST_CHECK_EQ(captured[i].clock_ns - captured[i - 1].clock_ns, 20000000);
+        HOST_CHECK_EQ(captured[i].frame.data[0], i);
+    }
+}
+
+void capture_can1(const Frame &frame)
+{
+    capture(CAN1, frame);
+}
+
+void capture_can2(const Frame &frame)
+{
+    capture(CAN2, frame);
+}
+} // namespace
+
+int main()
+{
+    auto &bus = VirtualCanBus::instance();
+    auto &can1 = bus.get_device(CanDeviceId::HAL_Can1);
+    auto &can2 = bus.get_device(CanDeviceId::HAL_Can2);
+    HOST_CHECK(can1.register_rx_callback(capture_can1));
+    HOST_CHECK(can2.register_rx_callback(capture_can2));
+
+    record_frames(bus, can1, can2);
+    test_read_back();
+    test_replay(can1, can2);
+    test_realtime(bus, can1, can2);
+    return HOST_TEST::report("test_can_trace");
+}
+
+#endif // HAL_CAN_VIRTUAL
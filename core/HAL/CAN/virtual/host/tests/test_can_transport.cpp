@@ -0,0 +1,107 @@
+// CAN分段传输：正常收发，连续帧无法进入发送队列时的发送超时
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../user/core/HAL/CAN/transport/can_transport.hpp"
+#include "../user/core/HAL/CAN/virtual/virtual_can.hpp"
+#include "host_test.hpp"
+#include <cstring>
+
+using namespace HAL::CAN;
+using namespace HAL::CAN::TRANSPORT;
+
+namespace
+{
+CanTransport sender(0x310, 0x311, Mode::Fast);
+CanTransport receiver(0x311, 0x310, Mode::Fast);
+
+uint8_t message[HAL_CAN_TRANSPORT_MAX_PAYLOAD];
+uint32_t received = 0;
+bool received_match = false;
+
+void step(VirtualCanBus &bus, ICanDevice &local, ICanDevice &peer, uint32_t us)
+{
+    bus.run_for_us(us);
+    local.drain_rx();
+    peer.drain_rx();
+    sender.poll();
+    receiver.poll();
+}
+
+// 总线正常时整条消息在超时之前发完
+void test_send(VirtualCanBus &bus, ICanDevice &local, ICanDevice &peer)
+{
+    HOST_CHECK(sender.send(message, sizeof(message)));
+    for (uint32_t i = 0; i < 1000 && received == 0; ++i)
+    {
+        step(bus, local, peer, 10);
+    }
+    HOST_CHECK_EQ(received, 1);
+    HOST_CHECK(received_match);
+    HOST_CHECK(!sender.tx_busy());
+    HOST_CHECK_EQ(sender.get_stats().tx_messages, 1);
+    HOST_CHECK_EQ(sender.get_stats().tx_timeouts, 0);
+}
+
+// 总线不发送（邮箱和发送队列都满）时，poll()在超时后放弃消息
+void test_send_timeout(VirtualCanBus &bus, ICanDevice &local, ICanDevice &peer)
+{
+    HOST_CHECK(sender.send(message, sizeof(message)));
+    sender.poll();
+    HOST_CHECK(sender.tx_busy());
+
+    // 只推进时钟，不运行总线
+    VirtualClock::set_ns(VirtualClock::now_ns() + (uint64_t)HAL_CAN_TRANSPORT_TIMEOUT_MS * 1000000 / 2);
+    sender.poll();
+    HOST_CHECK(sender.tx_busy());
+    HOST_CHECK_EQ(sender.get_stats().tx_timeouts, 0);
+
+    VirtualClock::set_ns(VirtualClock::now_ns() + (uint64_t)HAL_CAN_TRANSPORT_TIMEOUT_MS * 1000000);
+    sender.poll();
+    HOST_CHECK(!sender.tx_busy());
+    HOST_CHECK_EQ(sender.get_stats().tx_timeouts, 1);
+    HOST_CHECK_EQ(sender.get_stats().tx_messages, 1);
+
+    // 已进入队列的帧发出后，接收方等不到剩余的连续帧，同样超时丢弃
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        step(bus, local, peer, 500);
+    }
+    HOST_CHECK_EQ(received, 1);
+    HOST_CHECK_EQ(receiver.get_stats().rx_timeouts, 1);
+
+    // 之后可以正常发送
+    received_match = false;
+    HOST_CHECK(sender.send(message, sizeof(message)));
+    for (uint32_t i = 0; i < 1000 && received == 1; ++i)
+    {
+        step(bus, local, peer, 10);
+    }
+    HOST_CHECK_EQ(received, 2);
+    HOST_CHECK(received_match);
+    HOST_CHECK_EQ(sender.get_stats().tx_timeouts, 1);
+}
+} // namespace
+
+int main()
+{
+    auto &bus = VirtualCanBus::instance();
+    auto &local = bus.get_device(CanDeviceId::HAL_Can2);
+    auto &peer = bus.peer(CanDeviceId::HAL_Can2);
+
+    for (uint16_t i = 0; i < sizeof(message); ++i)
+    {
+        message[i] = (uint8_t)(i * 7 + 1);
+    }
+    HOST_CHECK(sender.start(local));
+    HOST_CHECK(receiver.start(peer));
+    receiver.set_rx_handler([](const uint8_t *data, uint16_t size) {
+        ++received;
+        received_match = size == sizeof(message) && std::memcmp(data, message, size) == 0;
+    });
+
+    test_send(bus, local, peer);
+    test_send_timeout(bus, local, peer);
+    return HOST_TEST::report("test_can_transport");
+}
+
+#endif // HAL_CAN_VIRTUAL
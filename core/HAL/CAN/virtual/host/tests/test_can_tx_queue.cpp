@@ -0,0 +1,71 @@
+// CAN发送队列：高优先级队首因同ID帧仍在邮箱中而等待时，低优先级的帧不能先占用空出的邮箱
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../user/core/HAL/CAN/virtual/virtual_can.hpp"
+#include "host_test.hpp"
+
+using namespace HAL::CAN;
+
+namespace
+{
+constexpr uint8_t MAX_RECEIVED = 8;
+
+Frame received[MAX_RECEIVED];
+uint8_t received_count = 0;
+
+void on_frame(const Frame &frame)
+{
+    if (received_count < MAX_RECEIVED)
+    {
+        received[received_count++] = frame;
+    }
+}
+
+Frame make_frame(ID_t id, uint8_t tag)
+{
+    Frame frame = Frame::make(id, 1);
+    frame.data[0] = tag;
+    return frame;
+}
+
+void test_priority_kept(VirtualCanBus &bus, ICanDevice &local, ICanDevice &peer)
+{
+    // 三个邮箱分别为0x050、0x100（第1帧）、0x060
+    HOST_CHECK(local.send(make_frame(0x050, 0)));
+    HOST_CHECK(local.send(make_frame(0x100, 1)));
+    HOST_CHECK(local.send(make_frame(0x060, 0)));
+
+    // 邮箱已满，控制帧0x100（第2帧）和普通帧0x070进入队列
+    HOST_CHECK(local.send(make_frame(0x100, 2), TxPriority::Control));
+    HOST_CHECK(local.send(make_frame(0x070, 0), TxPriority::Normal));
+
+    bus.run_for_us(2000);
+    peer.drain_rx();
+
+    // 0x050发完后控制队首仍被邮箱中的0x100挡住，空出的邮箱不给普通帧；
+    // 第1帧0x100发完后两帧一起进入邮箱，0x070按仲裁先发
+    const ID_t expected_id[] = {0x050, 0x060, 0x100, 0x070, 0x100};
+    const uint8_t expected_tag[] = {0, 0, 1, 0, 2};
+    HOST_CHECK_EQ(received_count, 5);
+    for (uint8_t i = 0; i < 5 && i < received_count; ++i)
+    {
+        HOST_CHECK_EQ(received[i].id, expected_id[i]);
+        HOST_CHECK_EQ(received[i].data[0], expected_tag[i]);
+    }
+    HOST_CHECK_EQ(local.get_tx_queue_stats(TxPriority::Control).depth, 0);
+    HOST_CHECK_EQ(local.get_tx_queue_stats(TxPriority::Normal).depth, 0);
+}
+} // namespace
+
+int main()
+{
+    auto &bus = VirtualCanBus::instance();
+    auto &local = bus.get_device(CanDeviceId::HAL_Can1);
+    auto &peer = bus.peer(CanDeviceId::HAL_Can1);
+    HOST_CHECK(peer.register_rx_callback(on_frame));
+
+    test_priority_kept(bus, local, peer);
+    return HOST_TEST::report("test_can_tx_queue");
+}
+
+#endif // HAL_CAN_VIRTUAL
@@ -0,0 +1,89 @@
+// CRC：标准校验值，随机长度、对齐和切分下的增量计算与逐位实现比较；test_crc_slice_by_4按ALG_CRC_SLICE_BY_4=1编译
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../user/core/Alg/CRC/crc.hpp"
+#include "host_test.hpp"
+
+using namespace ALG::CHECKSUM;
+
+namespace
+{
+uint32_t random_state = 3;
+
+// 固定种子的xorshift32
+uint32_t random_next()
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+uint8_t data[1024];
+
+void test_check_values()
+{
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    HOST_CHECK_EQ(crc8(check, sizeof(check)), 0x0B);
+    HOST_CHECK_EQ(crc16(check, sizeof(check)), 0x6F91);
+    HOST_CHECK_EQ(crc16_ccitt(check, sizeof(check)), 0x31C3);
+    HOST_CHECK_EQ(crc32(check, sizeof(check)), 0x0376E6E7);
+}
+
+// 分两段增量计算，与一次逐位计算的结果比较
+void test_random_splits()
+{
+    uint32_t mismatches = 0;
+    for (uint32_t k = 0; k < 20000; ++k)
+    {
+        const size_t size = random_next() % 300;
+        const uint8_t *p = data + random_next() % 512;
+        const size_t cut = size == 0 ? 0 : random_next() % (size + 1);
+
+        const uint8_t c8 = crc8_update(crc8_update(CRC8_INIT, p, cut), p + cut, size - cut);
+        const uint16_t c16 = crc16_update(crc16_update(CRC16_INIT, p, cut), p + cut, size - cut);
+        const uint16_t ccitt = crc16_ccitt_update(crc16_ccitt_update(CRC16_CCITT_INIT, p, cut), p + cut, size - cut);
+        const uint32_t c32 = crc32_update(crc32_update(CRC32_INIT, p, cut), p + cut, size - cut);
+
+        mismatches += c8 != detail::reflected_bitwise<uint8_t>(CRC8_INIT, 0x8C, p, size);
+        mismatches += c16 != detail::reflected_bitwise<uint16_t>(CRC16_INIT, 0x8408, p, size);
+        mismatches += ccitt != detail::crc16_ccitt_bitwise(CRC16_CCITT_INIT, p, size);
+        mismatches += c32 != detail::crc32_bitwise(CRC32_INIT, p, size);
+    }
+    HOST_CHECK_EQ(mismatches, 0);
+}
+
+// 裁判系统帧：帧头CRC8与整帧CRC16写入后校验通过，改动1位后校验失败
+void test_append_verify()
+{
+    uint8_t frame[22] = {0xA5, 13, 0, 1};
+    append_crc8(frame, 5);
+    for (uint8_t i = 5; i < 20; ++i)
+    {
+        frame[i] = i;
+    }
+    append_crc16(frame, sizeof(frame));
+    HOST_CHECK(verify_crc8(frame, 5));
+    HOST_CHECK(verify_crc16(frame, sizeof(frame)));
+
+    frame[10] ^= 0x10;
+    HOST_CHECK(verify_crc8(frame, 5));
+    HOST_CHECK(!verify_crc16(frame, sizeof(frame)));
+    HOST_CHECK(!verify_crc8(frame, 1));
+    HOST_CHECK(!verify_crc16(frame, 2));
+}
+} // namespace
+
+int main()
+{
+    for (uint8_t &byte : data)
+    {
+        byte = (uint8_t)random_next();
+    }
+    test_check_values();
+    test_random_splits();
+    test_append_verify();
+    return HOST_TEST::report(ALG_CRC_SLICE_BY_4 ? "test_crc_slice_by_4" : "test_crc");
+}
+
+#endif // HAL_CAN_VIRTUAL
@@ -0,0 +1,220 @@
+// DJI电机在虚拟CAN上的反馈解析与控制帧合成
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../user/core/BSP/Motor/Dji/DjiMotor.hpp"
+#include "../user/core/HAL/CAN/virtual/virtual_can.hpp"
+#include "host_test.hpp"
+
+using namespace HAL::CAN;
+
+namespace
+{
+// 底盘4个3508走0x200，云台两个6020与拨弹3508（电调ID 7）共用0x1FF
+BSP::Motor::Dji::GM3508<2> chassis(0x200, {1, 2}, 0x200);
+BSP::Motor::Dji::GM6020<2> gimbal(0x204, {1, 2}, 0x1FF);
+BSP::Motor::Dji::GM3508<1> loader(0x200, {7}, 0x200);
+// 底盘后两个3508单独一个对象，与chassis共用0x200
+BSP::Motor::Dji::GM3508<2> chassis_rear(0x200, {3, 4}, 0x200);
+// 不注册到路由表，直接调用Parse()
+BSP::Motor::Dji::GM6020<1> spare(0x204, {4}, 0x1FF);
+
+constexpr uint8_t MAX_CAPTURED = 16;
+Frame captured[MAX_CAPTURED];
+uint8_t captured_count = 0;
+
+void capture(const Frame &frame)
+{
+    if (captured_count < MAX_CAPTURED)
+    {
+        captured[captured_count++] = frame;
+    }
+}
+
+Frame feedback(ID_t id, int16_t angle, int16_t velocity, int16_t current, uint8_t temperature)
+{
+    Frame frame = Frame::make(id);
+    frame.put_u16_be(0, (uint16_t)angle);
+    frame.put_u16_be(2, (uint16_t)velocity);
+    frame.put_u16_be(4, (uint16_t)current);
+    frame.data[6] = temperature;
+    return frame;
+}
+
+int16_t slot_value(const Frame &frame, uint8_t slot)
+{
+    return (int16_t)((frame.data[(slot - 1) * 2] << 8) | frame.data[(slot - 1) * 2 + 1]);
+}
+
+const Frame *find_captured(ID_t id)
+{
+    for (uint8_t i = 0; i < captured_count; ++i)
+    {
+        if (captured[i].id == id)
+        {
+            return &captured[i];
+        }
+    }
+    return nullptr;
+}
+
+void test_feedback(VirtualCanBus &bus, ICanDevice &can1, VirtualCanDevice &peer)
+{
+    peer.send(feedback(0x201, 4096, 1000, 2048, 40));
+    peer.send(feedback(0x202, -1, -500, -8192, 41));
+    peer.send(feedback(0x205, 2048, -10, 1000, 35));
+    peer.send(feedback(0x206, 6144, 20, -1000, 36));
+    peer.send(feedback(0x207, 1024, 3000, 4096, 50));
+    bus.run_for_us(1000);
+    HOST_CHECK_EQ(can1.drain_rx(), 5);
+
+    // 3508：编码器8192线，电流±16384对应±20 A
+    HOST_CHECK_NEAR(chassis.getAngleDeg(1), 180.0, 1e-3);
+    HOST_CHECK_NEAR(chassis.getVelocityRpm(1), 1000.0, 1e-3);
+    HOST_CHECK_NEAR(chassis.getCurrent(1), 2.5, 1e-3);
+    HOST_CHECK_NEAR(chassis.getTemperature(1), 40.0, 1e-3);
+    HOST_CHECK_NEAR(chassis.getAngleDeg(2), -360.0 / 8192, 1e-3);
+    HOST_CHECK_NEAR(chassis.getVelocityRpm(2), -500.0, 1e-3);
+    HOST_CHECK_NEAR(chassis.getCurrent(2), -10.0, 1e-3);
+
+    // 6020：电流±16384对应±3 A
+    HOST_CHECK_NEAR(gimbal.getAngleDeg(1), 90.0, 1e-3);
+    HOST_CHECK_NEAR(gimbal.getVelocityRpm(1), -10.0, 1e-3);
+    HOST_CHECK_NEAR(gimbal.getCurrent(1), 1000 * 3.0 / 16384, 1e-4);
+    HOST_CHECK_NEAR(gimbal.getTemperature(1), 35.0, 1e-3);
+    HOST_CHECK_NEAR(gimbal.getAngleDeg(2), 270.0, 1e-3);
+    HOST_CHECK_NEAR(gimbal.getCurrent(2), -1000 * 3.0 / 16384, 1e-4);
+
+    HOST_CHECK_NEAR(loader.getAngleDeg(1), 45.0, 1e-3);
+    HOST_CHECK_NEAR(loader.getVelocityRpm(1), 3000.0, 1e-3);
+
+    // 未注册的ID不影响已有数据
+    peer.send(feedback(0x203, 100, 100, 100, 100));
+    bus.run_for_us(1000);
+    can1.drain_rx();
+    HOST_CHECK_NEAR(chassis.getAngleDeg(1), 180.0, 1e-3);
+}
+
+// 时间戳0是有效的接收时刻，不能当作“尚未收到”
+void test_feedback_flag()
+{
+    HOST_CHECK_EQ(spare.getFeedbackAge_us(1), UINT32_MAX);
+
+    Frame frame = feedback(0x208, 100, 0, 0, 30);
+    frame.timestamp = 0;
+    spare.Parse(frame);
+    HOST_CHECK_EQ(spare.getFeedbackCycles(1), 0);
+    HOST_CHECK(spare.getFeedbackAge_us(1) != UINT32_MAX);
+    HOST_CHECK_NEAR(spare.getTemperature(1), 30.0, 1e-3);
+}
+
+void test_commands(VirtualCanBus &bus, VirtualCanDevice &peer)
+{
+    captured_count = 0;
+    chassis.setCAN(1000, 1);
+    chassis.setCAN(-2000, 2);
+    gimbal.setCAN(15000, 1);
+    gimbal.setCAN(-15000, 2);
+    loader.setCAN(3000, 7);
+
+    // 所有电机写完后发送一次：两个组ID各一帧
+    HOST_CHECK(chassis.sendCAN());
+    bus.run_for_us(1000);
+    peer.drain_rx();
+    HOST_CHECK_EQ(captured_count, 2);
+
+    const Frame *group_200 = find_captured(0x200);
+    HOST_CHECK(group_200 != nullptr);
+    if (group_200 != nullptr)
+    {
+        HOST_CHECK_EQ(group_200->dlc, 8);
+        HOST_CHECK_EQ(slot_value(*group_200, 1), 1000);
+        HOST_CHECK_EQ(slot_value(*group_200, 2), -2000);
+        HOST_CHECK_EQ(slot_value(*group_200, 3), 0);
+        HOST_CHECK_EQ(slot_value(*group_200, 4), 0);
+    }
+
+    // 0x1FF同时携带6020（槽位1、2）和电调ID 7的3508（槽位3）
+    const Frame *group_1ff = find_captured(0x1FF);
+    HOST_CHECK(group_1ff != nullptr);
+    if (group_1ff != nullptr)
+    {
+        HOST_CHECK_EQ(slot_value(*group_1ff, 1), 15000);
+        HOST_CHECK_EQ(slot_value(*group_1ff, 2), -15000);
+        HOST_CHECK_EQ(slot_value(*group_1ff, 3), 3000);
+        HOST_CHECK_EQ(slot_value(*group_1ff, 4), 0);
+    }
+
+    // 没有写入的组不再发送；写入一个槽位时其余槽位保持上一次的值
+    captured_count = 0;
+    HOST_CHECK(gimbal.sendCAN());
+    bus.run_for_us(1000);
+    peer.drain_rx();
+    HOST_CHECK_EQ(captured_count, 0);
+
+    gimbal.setCAN(-1, 2);
+    HOST_CHECK(gimbal.sendCAN());
+    bus.run_for_us(1000);
+    peer.drain_rx();
+    HOST_CHECK_EQ(captured_count, 1);
+    HOST_CHECK_EQ(captured[0].id, 0x1FF);
+    HOST_CHECK_EQ(slot_value(captured[0], 1), 15000);
+    HOST_CHECK_EQ(slot_value(captured[0], 2), -1);
+    HOST_CHECK_EQ(slot_value(captured[0], 3), 3000);
+}
+
+// 共用0x200的两个对象各自setCAN()后sendCAN()，每个节拍仍只发一帧，后写入的数据下一节拍发出
+void test_one_frame_per_tick(VirtualCanBus &bus, VirtualCanDevice &peer)
+{
+    auto &composer = BSP::Motor::Dji::get_command_composer(CanDeviceId::HAL_Can1);
+    const uint32_t deferred = composer.getDeferredFrames();
+
+    for (int16_t tick = 1; tick <= 3; ++tick)
+    {
+        captured_count = 0;
+        chassis.setCAN(tick * 100, 1);
+        HOST_CHECK(chassis.sendCAN());
+        chassis_rear.setCAN(tick * 100 + 3, 3);
+        HOST_CHECK(chassis_rear.sendCAN());
+        bus.run_for_us(1000);
+        peer.drain_rx();
+
+        HOST_CHECK_EQ(captured_count, 1);
+        HOST_CHECK_EQ(captured[0].id, 0x200);
+        HOST_CHECK_EQ(slot_value(captured[0], 1), tick * 100);
+        HOST_CHECK_EQ(slot_value(captured[0], 3), tick == 1 ? 0 : (tick - 1) * 100 + 3);
+    }
+    HOST_CHECK_EQ(composer.getDeferredFrames(), deferred + 3);
+
+    // 所有setCAN()之后只flush()一次时，两个对象的数据在同一帧中
+    captured_count = 0;
+    chassis.setCAN(400, 1);
+    chassis_rear.setCAN(403, 3);
+    HOST_CHECK(composer.flush());
+    bus.run_for_us(1000);
+    peer.drain_rx();
+    HOST_CHECK_EQ(captured_count, 1);
+    HOST_CHECK_EQ(slot_value(captured[0], 1), 400);
+    HOST_CHECK_EQ(slot_value(captured[0], 3), 403);
+    HOST_CHECK_EQ(composer.getDeferredFrames(), deferred + 3);
+}
+} // namespace
+
+int main()
+{
+    auto &bus = VirtualCanBus::instance();
+    auto &can1 = bus.get_device(CanDeviceId::HAL_Can1);
+    auto &peer = bus.peer(CanDeviceId::HAL_Can1);
+
+    HOST_CHECK(chassis.registerCallback(&can1));
+    HOST_CHECK(gimbal.registerCallback(&can1));
+    HOST_CHECK(loader.registerCallback(&can1));
+    HOST_CHECK(peer.register_rx_callback(capture));
+
+    test_feedback(bus, can1, peer);
+    test_feedback_flag();
+    test_commands(bus, peer);
+    test_one_frame_per_tick(bus, peer);
+    return HOST_TEST::report("test_dji_motor");
+}
+
+#endif // HAL_CAN_VIRTUAL
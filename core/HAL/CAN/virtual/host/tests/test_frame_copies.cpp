@@ -0,0 +1,112 @@
+// 一个云台控制周期（4个DJI反馈、1个达妙反馈、1帧DJI控制、1帧达妙控制）在本机节点中搬运的Frame字节数
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../user/core/BSP/Motor/DM/DmMotor.hpp"
+#include "../user/core/BSP/Motor/Dji/DjiMotor.hpp"
+#include "../user/core/HAL/CAN/virtual/virtual_can.hpp"
+#include "host_test.hpp"
+
+using namespace HAL::CAN;
+
+namespace
+{
+BSP::Motor::Dji::GM6020<4> gimbal(0x204, {1, 2, 3, 4}, 0x1FF);
+// 反馈ID 0x11，MIT控制帧ID 0x01
+BSP::Motor::DM::J4310<1> pitch(0x10, {1}, {0x01}, CanDeviceId::HAL_Can1);
+
+constexpr uint32_t FRAME_SIZE = sizeof(Frame);
+
+void send_feedback(VirtualCanDevice &peer)
+{
+    for (ID_t id = 0x205; id <= 0x208; ++id)
+    {
+        Frame frame = Frame::make(id);
+        frame.data[6] = 40;
+        HOST_CHECK(peer.send(frame));
+    }
+    Frame dm = Frame::make(0x11);
+    dm.data[0] = 0x11;
+    dm.data[6] = 35;
+    HOST_CHECK(peer.send(dm));
+}
+
+void send_commands()
+{
+    for (uint8_t i = 1; i <= 4; ++i)
+    {
+        HOST_CHECK(gimbal.setCAN(1000 * i, i));
+    }
+    HOST_CHECK(gimbal.sendCAN());
+    HOST_CHECK(pitch.ctrl_Mit(1, 0.0f, 0.0f, 10.0f, 1.0f, 0.0f));
+}
+
+// 一个控制周期：收反馈、解析、发控制帧；fill_mailboxes为true时先占满3个发送邮箱
+FrameCopyStats run_tick(VirtualCanBus &bus, VirtualCanDevice &local, VirtualCanDevice &peer, bool fill_mailboxes)
+{
+    local.reset_frame_copy_stats();
+    send_feedback(peer);
+    bus.run_for_us(1000);
+    local.drain_rx();
+    if (fill_mailboxes)
+    {
+        for (ID_t id = 0x600; id < 0x603; ++id)
+        {
+            HOST_CHECK(local.send(Frame::make(id), TxPriority::Diagnostic));
+        }
+    }
+    send_commands();
+    bus.run_for_us(2000);
+    peer.drain_rx();
+    return local.get_frame_copy_stats();
+}
+
+// 邮箱空闲时控制帧直接写入邮箱，只有接收队列的写入和取出：5 × 2 × 16 = 160字节
+void test_idle_mailboxes(VirtualCanBus &bus, VirtualCanDevice &local, VirtualCanDevice &peer)
+{
+    const FrameCopyStats copies = run_tick(bus, local, peer, false);
+    HOST_CHECK_EQ(copies.rx_ring_push, 5);
+    HOST_CHECK_EQ(copies.rx_ring_pop, 5);
+    HOST_CHECK_EQ(copies.tx_queue_push, 0);
+    HOST_CHECK_EQ(copies.tx_queue_pop, 0);
+    HOST_CHECK_EQ(copies.mailbox_write, 2);
+    HOST_CHECK_EQ((copies.rx_ring_push + copies.rx_ring_pop) * FRAME_SIZE, 160);
+
+    // 反馈确实经过路由表解析
+    HOST_CHECK_NEAR(gimbal.getTemperature(4), 40.0, 1e-3);
+    HOST_CHECK_NEAR(pitch.getTemperature(1), 35.0, 1e-3);
+}
+
+// 邮箱全忙时控制帧经过发送队列：(5 + 5 + 2 + 2) × 16 = 224字节（Frame打包前为28字节，同样的路径为392字节），
+// 补发时另有2次读取队首的拷贝
+void test_busy_mailboxes(VirtualCanBus &bus, VirtualCanDevice &local, VirtualCanDevice &peer)
+{
+    const FrameCopyStats copies = run_tick(bus, local, peer, true);
+    HOST_CHECK_EQ(copies.rx_ring_push, 5);
+    HOST_CHECK_EQ(copies.rx_ring_pop, 5);
+    HOST_CHECK_EQ(copies.tx_queue_push, 2);
+    HOST_CHECK_EQ(copies.tx_queue_pop, 2);
+    HOST_CHECK_EQ(copies.tx_queue_peek, 2);
+    HOST_CHECK_EQ(copies.mailbox_write, 3 + 2);
+
+    const uint32_t ring_copies =
+        copies.rx_ring_push + copies.rx_ring_pop + copies.tx_queue_push + copies.tx_queue_pop;
+    HOST_CHECK_EQ(ring_copies * FRAME_SIZE, 224);
+    HOST_CHECK_EQ(ring_copies * 28, 392);
+}
+} // namespace
+
+int main()
+{
+    auto &bus = VirtualCanBus::instance();
+    auto &local = bus.local(CanDeviceId::HAL_Can1);
+    auto &peer = bus.peer(CanDeviceId::HAL_Can1);
+
+    HOST_CHECK(gimbal.registerCallback(&local));
+    HOST_CHECK(pitch.registerCallback(&local));
+
+    test_idle_mailboxes(bus, local, peer);
+    test_busy_mailboxes(bus, local, peer);
+    return HOST_TEST::report("test_frame_copies");
+}
+
+#endif // HAL_CAN_VIRTUAL
@@ -0,0 +1,109 @@
+// 任务循环监视：按仿真时钟推进的周期、抖动分位数、超时和执行时间统计
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../user/core/HAL/CAN/virtual/virtual_can.hpp"
+#include "../user/core/HAL/PROFILE/loop_monitor.hpp"
+#include "host_test.hpp"
+
+using namespace HAL::PROFILE;
+using HAL::CAN::VirtualClock;
+
+namespace
+{
+// 额定周期1 ms，执行时间预算300 us，截止时间默认为1.5 ms
+LoopMonitor control("control", 1000, 300);
+
+void advance_us(uint32_t us)
+{
+    VirtualClock::set_ns(VirtualClock::now_ns() + (uint64_t)us * 1000);
+}
+
+// 一次循环：工作busy_us后done()，到period_us时下一次tick()
+void cycle(uint32_t period_us, uint32_t busy_us)
+{
+    advance_us(busy_us);
+    control.done();
+    advance_us(period_us - busy_us);
+    control.tick();
+}
+
+void test_register()
+{
+    HOST_CHECK_EQ(LoopMonitor::monitor_count(), 0);
+    control.tick();
+    HOST_CHECK_EQ(LoopMonitor::monitor_count(), 1);
+    HOST_CHECK(LoopMonitor::monitor(0) == &control);
+    HOST_CHECK(LoopMonitor::monitor(1) == nullptr);
+    HOST_CHECK_EQ(LoopMonitor::dropped_monitors(), 0);
+    HOST_CHECK_EQ(control.deadline_us(), 1500);
+}
+
+void test_window()
+{
+    // 8个准时的周期，一个晚5 us且超预算的周期，一个超过截止时间的周期
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+        cycle(1000, 200);
+    }
+    cycle(1005, 400);
+    cycle(2000, 200);
+
+    const LoopStats s = control.take_stats();
+    HOST_CHECK_EQ(s.ticks, 10);
+    HOST_CHECK_EQ(s.min_period_us, 1000);
+    HOST_CHECK_EQ(s.mean_period_us, 1100);
+    HOST_CHECK_EQ(s.max_period_us, 2000);
+    HOST_CHECK_EQ(s.jitter_p50_us, 0);
+    HOST_CHECK_EQ(s.jitter_p90_us, 5);
+    // 1000 us所在的桶为[960, 1023]，分位数不超过最大值
+    HOST_CHECK_EQ(s.jitter_p99_us, 1000);
+    HOST_CHECK_EQ(s.jitter_max_us, 1000);
+    HOST_CHECK_EQ(s.missed, 1);
+    HOST_CHECK_EQ(s.mean_busy_us, 220);
+    HOST_CHECK_EQ(s.max_busy_us, 400);
+    HOST_CHECK_EQ(s.over_budget, 1);
+    HOST_CHECK_EQ(s.flags, LOOP_FLAG_MISSED_DEADLINE | LOOP_FLAG_OVER_BUDGET);
+    HOST_CHECK_EQ(s.total_ticks, 10);
+    HOST_CHECK_EQ(s.total_missed, 1);
+    HOST_CHECK_EQ(s.longest_gap_us, 2000);
+}
+
+// 取走后窗口清零，累计值保留
+void test_take_clears()
+{
+    LoopStats s = control.take_stats();
+    HOST_CHECK_EQ(s.ticks, 0);
+    HOST_CHECK_EQ(s.flags, 0);
+    HOST_CHECK_EQ(s.total_ticks, 10);
+    HOST_CHECK_EQ(s.longest_gap_us, 2000);
+
+    // 抖动都落在[64, 71]的桶内时，分位数取桶的上限，但不超过最大值
+    for (uint8_t i = 0; i < 10; ++i)
+    {
+        cycle(i < 5 ? 1066 : 1068, 100);
+    }
+    LoopMonitor::log_report();
+    s = control.take_stats();
+    HOST_CHECK_EQ(s.ticks, 0);
+    HOST_CHECK_EQ(s.total_ticks, 20);
+
+    for (uint8_t i = 0; i < 10; ++i)
+    {
+        cycle(i < 5 ? 1066 : 1068, 100);
+    }
+    s = control.take_stats();
+    HOST_CHECK_EQ(s.jitter_p50_us, 68);
+    HOST_CHECK_EQ(s.jitter_max_us, 68);
+    HOST_CHECK_EQ(s.missed, 0);
+}
+} // namespace
+
+int main()
+{
+    test_register();
+    test_window();
+    test_take_clears();
+    return HOST_TEST::report("test_loop_monitor");
+}
+
+#endif // HAL_CAN_VIRTUAL
@@ -0,0 +1,35 @@
+/**
+ * @file tim.h
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief PC端编译用的定时器声明（蜂鸣器）
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include "main.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint32_t compare[4];
+} TIM_HandleTypeDef;
+
+#define TIM_CHANNEL_1 0x00000000U
+#define TIM_CHANNEL_2 0x00000004U
+#define TIM_CHANNEL_3 0x00000008U
+#define TIM_CHANNEL_4 0x0000000CU
+
+#define __HAL_TIM_SET_COMPARE(handle, channel, value) ((handle)->compare[(channel) >> 2] = (value))
+
+extern TIM_HandleTypeDef htim4;
+
+#ifdef __cplusplus
+}
+#endif
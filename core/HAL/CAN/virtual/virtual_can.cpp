@@ -0,0 +1,689 @@
+#include "virtual_can.hpp"
+#include "../../DWT/DWT.hpp"
+#include "../trace/can_trace_recorder.hpp"
+
+#ifdef HAL_CAN_VIRTUAL
+
+#ifdef HAL_CAN_VIRTUAL_SOCKETCAN
+#include <cstring>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace HAL::CAN
+{
+
+namespace
+{
+uint64_t g_now_ns = 0;
+} // namespace
+
+uint64_t VirtualClock::now_ns()
+{
+    return g_now_ns;
+}
+
+void VirtualClock::set_ns(uint64_t ns)
+{
+    g_now_ns = ns;
+}
+
+// ===================================== VirtualCanDevice =====================================
+
+VirtualCanDevice::VirtualCanDevice(const char *name) : name_(name)
+{
+}
+
+void VirtualCanDevice::init()
+{
+}
+
+void VirtualCanDevice::start()
+{
+    started_ = true;
+    stats_.bitrate = wire_ != nullptr ? wire_->bitrate() : 0;
+}
+
+bool VirtualCanDevice::free_mailbox_available() const
+{
+    for (const auto &mailbox : mailboxes_)
+    {
+        if (!mailbox.pending)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool VirtualCanDevice::mailbox_has_id(const Frame &frame) const
+{
+    for (const auto &mailbox : mailboxes_)
+    {
+        if (mailbox.pending && mailbox.frame.id == frame.id && mailbox.frame.is_extended_id == frame.is_extended_id)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool VirtualCanDevice::send(const Frame &frame, TxPriority priority)
+{
+    if (wire_ == nullptr)
+    {
+        return false;
+    }
+
+    bool queued = false;
+    for (const auto &queue : tx_queue_)
+    {
+        if (queue.size() != 0)
+        {
+            queued = true;
+            break;
+        }
+    }
+
+    if (!queued && free_mailbox_available() && !mailbox_has_id(frame))
+    {
+        for (auto &mailbox : mailboxes_)
+        {
+            if (!mailbox.pending)
+            {
+                mailbox.frame = frame;
+                mailbox.pending = true;
+                break;
+            }
+        }
+        ++copies_.mailbox_write;
+        ++stats_.tx_frames;
+        HAL_CAN_TRACE_RECORD(trace_bus_, frame, true);
+        return true;
+    }
+
+    const uint8_t index = static_cast<uint8_t>(priority);
+    if (!tx_queue_[index].push(frame))
+    {
+        return false;
+    }
+    ++copies_.tx_queue_push;
+    ++tx_enqueued_[index];
+    return true;
+}
+
+void VirtualCanDevice::on_tx_mailbox_free()
+{
+    Frame frame;
+    for (auto &queue : tx_queue_)
+    {
+        while (free_mailbox_available() && queue.peek(frame))
+        {
+            ++copies_.tx_queue_peek;
+            // 与CanDevice一致：同ID的帧还在邮箱中时停止补发，低优先级的帧也不进入邮箱
+            if (mailbox_has_id(frame))
+            {
+                return;
+            }
+            queue.pop(frame);
+            ++copies_.tx_queue_pop;
+            for (auto &mailbox : mailboxes_)
+            {
+                if (!mailbox.pending)
+                {
+                    mailbox.frame = frame;
+                    mailbox.pending = true;
+                    break;
+                }
+            }
+            ++copies_.mailbox_write;
+            ++stats_.tx_frames;
+            HAL_CAN_TRACE_RECORD(trace_bus_, frame, true);
+        }
+    }
+}
+
+TxQueueStats VirtualCanDevice::get_tx_queue_stats(TxPriority priority) const
+{
+    const uint8_t index = static_cast<uint8_t>(priority);
+    TxQueueStats stats;
+    stats.capacity = tx_queue_[index].capacity();
+    stats.depth = tx_queue_[index].size();
+    stats.enqueued = tx_enqueued_[index];
+    stats.dropped = tx_queue_[index].overflow();
+    stats.max_depth = tx_queue_[index].high_water();
+    return stats;
+}
+
+bool VirtualCanDevice::receive(Frame &frame)
+{
+    // 虚拟总线已经把帧放入接收队列
+    (void)frame;
+    return false;
+}
+
+uint32_t VirtualCanDevice::receive_all()
+{
+    return 0;
+}
+
+void VirtualCanDevice::on_rx_fifo_full(uint32_t fifo)
+{
+    ++stats_.fifo_full[fifo == CAN_RX_FIFO0 ? 0 : 1];
+}
+
+uint32_t VirtualCanDevice::drain_rx(uint32_t max_frames)
+{
+    Frame frame;
+    uint32_t count = 0;
+
+    while (count < max_frames && rx_ring_.pop(frame))
+    {
+        ++copies_.rx_ring_pop;
+        trigger_rx_callbacks(frame);
+        ++count;
+    }
+
+    return count;
+}
+
+RxRingStats VirtualCanDevice::get_rx_ring_stats() const
+{
+    RxRingStats stats;
+    stats.capacity = rx_ring_.capacity();
+    stats.depth = rx_ring_.size();
+    stats.high_water = rx_ring_.high_water();
+    stats.overflow = rx_ring_.overflow();
+    return stats;
+}
+
+void VirtualCanDevice::on_error()
+{
+    ++stats_.error_irq_count;
+}
+
+void VirtualCanDevice::supervise()
+{
+    // 虚拟总线不会离线
+}
+
+void VirtualCanDevice::update_bus_stats(uint32_t now_ms)
+{
+    const uint32_t elapsed = now_ms - stats_last_ms_;
+    if (elapsed == 0 || wire_ == nullptr)
+    {
+        return;
+    }
+
+    stats_.bitrate = wire_->bitrate();
+    stats_.rx_fps = (uint64_t)(stats_.rx_frames - stats_last_rx_frames_) * 1000 / elapsed;
+    stats_.tx_fps = (uint64_t)(stats_.tx_frames - stats_last_tx_frames_) * 1000 / elapsed;
+
+    // 虚拟总线知道真实的占用时间，直接按占用时间计算
+    const uint64_t busy = wire_->busy_ns();
+    stats_.utilization_permille = (busy - stats_last_busy_ns_) / ((uint64_t)elapsed * 1000);
+    if (stats_.utilization_permille > stats_.peak_utilization_permille)
+    {
+        stats_.peak_utilization_permille = stats_.utilization_permille;
+    }
+
+    stats_last_ms_ = now_ms;
+    stats_last_rx_frames_ = stats_.rx_frames;
+    stats_last_tx_frames_ = stats_.tx_frames;
+    stats_last_busy_ns_ = busy;
+}
+
+BusStats VirtualCanDevice::get_bus_stats() const
+{
+    return stats_;
+}
+
+CAN_HandleTypeDef *VirtualCanDevice::get_handle() const
+{
+    return nullptr;
+}
+
+bool VirtualCanDevice::register_rx_callback(RxCallback callback)
+{
+    return rx_callbacks_.add(callback);
+}
+
+bool VirtualCanDevice::register_id_handler(ID_t id, bool is_extended, IdHandlerFn fn, void *ctx, uint8_t slot,
+                                           RxPriority priority)
+{
+    if (!id_router_.add(id, is_extended, fn, ctx, slot))
+    {
+        return false;
+    }
+    return add_filter_id(id, is_extended, priority);
+}
+
+bool VirtualCanDevice::add_filter_id(ID_t id, bool is_extended, RxPriority priority)
+{
+    (void)priority;
+    for (uint8_t i = 0; i < filter_count_; ++i)
+    {
+        if (filter_ids_[i].id == id && filter_ids_[i].is_extended == is_extended)
+        {
+            return true;
+        }
+    }
+    if (filter_count_ >= MAX_FILTER_IDS)
+    {
+        return false;
+    }
+    filter_ids_[filter_count_++] = {id, is_extended};
+    return true;
+}
+
+bool VirtualCanDevice::apply_id_filters()
+{
+    filter_enabled_ = filter_count_ != 0;
+    return true;
+}
+
+void VirtualCanDevice::trigger_rx_callbacks(const Frame &frame)
+{
+    id_router_.dispatch(frame);
+    rx_callbacks_.invoke(frame);
+}
+
+bool VirtualCanDevice::accepts(const Frame &frame) const
+{
+    if (!filter_enabled_)
+    {
+        return true;
+    }
+    for (uint8_t i = 0; i < filter_count_; ++i)
+    {
+        if (filter_ids_[i].id == frame.id && filter_ids_[i].is_extended == frame.is_extended_id)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void VirtualCanDevice::deliver(const Frame &received)
+{
+    if (!started_ || !accepts(received))
+    {
+        return;
+    }
+
+    // 相当于接收中断入口读取周期计数；各总线独立仿真，按本总线的当前时刻换算
+    Frame frame = received;
+    frame.timestamp =
+        static_cast<uint32_t>(wire_->now_ns_ * HAL::DWTimer::getInstance().GetCyclesPerUs() / 1000) & Frame::TIMESTAMP_MASK;
+
+    ++stats_.rx_frames;
+    stats_.rx_bits += frame_bits_worst_case(frame.dlc, frame.is_extended_id, frame.is_remote_frame);
+    HAL_CAN_TRACE_RECORD(trace_bus_, frame, false);
+    if (rx_ring_.push(frame))
+    {
+        ++copies_.rx_ring_push;
+    }
+}
+
+void VirtualCanDevice::complete_mailbox(uint8_t index)
+{
+    // 与CanDevice一致，发送完成时才计入位数
+    const Frame &frame = mailboxes_[index].frame;
+    stats_.tx_bits += frame_bits_worst_case(frame.dlc, frame.is_extended_id, frame.is_remote_frame);
+    mailboxes_[index].pending = false;
+    on_tx_mailbox_free();
+}
+
+// ===================================== VirtualCanWire =====================================
+
+VirtualCanWire::VirtualCanWire(uint32_t bitrate, uint32_t latency_us)
+    : bitrate_(bitrate), latency_ns_((uint64_t)latency_us * 1000)
+{
+}
+
+bool VirtualCanWire::attach(VirtualCanDevice &node)
+{
+    if (node_count_ >= HAL_CAN_VIRTUAL_MAX_NODES || node.wire_ != nullptr)
+    {
+        return false;
+    }
+    nodes_[node_count_++] = &node;
+    node.wire_ = this;
+    return true;
+}
+
+uint64_t VirtualCanWire::arbitration_key(const Frame &frame)
+{
+    // 按总线上的位顺序拼接：11位基本ID、RTR/SRR、IDE、18位扩展ID、扩展帧RTR（显性0优先）
+    const uint64_t rtr = frame.is_remote_frame ? 1 : 0;
+    if (!frame.is_extended_id)
+    {
+        const uint64_t base = frame.id & 0x7FF;
+        return (base << 21) | (rtr << 20);
+    }
+    const uint64_t base = (frame.id >> 18) & 0x7FF;
+    const uint64_t low = frame.id & 0x3FFFF;
+    return (base << 21) | (1ull << 20) | (1ull << 19) | (low << 1) | rtr;
+}
+
+bool VirtualCanWire::arbitrate()
+{
+    int8_t best_node = -1;
+    uint8_t best_mailbox = 0;
+    uint64_t best_key = UINT64_MAX;
+
+    for (uint8_t n = 0; n < node_count_; ++n)
+    {
+        for (uint8_t m = 0; m < VirtualCanDevice::MAILBOX_COUNT; ++m)
+        {
+            const auto &mailbox = nodes_[n]->mailboxes_[m];
+            if (mailbox.pending && arbitration_key(mailbox.frame) < best_key)
+            {
+                best_key = arbitration_key(mailbox.frame);
+                best_node = n;
+                best_mailbox = m;
+            }
+        }
+    }
+
+    if (best_node < 0)
+    {
+        return false;
+    }
+
+    const Frame &frame = nodes_[best_node]->mailboxes_[best_mailbox].frame;
+    const uint64_t bits = frame_bits_worst_case(frame.dlc, frame.is_extended_id, frame.is_remote_frame);
+    const uint64_t duration = bitrate_ != 0 ? (bits * 1000000000ull + bitrate_ - 1) / bitrate_ : 0;
+
+    busy_ = true;
+    tx_node_ = best_node;
+    tx_mailbox_ = best_mailbox;
+    tx_end_ns_ = now_ns_ + duration;
+    busy_ns_ += duration;
+    return true;
+}
+
+void VirtualCanWire::finish_tx()
+{
+    VirtualCanDevice *sender = nodes_[tx_node_];
+    const Frame frame = sender->mailboxes_[tx_mailbox_].frame;
+    busy_ = false;
+
+#ifdef HAL_CAN_VIRTUAL_SOCKETCAN
+    write_socketcan(frame);
+#endif
+
+    if (latency_ns_ == 0)
+    {
+        deliver(frame, tx_node_);
+    }
+    else if (in_flight_count_ < HAL_CAN_VIRTUAL_MAX_IN_FLIGHT)
+    {
+        InFlight &slot = in_flight_[(in_flight_head_ + in_flight_count_) % HAL_CAN_VIRTUAL_MAX_IN_FLIGHT];
+        slot.deliver_at = now_ns_ + latency_ns_;
+        slot.frame = frame;
+        slot.src = tx_node_;
+        ++in_flight_count_;
+    }
+    else
+    {
+        ++dropped_;
+    }
+
+    // 相当于发送邮箱完成中断
+    sender->complete_mailbox(tx_mailbox_);
+}
+
+void VirtualCanWire::deliver(const Frame &frame, int8_t src)
+{
+    for (uint8_t n = 0; n < node_count_; ++n)
+    {
+        if (n != src)
+        {
+            nodes_[n]->deliver(frame);
+        }
+    }
+}
+
+void VirtualCanWire::run_until(uint64_t t_ns)
+{
+#ifdef HAL_CAN_VIRTUAL_SOCKETCAN
+    poll_socketcan();
+#endif
+
+    // 仿真时钟被直接向前拨动（VirtualClock::set_ns()）时总线上没有事件，空闲的总线直接追上，
+    // 之后进入邮箱的帧按进入时刻仲裁
+    const uint64_t clock_ns = VirtualClock::now_ns();
+    if (!busy_ && in_flight_count_ == 0 && now_ns_ < clock_ns)
+    {
+        now_ns_ = clock_ns;
+    }
+
+    for (;;)
+    {
+        // 找出最早的事件：帧发送完成、在途帧到达、空闲总线上开始仲裁
+        enum class Event
+        {
+            None,
+            TxDone,
+            Arrive,
+            Arbitrate
+        } event = Event::None;
+        uint64_t next = UINT64_MAX;
+
+        if (busy_)
+        {
+            next = tx_end_ns_;
+            event = Event::TxDone;
+        }
+        if (in_flight_count_ != 0 && in_flight_[in_flight_head_].deliver_at < next)
+        {
+            next = in_flight_[in_flight_head_].deliver_at;
+            event = Event::Arrive;
+        }
+        if (!busy_ && now_ns_ < next)
+        {
+            bool pending = false;
+            for (uint8_t n = 0; n < node_count_ && !pending; ++n)
+            {
+                for (const auto &mailbox : nodes_[n]->mailboxes_)
+                {
+                    pending = pending || mailbox.pending;
+                }
+            }
+            if (pending)
+            {
+                next = now_ns_;
+                event = Event::Arbitrate;
+            }
+        }
+
+        if (event == Event::None || next > t_ns)
+        {
+            break;
+        }
+
+        now_ns_ = next;
+        // 事件处理（相当于中断）中读到的仿真时钟为事件发生的时刻，抓包等按此记录
+        VirtualClock::set_ns(now_ns_);
+        switch (event)
+        {
+        case Event::TxDone:
+            finish_tx();
+            break;
+        case Event::Arrive: {
+            const InFlight &item = in_flight_[in_flight_head_];
+            in_flight_head_ = (in_flight_head_ + 1) % HAL_CAN_VIRTUAL_MAX_IN_FLIGHT;
+            --in_flight_count_;
+            deliver(item.frame, item.src);
+            break;
+        }
+        case Event::Arbitrate:
+            arbitrate();
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (t_ns > now_ns_)
+    {
+        now_ns_ = t_ns;
+    }
+    VirtualClock::set_ns(clock_ns);
+}
+
+#ifdef HAL_CAN_VIRTUAL_SOCKETCAN
+bool VirtualCanWire::bind_socketcan(const char *ifname)
+{
+    const int fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK, CAN_RAW);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    ifreq ifr = {};
+    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+    if (ioctl(fd, SIOCGIFINDEX, &ifr) < 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    sockaddr_can addr = {};
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    socket_fd_ = fd;
+    return true;
+}
+
+void VirtualCanWire::poll_socketcan()
+{
+    if (socket_fd_ < 0)
+    {
+        return;
+    }
+
+    can_frame raw;
+    while (read(socket_fd_, &raw, sizeof(raw)) == sizeof(raw))
+    {
+        Frame frame = {};
+        frame.is_extended_id = (raw.can_id & CAN_EFF_FLAG) != 0;
+        frame.is_remote_frame = (raw.can_id & CAN_RTR_FLAG) != 0;
+        frame.id = raw.can_id & (frame.is_extended_id ? CAN_EFF_MASK : CAN_SFF_MASK);
+        frame.dlc = raw.can_dlc > 8 ? 8 : raw.can_dlc;
+        memcpy(frame.data, raw.data, frame.dlc);
+        deliver(frame, -1);
+    }
+}
+
+void VirtualCanWire::write_socketcan(const Frame &frame)
+{
+    if (socket_fd_ < 0)
+    {
+        return;
+    }
+
+    can_frame raw = {};
+    raw.can_id = frame.id;
+    if (frame.is_extended_id)
+    {
+        raw.can_id |= CAN_EFF_FLAG;
+    }
+    if (frame.is_remote_frame)
+    {
+        raw.can_id |= CAN_RTR_FLAG;
+    }
+    raw.can_dlc = frame.dlc;
+    memcpy(raw.data, frame.data, frame.dlc > 8 ? 8 : frame.dlc);
+    (void)write(socket_fd_, &raw, sizeof(raw));
+}
+#endif
+
+// ===================================== VirtualCanBus =====================================
+
+VirtualCanBus &VirtualCanBus::instance()
+{
+    static VirtualCanBus instance;
+    return instance;
+}
+
+VirtualCanBus::VirtualCanBus()
+{
+    static const char *const device_names[] = {"can1", "can2", "can3"};
+    static const char *const peer_names[] = {"can1-peer", "can2-peer", "can3-peer"};
+    static_assert(sizeof(device_names) / sizeof(device_names[0]) == (size_t)CanDeviceId::MAX_DEVICES,
+                  "虚拟CAN设备名称数量与CanDeviceId不一致");
+
+    for (size_t i = 0; i < (size_t)CanDeviceId::MAX_DEVICES; ++i)
+    {
+        devices_[i].name_ = device_names[i];
+        peers_[i].name_ = peer_names[i];
+        devices_[i].trace_bus_ = (uint8_t)i;
+        wires_[i].attach(devices_[i]);
+        wires_[i].attach(peers_[i]);
+        devices_[i].init();
+        devices_[i].start();
+        peers_[i].init();
+        peers_[i].start();
+    }
+}
+
+ICanDevice &VirtualCanBus::get_device(CanDeviceId id)
+{
+    if (id < CanDeviceId::MAX_DEVICES)
+    {
+        return devices_[(size_t)id];
+    }
+    return devices_[0];
+}
+
+bool VirtualCanBus::has_device(CanDeviceId id) const
+{
+    return id < CanDeviceId::MAX_DEVICES;
+}
+
+ICanDevice *VirtualCanBus::find_device(const CAN_HandleTypeDef *handle)
+{
+    (void)handle;
+    return nullptr;
+}
+
+VirtualCanDevice &VirtualCanBus::local(CanDeviceId id)
+{
+    return devices_[id < CanDeviceId::MAX_DEVICES ? (size_t)id : 0];
+}
+
+VirtualCanDevice &VirtualCanBus::peer(CanDeviceId id)
+{
+    return peers_[id < CanDeviceId::MAX_DEVICES ? (size_t)id : 0];
+}
+
+VirtualCanWire &VirtualCanBus::wire(CanDeviceId id)
+{
+    return wires_[id < CanDeviceId::MAX_DEVICES ? (size_t)id : 0];
+}
+
+void VirtualCanBus::run_for_us(uint32_t us)
+{
+    const uint64_t target = VirtualClock::now_ns() + (uint64_t)us * 1000;
+    for (auto &wire : wires_)
+    {
+        wire.run_until(target);
+    }
+    VirtualClock::set_ns(target);
+}
+
+} // namespace HAL::CAN
+
+#endif // HAL_CAN_VIRTUAL
@@ -0,0 +1,309 @@
+/**
+ * @file virtual_can.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief 虚拟CAN（PC端仿真）
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+
+// 只在PC端编译：定义HAL_CAN_VIRTUAL，并把virtual/host加入头文件搜索路径
+#ifdef HAL_CAN_VIRTUAL
+
+#include "../impl/can_device_impl.hpp"
+#include "../interface/can_bus.hpp"
+#include <cstdint>
+
+// 单条虚拟总线上的节点数量上限
+#ifndef HAL_CAN_VIRTUAL_MAX_NODES
+#define HAL_CAN_VIRTUAL_MAX_NODES 8
+#endif
+
+// 传输延迟期间在途帧数量上限
+#ifndef HAL_CAN_VIRTUAL_MAX_IN_FLIGHT
+#define HAL_CAN_VIRTUAL_MAX_IN_FLIGHT 64
+#endif
+
+namespace HAL::CAN
+{
+
+class VirtualCanWire;
+
+/**
+ * @brief 仿真时钟（纳秒），HAL_GetTick()在PC端也读取该时钟
+ */
+class VirtualClock
+{
+  public:
+    static uint64_t now_ns();
+    static uint64_t now_us()
+    {
+        return now_ns() / 1000;
+    }
+    static void set_ns(uint64_t ns);
+};
+
+/**
+ * @brief 虚拟CAN节点，实现ICanDevice
+ *
+ * 行为与CanDevice保持一致：3个发送邮箱 + 按优先级的软件发送队列、中断到任务的接收队列、
+ * ID路由表和广播回调。区别：
+ * - 帧由虚拟总线直接放入接收队列（相当于中断已经执行了receive_all()），
+ *   receive()/receive_all()不会再读到帧
+ * - apply_id_filters()之后只接收登记过的ID（精确匹配）
+ * - get_handle()返回nullptr
+ */
+// 节点内的帧拷贝次数（PC端统计），每次为一个sizeof(Frame)字节的拷贝，用于核对每个控制周期搬运的字节数
+struct FrameCopyStats
+{
+    uint32_t rx_ring_push;  // 接收时写入接收队列（相当于接收中断）
+    uint32_t rx_ring_pop;   // drain_rx()从接收队列取出
+    uint32_t tx_queue_push; // 邮箱全忙时send()写入发送队列
+    uint32_t tx_queue_peek; // 补发时读取队首检查邮箱中的同ID帧
+    uint32_t tx_queue_pop;  // 补发时从发送队列取出
+    uint32_t mailbox_write; // 写入发送邮箱
+};
+
+class VirtualCanDevice : public ICanDevice
+{
+  public:
+    explicit VirtualCanDevice(const char *name = "node");
+
+    VirtualCanDevice(const VirtualCanDevice &) = delete;
+    VirtualCanDevice &operator=(const VirtualCanDevice &) = delete;
+
+    // 实现ICanDevice接口
+    void init() override;
+    void start() override;
+    bool send(const Frame &frame, TxPriority priority = TxPriority::Control) override;
+    void on_tx_mailbox_free() override;
+    TxQueueStats get_tx_queue_stats(TxPriority priority) const override;
+    bool receive(Frame &frame) override;
+    uint32_t receive_all() override;
+    void on_rx_fifo_full(uint32_t fifo) override;
+    uint32_t drain_rx(uint32_t max_frames = UINT32_MAX) override;
+    RxRingStats get_rx_ring_stats() const override;
+    void on_error() override;
+    void supervise() override;
+    void update_bus_stats(uint32_t now_ms) override;
+    BusStats get_bus_stats() const override;
+    CAN_HandleTypeDef *get_handle() const override;
+    bool register_rx_callback(RxCallback callback) override;
+    bool register_id_handler(ID_t id, bool is_extended, IdHandlerFn fn, void *ctx, uint8_t slot,
+                             RxPriority priority = RxPriority::Low) override;
+    bool add_filter_id(ID_t id, bool is_extended, RxPriority priority = RxPriority::Low) override;
+    bool apply_id_filters() override;
+    void trigger_rx_callbacks(const Frame &frame) override;
+
+    const char *name() const
+    {
+        return name_;
+    }
+
+    FrameCopyStats get_frame_copy_stats() const
+    {
+        return copies_;
+    }
+
+    void reset_frame_copy_stats()
+    {
+        copies_ = {};
+    }
+
+  private:
+    friend class VirtualCanWire;
+    friend class VirtualCanBus;
+
+    static constexpr uint8_t MAILBOX_COUNT = 3;
+    static constexpr uint8_t MAX_FILTER_IDS = 48;
+
+    struct Mailbox
+    {
+        Frame frame;
+        bool pending;
+    };
+
+    struct FilterId
+    {
+        ID_t id;
+        bool is_extended;
+    };
+
+    const char *name_;
+    VirtualCanWire *wire_ = nullptr;
+    uint8_t trace_bus_ = 0xFF; // 抓包时记录的总线编号，只有本机节点记录
+    bool started_ = false;
+
+    Mailbox mailboxes_[MAILBOX_COUNT] = {};
+    FrameRing<HAL_CAN_TX_QUEUE_SIZE> tx_queue_[TX_PRIORITY_COUNT];
+    uint32_t tx_enqueued_[TX_PRIORITY_COUNT] = {0};
+
+    FrameRing<HAL_CAN_RX_RING_SIZE> rx_ring_;
+    HAL::DELEGATE::CallbackRegistry<RxCallback, HAL_CAN_MAX_RX_CALLBACKS> rx_callbacks_;
+    CanIdRouter id_router_;
+
+    FilterId filter_ids_[MAX_FILTER_IDS] = {};
+    uint8_t filter_count_ = 0;
+    bool filter_enabled_ = false;
+
+    BusStats stats_ = {};
+    FrameCopyStats copies_ = {};
+    uint32_t stats_last_ms_ = 0;
+    uint32_t stats_last_rx_frames_ = 0;
+    uint32_t stats_last_tx_frames_ = 0;
+    uint64_t stats_last_busy_ns_ = 0;
+
+    // 由虚拟总线调用
+    bool free_mailbox_available() const;
+    bool mailbox_has_id(const Frame &frame) const;
+    void deliver(const Frame &frame);
+    void complete_mailbox(uint8_t index);
+    bool accepts(const Frame &frame) const;
+};
+
+/**
+ * @brief 虚拟CAN总线（一条物理线）
+ *
+ * 多个VirtualCanDevice挂在同一条线上，按以下规则仿真：
+ * - 总线空闲时，所有节点邮箱中仲裁段最小（ID越小优先级越高，同基本ID时标准帧优先）的帧获得总线
+ * - 帧占用时间 = frame_bits_worst_case() / 波特率（按最坏位填充估算）
+ * - 发送完成后经过固定的传输延迟投递给除发送者以外的所有节点，并触发发送邮箱空
+ * - 时间只在run_until()中推进，结果完全确定
+ */
+class VirtualCanWire
+{
+  public:
+    explicit VirtualCanWire(uint32_t bitrate = 1000000, uint32_t latency_us = 0);
+
+    VirtualCanWire(const VirtualCanWire &) = delete;
+    VirtualCanWire &operator=(const VirtualCanWire &) = delete;
+
+    // 把节点挂到总线上，节点已满时返回false
+    bool attach(VirtualCanDevice &node);
+
+    void set_bitrate(uint32_t bitrate)
+    {
+        bitrate_ = bitrate;
+    }
+    uint32_t bitrate() const
+    {
+        return bitrate_;
+    }
+
+    void set_latency_us(uint32_t latency_us)
+    {
+        latency_ns_ = (uint64_t)latency_us * 1000;
+    }
+
+    // 仿真到指定时刻（纳秒）
+    void run_until(uint64_t t_ns);
+
+    // 总线累计占用时间（纳秒）
+    uint64_t busy_ns() const
+    {
+        return busy_ns_;
+    }
+
+    // 投递时在途队列已满而被丢弃的帧数
+    uint32_t dropped() const
+    {
+        return dropped_;
+    }
+
+#ifdef HAL_CAN_VIRTUAL_SOCKETCAN
+    /**
+     * @brief 绑定SocketCAN接口（如vcan0），总线上的帧同时写入该接口，接口收到的帧投递给所有节点
+     *
+     * @return false 接口不存在或没有权限
+     */
+    bool bind_socketcan(const char *ifname);
+#endif
+
+  private:
+    struct InFlight
+    {
+        uint64_t deliver_at;
+        Frame frame;
+        int8_t src;
+    };
+
+    uint32_t bitrate_;
+    uint64_t latency_ns_;
+    uint64_t now_ns_ = 0;
+
+    VirtualCanDevice *nodes_[HAL_CAN_VIRTUAL_MAX_NODES] = {nullptr};
+    uint8_t node_count_ = 0;
+
+    // 正在发送的帧
+    bool busy_ = false;
+    uint64_t tx_end_ns_ = 0;
+    int8_t tx_node_ = -1;
+    uint8_t tx_mailbox_ = 0;
+
+    // 传输延迟期间的在途帧（延迟固定，按完成顺序投递）
+    InFlight in_flight_[HAL_CAN_VIRTUAL_MAX_IN_FLIGHT];
+    uint32_t in_flight_head_ = 0;
+    uint32_t in_flight_count_ = 0;
+
+    uint64_t busy_ns_ = 0;
+    uint32_t dropped_ = 0;
+
+#ifdef HAL_CAN_VIRTUAL_SOCKETCAN
+    int socket_fd_ = -1;
+    void poll_socketcan();
+    void write_socketcan(const Frame &frame);
+#endif
+
+    friend class VirtualCanDevice;
+
+    // 帧的仲裁段，越小优先级越高
+    static uint64_t arbitration_key(const Frame &frame);
+
+    bool arbitrate();
+    void finish_tx();
+    void deliver(const Frame &frame, int8_t src);
+};
+
+/**
+ * @brief 虚拟CAN总线管理，定义HAL_CAN_VIRTUAL时由get_can_bus_instance()返回
+ *
+ * 每个CanDeviceId对应一条虚拟总线，总线上默认挂两个节点：
+ * - get_device(id)：本机（电机驱动等代码使用的设备）
+ * - peer(id)：对端，用于在测试中模拟电机发送反馈、检查控制帧
+ */
+class VirtualCanBus : public ICanBus
+{
+  public:
+    static VirtualCanBus &instance();
+
+    ICanDevice &get_device(CanDeviceId id) override;
+    bool has_device(CanDeviceId id) const override;
+    ICanDevice *find_device(const CAN_HandleTypeDef *handle) override;
+
+    // 本机节点，与get_device()为同一个设备，可读取PC端才有的统计
+    VirtualCanDevice &local(CanDeviceId id);
+
+    // 对端节点
+    VirtualCanDevice &peer(CanDeviceId id);
+
+    // 虚拟总线，可用于修改波特率、延迟或挂更多节点
+    VirtualCanWire &wire(CanDeviceId id);
+
+    // 所有总线向前仿真us微秒，并推进仿真时钟
+    void run_for_us(uint32_t us);
+
+  private:
+    VirtualCanBus();
+
+    VirtualCanWire wires_[(size_t)CanDeviceId::MAX_DEVICES];
+    VirtualCanDevice devices_[(size_t)CanDeviceId::MAX_DEVICES];
+    VirtualCanDevice peers_[(size_t)CanDeviceId::MAX_DEVICES];
+};
+
+} // namespace HAL::CAN
+
+#endif // HAL_CAN_VIRTUAL
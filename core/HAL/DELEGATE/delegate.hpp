@@ -0,0 +1,164 @@
+/**
+ * @file delegate.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief 不分配堆内存的回调（委托）与固定容量回调表
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace HAL::DELEGATE
+{
+
+// 默认存储大小：可以放下一个函数指针+一个上下文指针，或捕获两个指针的lambda
+constexpr size_t DEFAULT_STORAGE_SIZE = 2 * sizeof(void *);
+
+template <typename Signature, size_t StorageSize = DEFAULT_STORAGE_SIZE> class InplaceFunction;
+
+/**
+ * @brief 固定存储大小的可调用对象包装
+ *
+ * 与std::function用法相同，但可调用对象直接存放在对象内部，不会分配堆内存：
+ * - 可调用对象的大小超过StorageSize时编译报错
+ * - 只接受可平凡复制、平凡析构的可调用对象（函数指针、捕获指针/整数的lambda），
+ *   复制时按字节拷贝，没有额外的管理函数
+ * - 调用只有一次函数指针跳转
+ *
+ * @tparam R 返回值类型
+ * @tparam Args 参数类型
+ * @tparam StorageSize 内部存储大小（字节）
+ */
+template <typename R, typename... Args, size_t StorageSize> class InplaceFunction<R(Args...), StorageSize>
+{
+  public:
+    InplaceFunction() = default;
+
+    InplaceFunction(std::nullptr_t)
+    {
+    }
+
+    template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, InplaceFunction>::value>>
+    InplaceFunction(F &&f)
+    {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= StorageSize, "可调用对象超出InplaceFunction的存储大小，请增大StorageSize");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "可调用对象的对齐要求过高");
+        static_assert(std::is_trivially_copyable<Fn>::value && std::is_trivially_destructible<Fn>::value,
+                      "InplaceFunction只接受可平凡复制的可调用对象（函数指针或只捕获指针/数值的lambda）");
+
+        if constexpr (std::is_pointer<Fn>::value)
+        {
+            // 传入函数名时F为函数引用，先退化为指针再判空
+            const Fn fn = f;
+            if (fn == nullptr)
+            {
+                return;
+            }
+        }
+
+        ::new (static_cast<void *>(storage_)) Fn(std::forward<F>(f));
+        invoker_ = &invoke<Fn>;
+    }
+
+    /**
+     * @brief 由函数指针和上下文指针构造
+     *
+     * @param fn 第一个参数为上下文指针的函数
+     * @param ctx 上下文指针
+     */
+    static InplaceFunction bind(R (*fn)(void *, Args...), void *ctx)
+    {
+        if (fn == nullptr)
+        {
+            return InplaceFunction();
+        }
+        return InplaceFunction([fn, ctx](Args... args) -> R { return fn(ctx, std::forward<Args>(args)...); });
+    }
+
+    R operator()(Args... args) const
+    {
+        return invoker_(storage_, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const
+    {
+        return invoker_ != nullptr;
+    }
+
+    static constexpr size_t storage_size()
+    {
+        return StorageSize;
+    }
+
+  private:
+    using Invoker = R (*)(void *, Args...);
+
+    template <typename Fn> static R invoke(void *storage, Args... args)
+    {
+        return (*static_cast<Fn *>(storage))(std::forward<Args>(args)...);
+    }
+
+    // 调用时允许修改存储内容（mutable lambda）
+    alignas(std::max_align_t) mutable unsigned char storage_[StorageSize] = {};
+    Invoker invoker_ = nullptr;
+};
+
+/**
+ * @brief 固定容量的回调表
+ *
+ * 代替std::vector<std::function>，容量在编译期确定，注册满后add()返回false
+ *
+ * @tparam Fn 回调类型（通常为InplaceFunction）
+ * @tparam Capacity 回调数量上限
+ */
+template <typename Fn, size_t Capacity> class CallbackRegistry
+{
+    static_assert(Capacity > 0, "回调表容量不能为0");
+    static_assert(Capacity <= 32, "回调表按顺序遍历，容量过大请改用ID路由表");
+
+  public:
+    // 注册回调，回调为空或表已满时返回false
+    bool add(const Fn &fn)
+    {
+        if (!fn || count_ >= Capacity)
+        {
+            return false;
+        }
+        items_[count_++] = fn;
+        return true;
+    }
+
+    // 按注册顺序依次调用
+    template <typename... Args> void invoke(Args &&...args) const
+    {
+        for (size_t i = 0; i < count_; ++i)
+        {
+            items_[i](args...);
+        }
+    }
+
+    size_t size() const
+    {
+        return count_;
+    }
+
+    static constexpr size_t capacity()
+    {
+        return Capacity;
+    }
+
+  private:
+    Fn items_[Capacity];
+    size_t count_ = 0;
+};
+
+} // namespace HAL::DELEGATE
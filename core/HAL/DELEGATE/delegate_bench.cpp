@@ -0,0 +1,160 @@
+#include "delegate_bench.hpp"
+
+#include "../CAN/interface/can_device.hpp"
+#include "delegate.hpp"
+#include <functional>
+#include <vector>
+
+#ifdef HAL_CAN_VIRTUAL
+#include <chrono>
+#include <cstdio>
+#else
+#include "../LOGGER/logger.hpp"
+#include "main.h"
+#endif
+
+namespace HAL::DELEGATE
+{
+namespace
+{
+constexpr uint8_t MAX_CALLBACKS = 8;
+constexpr uint8_t FRAME_KINDS = 8;
+
+using Registry = CallbackRegistry<CAN::RxCallback, MAX_CALLBACKS>;
+using FunctionList = std::vector<std::function<void(const CAN::Frame &)>>;
+
+// 每个回调对应一个“电机”：只处理自己的反馈ID
+struct Slot
+{
+    CAN::ID_t id;
+    uint32_t sum;
+};
+
+Slot slots[MAX_CALLBACKS];
+CAN::Frame frames_in[FRAME_KINDS];
+
+// 对照循环的结果经过volatile变量，避免被编译器移出循环
+volatile uint32_t sink;
+
+// 分发放在不内联的函数中，与CanDevice::trigger_rx_callbacks()一样经过一次调用
+__attribute__((noinline)) void dispatch(const Registry &registry, const CAN::Frame &frame)
+{
+    registry.invoke(frame);
+}
+
+__attribute__((noinline)) void dispatch(const FunctionList &list, const CAN::Frame &frame)
+{
+    for (const auto &fn : list)
+    {
+        fn(frame);
+    }
+}
+
+#ifdef HAL_CAN_VIRTUAL
+// 返回n次fn的总耗时（纳秒）
+template <typename Fn> uint64_t Measure(uint32_t n, Fn fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        fn(frames_in[i % FRAME_KINDS]);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+#else
+// 关中断返回n次fn的总周期数
+template <typename Fn> uint64_t Measure(uint32_t n, Fn fn)
+{
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    const uint32_t start = DWT->CYCCNT;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        fn(frames_in[i % FRAME_KINDS]);
+    }
+    const uint32_t elapsed = DWT->CYCCNT - start;
+    __set_PRIMASK(primask);
+    return elapsed;
+}
+#endif
+
+uint32_t sum_slots(uint8_t callbacks)
+{
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < callbacks; ++i)
+    {
+        sum += slots[i].sum;
+        slots[i].sum = 0;
+    }
+    return sum;
+}
+
+// 扣除取帧和循环的开销
+uint32_t Net_x100(uint64_t measured, uint64_t baseline, uint32_t frames)
+{
+    return measured > baseline ? (uint32_t)((measured - baseline) * 100 / frames) : 0;
+}
+} // namespace
+
+DelegateBenchResult RunDelegateBenchmark(uint32_t frames, uint8_t callbacks)
+{
+    DelegateBenchResult result = {};
+    if (frames == 0 || callbacks == 0 || callbacks > MAX_CALLBACKS)
+    {
+        return result;
+    }
+    result.frames = frames;
+    result.callbacks = callbacks;
+
+    for (uint8_t i = 0; i < FRAME_KINDS; ++i)
+    {
+        frames_in[i] = CAN::Frame::make(0x201 + i);
+        frames_in[i].data[0] = i + 1;
+    }
+
+    Registry registry;
+    FunctionList list;
+    for (uint8_t i = 0; i < callbacks; ++i)
+    {
+        slots[i] = {(CAN::ID_t)(0x201 + i), 0};
+        Slot *slot = &slots[i];
+        auto parse = [slot](const CAN::Frame &frame) {
+            if (frame.id == slot->id)
+            {
+                slot->sum += frame.data[0];
+            }
+        };
+        registry.add(parse);
+        list.emplace_back(parse);
+    }
+
+    const uint64_t baseline = Measure(frames, [](const CAN::Frame &frame) { sink = frame.data[0]; });
+    const uint64_t registry_time = Measure(frames, [&registry](const CAN::Frame &frame) { dispatch(registry, frame); });
+    const uint32_t registry_sum = sum_slots(callbacks);
+    const uint64_t function_time = Measure(frames, [&list](const CAN::Frame &frame) { dispatch(list, frame); });
+    const uint32_t function_sum = sum_slots(callbacks);
+
+    result.registry_x100 = Net_x100(registry_time, baseline, frames);
+    result.function_x100 = Net_x100(function_time, baseline, frames);
+    result.same_result = registry_sum == function_sum && registry_sum != 0;
+    return result;
+}
+
+void LogDelegateBenchmark(uint32_t frames, uint8_t callbacks)
+{
+    const DelegateBenchResult r = RunDelegateBenchmark(frames, callbacks);
+#ifdef HAL_CAN_VIRTUAL
+    std::printf("delegate ns/frame (%u frames, %u callbacks): CallbackRegistry %u.%02u std::function %u.%02u%s\n",
+                r.frames, r.callbacks, r.registry_x100 / 100, r.registry_x100 % 100, r.function_x100 / 100,
+                r.function_x100 % 100, r.same_result ? "" : " (mismatch)");
+#else
+    HAL::LOGGER::Logger::getInstance().log(
+        HAL::LOGGER::LogLevel::INFO,
+        "delegate cycles/frame (%u frames, %u callbacks): CallbackRegistry %u.%02u std::function %u.%02u%s", r.frames,
+        r.callbacks, r.registry_x100 / 100, r.registry_x100 % 100, r.function_x100 / 100, r.function_x100 % 100,
+        r.same_result ? "" : " (mismatch)");
+#endif
+}
+
+} // namespace HAL::DELEGATE
@@ -0,0 +1,42 @@
+/**
+ * @file delegate_bench.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief CallbackRegistry与std::vector<std::function>的接收回调分发开销对比
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace HAL::DELEGATE
+{
+
+// 每帧的平均分发耗时×100，目标板为周期数，PC端（HAL_CAN_VIRTUAL）为纳秒
+struct DelegateBenchResult
+{
+    uint32_t frames;        // 分发的帧数
+    uint8_t callbacks;      // 每帧调用的回调数
+    uint32_t registry_x100; // CallbackRegistry<CAN::RxCallback>（CAN/UART的register_rx_callback()）
+    uint32_t function_x100; // 对照：std::vector<std::function<void(const Frame &)>>
+    bool same_result;       // 两种方式的回调累加结果一致
+};
+
+/**
+ * @brief 两种回调表注册相同的callbacks个回调（按ID比较并累加，模拟电机的Parse()），各分发frames帧
+ *
+ * 目标板上用CYCCNT计时，每一项测量期间关中断（frames = 1000、4个回调时每项约0.3 ms）；
+ * 对照组的std::vector和std::function从C库堆分配，只在初始化阶段或调试时调用
+ *
+ * @param callbacks 回调数，1~8
+ */
+DelegateBenchResult RunDelegateBenchmark(uint32_t frames = 1000, uint8_t callbacks = 4);
+
+// 测量并打印，目标板打印到日志（RTT），PC端打印到标准输出
+void LogDelegateBenchmark(uint32_t frames = 1000, uint8_t callbacks = 4);
+
+} // namespace HAL::DELEGATE
@@ -1,4 +1,24 @@
 #include "DWT.hpp"
+
+namespace HAL
+{
+// 只做整数运算，PC端的DWTimer::Init()同样使用
+void DWTimer::MakeReciprocal(uint32_t d, uint32_t &mult, uint8_t &shift)
+{
+    shift = 0;
+    while ((1ull << shift) < d)
+    {
+        ++shift;
+    }
+    const uint64_t scale = 1ull << (32 + shift);
+    mult = static_cast<uint32_t>((scale + d - 1) / d - (1ull << 32));
+}
+} // namespace HAL
+
+// PC端（HAL_CAN_VIRTUAL）由CAN/virtual/host/host_hal.cpp按仿真时钟实现
+#ifndef HAL_CAN_VIRTUAL
+
+#include "../IRQ/irq_lock.hpp"
 #include "main.h"
 
 namespace HAL
@@ -10,7 +30,7 @@ namespace HAL
  *
  * @param CPU_mHz 单片机主频
  */
-DWTimer::DWTimer(uint32_t CPU_mHz) : CPU_Freq_mHz(CPU_mHz), CYCCNT_LAST(0), CYCCNT_RountCount(0), CYCCNT64(0)
+DWTimer::DWTimer(uint32_t CPU_mHz) : CPU_Freq_mHz(CPU_mHz)
 {
     Init();
 }
@@ -20,16 +40,23 @@ void DWTimer::Init()
     // 使能DWT外设
     CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
 
-    // 清零CYCCNT寄存器
-    DWT->CYCCNT = 0;
-
-    // 使能CYCCNT寄存器
-    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
-
     // 初始化CPU频率相关参数
     CPU_FREQ_Hz = CPU_Freq_mHz * 1000000;
     CPU_FREQ_Hz_ms = CPU_FREQ_Hz / 1000;
     CPU_FREQ_Hz_us = CPU_FREQ_Hz / 1000000;
+    MakeReciprocal(CPU_FREQ_Hz_us, us_mult_, us_shift_);
+    MakeReciprocal(CPU_FREQ_Hz_ms, ms_mult_, ms_shift_);
+
+    // 清零CYCCNT与时间轴基准，节拍中断可能已经在调用Tick()
+    IrqLock lock;
+    DWT->CYCCNT = 0;
+    base_cycles_ = 0;
+    base_us_ = 0;
+    base_rem_ = 0;
+    seq_ = seq_ + 1;
+
+    // 使能CYCCNT寄存器
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
 
 float DWTimer::GetDeltaT(uint32_t *cnt_last)
@@ -37,8 +64,6 @@ float DWTimer::GetDeltaT(uint32_t *cnt_last)
     uint32_t cnt_now = DWT->CYCCNT;
     float dt = (cnt_now - *cnt_last) / static_cast<float>(CPU_FREQ_Hz);
     *cnt_last = cnt_now;
-
-    UpdateCYCCNT();
     return dt;
 }
 
@@ -47,50 +72,80 @@ double DWTimer::GetDeltaT64(uint32_t *cnt_last)
     uint32_t cnt_now = DWT->CYCCNT;
     double dt = (cnt_now - *cnt_last) / static_cast<double>(CPU_FREQ_Hz);
     *cnt_last = cnt_now;
-
-    UpdateCYCCNT();
     return dt;
 }
 
-void DWTimer::UpdateCYCCNT()
+void DWTimer::Tick()
 {
-    uint32_t cnt_now = DWT->CYCCNT;
+    // DWTimer构造之前CYCCNT未打开
+    if (CPU_FREQ_Hz_us == 0)
+    {
+        return;
+    }
 
-    if (cnt_now < CYCCNT_LAST.load())
-        CYCCNT_RountCount++;
+    IrqLock lock;
+    const uint32_t delta = DWT->CYCCNT - static_cast<uint32_t>(base_cycles_);
+    base_cycles_ += delta;
 
-    CYCCNT_LAST.store(cnt_now);
+    // 只有这里做除法（32位，硬件UDIV），读取时只需一次乘法
+    const uint32_t cycles = base_rem_ + delta;
+    const uint32_t us = cycles / CPU_FREQ_Hz_us;
+    base_us_ += us;
+    base_rem_ = cycles - us * CPU_FREQ_Hz_us;
+    seq_ = seq_ + 1;
 }
 
-void DWTimer::UpdateSysTime()
+uint64_t DWTimer::GetCycles64()
 {
-    uint32_t cnt_now = DWT->CYCCNT;
-    UpdateCYCCNT();
-
-    CYCCNT64 = static_cast<uint64_t>(CYCCNT_RountCount.load()) * std::numeric_limits<uint32_t>::max() + cnt_now;
+    uint32_t seq;
+    uint64_t base;
+    uint32_t now;
+    do
+    {
+        seq = seq_;
+        std::atomic_signal_fence(std::memory_order_acquire);
+        base = base_cycles_;
+        now = DWT->CYCCNT;
+        std::atomic_signal_fence(std::memory_order_acquire);
+    } while (seq != seq_);
+
+    return base + (now - static_cast<uint32_t>(base));
+}
 
-    SysTime.seconds = CYCCNT64 / CPU_FREQ_Hz;
-    uint64_t remainder = CYCCNT64 % CPU_FREQ_Hz;
-    SysTime.milliseconds = remainder / CPU_FREQ_Hz_ms;
-    SysTime.microseconds = (remainder % CPU_FREQ_Hz_ms) / CPU_FREQ_Hz_us;
+uint64_t DWTimer::GetTimeline_us()
+{
+    uint32_t seq;
+    uint64_t base_us;
+    uint32_t rem;
+    uint32_t base_low;
+    uint32_t now;
+    do
+    {
+        seq = seq_;
+        std::atomic_signal_fence(std::memory_order_acquire);
+        base_us = base_us_;
+        rem = base_rem_;
+        base_low = static_cast<uint32_t>(base_cycles_);
+        now = DWT->CYCCNT;
+        std::atomic_signal_fence(std::memory_order_acquire);
+    } while (seq != seq_);
+
+    return base_us + CyclesToUs(rem + (now - base_low));
 }
 
 float DWTimer::GetTimeline_s()
 {
-    UpdateSysTime();
-    return SysTime.seconds + SysTime.milliseconds * 0.001f + SysTime.microseconds * 0.000001f;
+    return static_cast<float>(GetTimeline_us()) * 0.000001f;
 }
 
 float DWTimer::GetTimeline_ms()
 {
-    UpdateSysTime();
-    return SysTime.seconds * 1000 + SysTime.milliseconds + SysTime.microseconds * 0.001f;
+    return static_cast<float>(GetTimeline_us()) * 0.001f;
 }
 
-uint64_t DWTimer::GetTimeline_us()
+uint32_t DWTimer::GetCycles()
 {
-    UpdateSysTime();
-    return SysTime.seconds * 1000000 + SysTime.milliseconds * 1000 + SysTime.microseconds;
+    return DWT->CYCCNT;
 }
 
 void DWTimer::Delay(float seconds)
@@ -102,4 +157,15 @@ void DWTimer::Delay(float seconds)
     {
     }
 }
-} // namespace HAL
\ No newline at end of file
+} // namespace HAL
+
+#if HAL_DWT_TICK_HOOK
+// 覆盖stm32f4xx_hal.c中的弱定义：HAL时基中断每毫秒调用一次，同时推进DWT时间轴
+extern "C" void HAL_IncTick(void)
+{
+    uwTick += uwTickFreq;
+    HAL::DWTimer::Tick();
+}
+#endif
+
+#endif // HAL_CAN_VIRTUAL
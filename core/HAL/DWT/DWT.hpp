@@ -15,6 +15,12 @@
 #include <chrono>
 #include <cstdint>
 
+// 为1时DWT.cpp覆盖HAL库的弱函数HAL_IncTick()，在HAL时基中断（1 kHz）中调用DWTimer::Tick()；
+// 工程自己实现HAL_IncTick()时定义为0，并在其中调用DWTimer::Tick()
+#ifndef HAL_DWT_TICK_HOOK
+#define HAL_DWT_TICK_HOOK 1
+#endif
+
 namespace HAL
 {
 
@@ -63,11 +69,13 @@ class DWTimer
     float GetTimeline_ms();
 
     /**
-     * @brief 获取时间轴长度（微秒）
+     * @brief 获取时间轴长度（微秒），可在中断中调用
+     *
+     * 由Tick()维护的微秒基准加上之后的周期增量换算得到，不做64位除法
      *
      * @return uint64_t
      */
-    uint64_t GetTimeline_us();
+    static uint64_t GetTimeline_us();
 
     /**
      * @brief 延时函数
@@ -77,47 +85,96 @@ class DWTimer
 
     void Delay(float seconds);
 
-  private:
-    // 构造函数私有化
-    explicit DWTimer(uint32_t CPU_mHz);
+    /**
+     * @brief 读取当前周期计数（CYCCNT）
+     *
+     * 32位计数，168 MHz下约25.5秒回绕一次，两次读数相减可得到不超过该范围的时间差
+     *
+     * @return uint32_t
+     */
+    static uint32_t GetCycles();
 
     /**
-     * @brief 初始化函数
+     * @brief 读取64位周期计数，不回绕，可在任务和中断中调用
      *
+     * 由Tick()记录的基准加上CYCCNT的增量得到，两次Tick()的间隔不能超过一次CYCCNT回绕（168 MHz下约25.5秒）。
+     * 读取时不关中断，基准在读取过程中被更新时重读
+     *
+     * @return uint64_t
      */
-    void Init();
+    static uint64_t GetCycles64();
 
     /**
-     * @brief 更新sys周期数，将计数器转化为时间单位
+     * @brief 节拍钩子：推进64位周期计数和微秒时间轴的基准
      *
+     * 默认由HAL_IncTick()每毫秒调用一次（见HAL_DWT_TICK_HOOK），可在任意上下文调用
      */
-    void UpdateSysTime();
+    static void Tick();
 
     /**
-     * @brief 更新CYCCNT计数器
+     * @brief 周期数换算为微秒，向下取整，结果精确
      *
+     * 用乘法和移位代替除法（每微秒周期数在Init()中换算为33位倒数），一次32×32位乘法
+     */
+    static uint32_t CyclesToUs(uint32_t cycles)
+    {
+        return Divide(cycles, us_mult_, us_shift_);
+    }
+
+    /**
+     * @brief 周期数换算为毫秒，向下取整，结果精确
      */
-    void UpdateCYCCNT();
+    static uint32_t CyclesToMs(uint32_t cycles)
+    {
+        return Divide(cycles, ms_mult_, ms_shift_);
+    }
 
-    // 时间结构体
-    struct DWT_Time
+    /**
+     * @brief 获取每微秒周期数
+     *
+     * @return uint32_t
+     */
+    uint32_t GetCyclesPerUs() const
     {
-        uint32_t seconds;
-        uint16_t milliseconds;
-        uint16_t microseconds;
-    };
+        return CPU_FREQ_Hz_us;
+    }
+
+  private:
+    // 构造函数私有化
+    explicit DWTimer(uint32_t CPU_mHz);
+
+    /**
+     * @brief 初始化函数：打开并清零CYCCNT，清零时间轴基准，计算换算系数
+     *
+     */
+    void Init();
 
     // 成员变量
-    const uint32_t CPU_Freq_mHz; // CPU频率（MHz）
-    uint32_t CPU_FREQ_Hz;        // CPU频率（Hz）
-    uint32_t CPU_FREQ_Hz_ms;     // 每毫秒周期数
-    uint32_t CPU_FREQ_Hz_us;     // 每微秒周期数
+    const uint32_t CPU_Freq_mHz;           // CPU频率（MHz）
+    uint32_t CPU_FREQ_Hz;                  // CPU频率（Hz）
+    uint32_t CPU_FREQ_Hz_ms;               // 每毫秒周期数
+    inline static uint32_t CPU_FREQ_Hz_us; // 每微秒周期数（Tick()中使用，为静态成员）
+
+    // 除数d的倒数：shift = ceil(log2(d))，mult = ceil(2^(32 + shift) / d) - 2^32，对全部32位被除数精确
+    inline static uint32_t us_mult_;
+    inline static uint32_t ms_mult_;
+    inline static uint8_t us_shift_;
+    inline static uint8_t ms_shift_;
+
+    static uint32_t Divide(uint32_t x, uint32_t mult, uint8_t shift)
+    {
+        const uint64_t t = (static_cast<uint64_t>(x) * mult) >> 32;
+        return static_cast<uint32_t>((t + x) >> shift);
+    }
 
-    std::atomic<uint32_t> CYCCNT_LAST;       // 上一次CYCCNT值
-    std::atomic<uint32_t> CYCCNT_RountCount; // 溢出计数
+    // 计算除以d的倒数
+    static void MakeReciprocal(uint32_t d, uint32_t &mult, uint8_t &shift);
 
-    uint64_t CYCCNT64; // 64位计数值
-    DWT_Time SysTime;  // 系统时间
+    // 时间轴基准，由Tick()关中断更新；seq_每次更新加1，读取方前后两次读到的seq_不同时重读
+    inline static volatile uint32_t seq_;
+    inline static uint64_t base_cycles_; // 上次更新时的64位周期数，低32位即当时的CYCCNT
+    inline static uint64_t base_us_;     // base_cycles_换算的微秒数（向下取整）
+    inline static uint32_t base_rem_;    // base_cycles_中不足1微秒的周期数
 };
 
 } // namespace HAL::DWTimer
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "DWT_bench.hpp"
+
+// 只在目标板上测量
+#ifndef HAL_CAN_VIRTUAL
+
+#include "../LOGGER/logger.hpp"
+#include "DWT.hpp"
+#include "main.h"
+
+namespace HAL
+{
+namespace
+{
+// 输入和结果经过volatile变量，避免被编译器移出循环
+volatile uint32_t input32 = 0x12345678;
+volatile uint64_t input64 = 0x123456789ull;
+volatile uint32_t sink32;
+volatile uint64_t sink64;
+
+// 关中断循环调用fn，返回平均每次的周期数
+template <typename Fn> uint32_t Measure(uint32_t iterations, Fn fn)
+{
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    const uint32_t start = DWT->CYCCNT;
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        fn();
+    }
+    const uint32_t elapsed = DWT->CYCCNT - start;
+    __set_PRIMASK(primask);
+    return elapsed / iterations;
+}
+
+// 扣除空循环开销（读输入、写结果）
+uint32_t Net(uint32_t measured, uint32_t baseline)
+{
+    return measured > baseline ? measured - baseline : 0;
+}
+} // namespace
+
+DWTBenchResult RunDWTBenchmark(uint32_t iterations)
+{
+    DWTBenchResult result = {};
+    if (iterations == 0)
+    {
+        return result;
+    }
+
+    const uint32_t cycles_per_us = DWTimer::getInstance().GetCyclesPerUs();
+    const uint32_t base32 = Measure(iterations, [] { sink32 = input32; });
+    const uint32_t base64 = Measure(iterations, [] { sink64 = input64; });
+
+    result.get_cycles = Net(Measure(iterations, [] { sink32 = DWTimer::GetCycles(); }), base32);
+    result.get_cycles64 = Net(Measure(iterations, [] { sink64 = DWTimer::GetCycles64(); }), base64);
+    result.timeline_us = Net(Measure(iterations, [] { sink64 = DWTimer::GetTimeline_us(); }), base64);
+    result.cycles_to_us = Net(Measure(iterations, [] { sink32 = DWTimer::CyclesToUs(input32); }), base32);
+    result.cycles_to_ms = Net(Measure(iterations, [] { sink32 = DWTimer::CyclesToMs(input32); }), base32);
+    result.divide_us64 = Net(Measure(iterations, [cycles_per_us] { sink64 = input64 / cycles_per_us; }), base64);
+    return result;
+}
+
+void LogDWTBenchmark(uint32_t iterations)
+{
+    const DWTBenchResult r = RunDWTBenchmark(iterations);
+    HAL::LOGGER::Logger::getInstance().log(
+        HAL::LOGGER::LogLevel::INFO,
+        "DWT cycles/call: GetCycles %u GetCycles64 %u GetTimeline_us %u CyclesToUs %u CyclesToMs %u div64 %u",
+        r.get_cycles, r.get_cycles64, r.timeline_us, r.cycles_to_us, r.cycles_to_ms, r.divide_us64);
+}
+
+} // namespace HAL
+
+#endif // HAL_CAN_VIRTUAL
@@ -0,0 +1,40 @@
+/**
+ * @file DWT_bench.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief DWT时间接口的单次调用开销测量
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace HAL
+{
+
+// 每次调用的平均周期数，已扣除循环本身的开销
+struct DWTBenchResult
+{
+    uint32_t get_cycles;   // GetCycles()
+    uint32_t get_cycles64; // GetCycles64()
+    uint32_t timeline_us;  // GetTimeline_us()
+    uint32_t cycles_to_us; // CyclesToUs()
+    uint32_t cycles_to_ms; // CyclesToMs()
+    uint32_t divide_us64;  // 对照：64位周期数除法换算微秒（原GetTimeline_us()的做法，不含取模）
+};
+
+/**
+ * @brief 逐项循环调用iterations次并用CYCCNT计时
+ *
+ * 每一项测量期间关中断（iterations = 1000时每项不超过约1 ms），在初始化阶段或调试时调用
+ */
+DWTBenchResult RunDWTBenchmark(uint32_t iterations = 1000);
+
+// 测量并打印到日志（RTT）
+void LogDWTBenchmark(uint32_t iterations = 1000);
+
+} // namespace HAL
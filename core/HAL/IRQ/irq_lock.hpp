@@ -0,0 +1,57 @@
+/**
+ * @file irq_lock.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief 关中断临界区
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+
+#include "main.h"
+#include <cstdint>
+
+namespace HAL
+{
+/**
+ * @brief 关中断临界区（RAII），可在任务和中断中嵌套使用
+ *
+ * 构造时保存PRIMASK并关中断，析构时恢复保存的值，嵌套时只有最外层恢复后才重新开中断。
+ * PC端（HAL_CAN_VIRTUAL）仿真为单线程，不需要加锁
+ *
+ * @code
+ * {
+ *     HAL::IrqLock lock;
+ *     // 与中断共享的数据
+ * }
+ * @endcode
+ */
+class IrqLock
+{
+  public:
+#ifdef HAL_CAN_VIRTUAL
+    IrqLock()
+    {
+    }
+#else
+    IrqLock() : primask_(__get_PRIMASK())
+    {
+        __disable_irq();
+    }
+    ~IrqLock()
+    {
+        __set_PRIMASK(primask_);
+    }
+
+  private:
+    uint32_t primask_;
+#endif
+
+  public:
+    IrqLock(const IrqLock &) = delete;
+    IrqLock &operator=(const IrqLock &) = delete;
+};
+} // namespace HAL
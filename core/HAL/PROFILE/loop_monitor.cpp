@@ -0,0 +1,215 @@
+#include "loop_monitor.hpp"
+#include "../DWT/DWT.hpp"
+#include "../IRQ/irq_lock.hpp"
+
+// PC端（HAL_CAN_VIRTUAL）时间取自仿真时钟，报告打印到标准输出
+#ifdef HAL_CAN_VIRTUAL
+#include <cstdio>
+#else
+#include "../LOGGER/logger.hpp"
+#endif
+
+namespace HAL::PROFILE
+{
+
+namespace
+{
+// 抖动所在的桶
+uint8_t jitter_bucket(uint32_t us)
+{
+    if (us < LOOP_JITTER_SUB_BUCKETS)
+    {
+        return (uint8_t)us;
+    }
+    const uint32_t exponent = 31 - __builtin_clz(us); // >= 3，Cortex-M4上为一条CLZ指令
+    if (exponent > LOOP_JITTER_MAX_EXPONENT)
+    {
+        return LOOP_JITTER_BUCKETS - 1;
+    }
+    const uint32_t shift = exponent - 3;
+    return (uint8_t)(LOOP_JITTER_SUB_BUCKETS * (exponent - 2) + ((us >> shift) & (LOOP_JITTER_SUB_BUCKETS - 1)));
+}
+
+// 桶内的最大值（最后一个桶不设上限）
+uint32_t jitter_bucket_upper(uint8_t bucket)
+{
+    if (bucket == LOOP_JITTER_BUCKETS - 1)
+    {
+        return UINT32_MAX;
+    }
+    if (bucket < LOOP_JITTER_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    const uint32_t shift = bucket / LOOP_JITTER_SUB_BUCKETS - 1;
+    const uint32_t sub = bucket % LOOP_JITTER_SUB_BUCKETS;
+    return ((LOOP_JITTER_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+uint32_t saturate_us(uint64_t us)
+{
+    return us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+}
+} // namespace
+
+void LoopMonitor::tick()
+{
+    const uint64_t now = HAL::DWTimer::GetTimeline_us();
+
+    IrqLock lock;
+    if (!registered_)
+    {
+        registered_ = true;
+        if (monitor_count_ < HAL_LOOP_MAX_MONITORS)
+        {
+            monitors_[monitor_count_++] = this;
+        }
+        else
+        {
+            ++dropped_monitors_;
+        }
+    }
+
+    busy_ = true;
+    if (!started_)
+    {
+        // 第一次只记录时刻
+        started_ = true;
+        last_tick_us_ = now;
+        return;
+    }
+
+    const uint32_t period = saturate_us(now - last_tick_us_);
+    last_tick_us_ = now;
+    const uint32_t jitter = period > period_us_ ? period - period_us_ : period_us_ - period;
+
+    Window &w = window_;
+    ++w.ticks;
+    w.total_period_us += period;
+    w.min_period_us = period < w.min_period_us ? period : w.min_period_us;
+    w.max_period_us = period > w.max_period_us ? period : w.max_period_us;
+    w.jitter_max_us = jitter > w.jitter_max_us ? jitter : w.jitter_max_us;
+    uint16_t &count = w.jitter_histogram[jitter_bucket(jitter)];
+    count = count != UINT16_MAX ? count + 1 : count;
+
+    ++total_ticks_;
+    longest_gap_us_ = period > longest_gap_us_ ? period : longest_gap_us_;
+    if (period > deadline_us_)
+    {
+        ++w.missed;
+        ++total_missed_;
+    }
+}
+
+void LoopMonitor::done()
+{
+    const uint64_t now = HAL::DWTimer::GetTimeline_us();
+
+    IrqLock lock;
+    if (!busy_)
+    {
+        return;
+    }
+    busy_ = false;
+
+    const uint32_t busy = saturate_us(now - last_tick_us_);
+    Window &w = window_;
+    ++w.busy_count;
+    w.total_busy_us += busy;
+    w.max_busy_us = busy > w.max_busy_us ? busy : w.max_busy_us;
+    if (budget_us_ != 0 && busy > budget_us_)
+    {
+        ++w.over_budget;
+    }
+}
+
+LoopStats LoopMonitor::take_stats()
+{
+    Window w;
+    LoopStats stats = {};
+    {
+        // 关中断时间约为拷贝一个Window（约280字节）
+        IrqLock lock;
+        w = window_;
+        window_ = {0, UINT32_MAX, 0, 0, 0, 0, 0, 0, 0, 0, {}};
+        stats.total_ticks = total_ticks_;
+        stats.total_missed = total_missed_;
+        stats.longest_gap_us = longest_gap_us_;
+    }
+
+    stats.ticks = w.ticks;
+    stats.missed = w.missed;
+    stats.over_budget = w.over_budget;
+    stats.max_busy_us = w.max_busy_us;
+    stats.flags = (w.missed != 0 ? LOOP_FLAG_MISSED_DEADLINE : 0) | (w.over_budget != 0 ? LOOP_FLAG_OVER_BUDGET : 0);
+    if (w.busy_count != 0)
+    {
+        stats.mean_busy_us = (uint32_t)(w.total_busy_us / w.busy_count);
+    }
+    if (w.ticks == 0)
+    {
+        return stats;
+    }
+
+    stats.mean_period_us = (uint32_t)(w.total_period_us / w.ticks);
+    stats.min_period_us = w.min_period_us;
+    stats.max_period_us = w.max_period_us;
+    stats.jitter_max_us = w.jitter_max_us;
+
+    // 分位数取所在桶的上限（不超过最大值），计数按直方图（饱和时与ticks不同）
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < LOOP_JITTER_BUCKETS; ++i)
+    {
+        total += w.jitter_histogram[i];
+    }
+    const uint32_t targets[3] = {(total * 50 + 99) / 100, (total * 90 + 99) / 100, (total * 99 + 99) / 100};
+    uint32_t *results[3] = {&stats.jitter_p50_us, &stats.jitter_p90_us, &stats.jitter_p99_us};
+    uint32_t seen = 0;
+    uint8_t next = 0;
+    for (uint8_t i = 0; i < LOOP_JITTER_BUCKETS && next < 3; ++i)
+    {
+        seen += w.jitter_histogram[i];
+        while (next < 3 && seen >= targets[next] && seen != 0)
+        {
+            const uint32_t upper = jitter_bucket_upper(i);
+            *results[next++] = upper < w.jitter_max_us ? upper : w.jitter_max_us;
+        }
+    }
+    return stats;
+}
+
+uint8_t LoopMonitor::monitor_count()
+{
+    return monitor_count_;
+}
+
+LoopMonitor *LoopMonitor::monitor(uint8_t i)
+{
+    return i < monitor_count_ ? monitors_[i] : nullptr;
+}
+
+void LoopMonitor::log_report()
+{
+    for (uint8_t i = 0; i < monitor_count_; ++i)
+    {
+        LoopMonitor &m = *monitors_[i];
+        const LoopStats s = m.take_stats();
+#ifdef HAL_CAN_VIRTUAL
+        std::printf("[%s] loop %s n %u period %u/%u/%u us (min/mean/max, %u) jitter p50 %u p90 %u p99 %u max %u us "
+                    "missed %u busy %u/%u us over %u\n",
+                    s.flags != 0 ? "WARN" : "INFO", m.name(), s.ticks, s.min_period_us, s.mean_period_us,
+                    s.max_period_us, m.period_us(), s.jitter_p50_us, s.jitter_p90_us, s.jitter_p99_us, s.jitter_max_us,
+                    s.missed, s.mean_busy_us, s.max_busy_us, s.over_budget);
+#else
+        const HAL::LOGGER::LogLevel level = s.flags != 0 ? HAL::LOGGER::LogLevel::WARNING : HAL::LOGGER::LogLevel::INFO;
+        HAL::LOGGER::Logger::getInstance().log(
+            level,
+            "loop %s n %u period %u/%u/%u us (min/mean/max, %u) jitter p50 %u p90 %u p99 %u max %u us "
+            "missed %u busy %u/%u us over %u",
+            m.name(), s.ticks, s.min_period_us, s.mean_period_us, s.max_period_us, m.period_us(), s.jitter_p50_us,
+            s.jitter_p90_us, s.jitter_p99_us, s.jitter_max_us, s.missed, s.mean_busy_us, s.max_busy_us, s.over_budget);
+#endif
+    }
+}
+
+} // namespace HAL::PROFILE
@@ -0,0 +1,179 @@
+/**
+ * @file loop_monitor.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief 任务循环周期与抖动监视
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstdint>
+
+// 最多监视的任务数，超出的不统计（计入LoopMonitor::dropped_monitors()）
+#ifndef HAL_LOOP_MAX_MONITORS
+#define HAL_LOOP_MAX_MONITORS 8
+#endif
+
+// 未指定截止时间时，周期超过额定周期的百分之多少算作超时
+#ifndef HAL_LOOP_DEADLINE_PERCENT
+#define HAL_LOOP_DEADLINE_PERCENT 150
+#endif
+
+namespace HAL::PROFILE
+{
+
+// 抖动直方图：0~7 us每1 us一个桶，之后每个2的幂区间分8个桶（相对误差不超过12.5%），最后一个桶不设上限（约61 ms以上）
+constexpr uint8_t LOOP_JITTER_SUB_BUCKETS = 8;
+constexpr uint8_t LOOP_JITTER_MAX_EXPONENT = 15;
+constexpr uint8_t LOOP_JITTER_BUCKETS = LOOP_JITTER_SUB_BUCKETS * (LOOP_JITTER_MAX_EXPONENT - 1);
+
+// LoopStats::flags
+enum LoopFlag : uint8_t
+{
+    LOOP_FLAG_MISSED_DEADLINE = 1 << 0, // 窗口内有周期超过截止时间
+    LOOP_FLAG_OVER_BUDGET = 1 << 1,     // 窗口内有一次执行时间超过预算
+};
+
+// 一个任务在统计窗口内的循环情况，时间单位为微秒
+struct LoopStats
+{
+    uint32_t ticks;           // 窗口内的周期数
+    uint32_t mean_period_us;  // 平均周期
+    uint32_t min_period_us;   // 最短周期
+    uint32_t max_period_us;   // 最长周期（窗口内最长间隔）
+    uint32_t jitter_p50_us;   // 抖动（|周期 - 额定周期|）的中位数
+    uint32_t jitter_p90_us;   // 抖动的90%分位数
+    uint32_t jitter_p99_us;   // 抖动的99%分位数
+    uint32_t jitter_max_us;   // 最大抖动
+    uint32_t missed;          // 周期超过截止时间的次数
+    uint32_t mean_busy_us;    // 平均执行时间（tick()到done()，没有调用done()时为0）
+    uint32_t max_busy_us;     // 最长执行时间
+    uint32_t over_budget;     // 执行时间超过预算的次数
+    uint8_t flags;            // LoopFlag
+    uint32_t total_ticks;     // 启动以来的周期数
+    uint32_t total_missed;    // 启动以来的超时次数
+    uint32_t longest_gap_us;  // 启动以来最长间隔
+};
+
+/**
+ * @brief 任务循环监视器
+ *
+ * 每个任务定义一个静态实例，在每次循环开始时调用tick()，可选在工作结束、osDelay()之前调用done()：
+ * @code
+ * void control(void const *argument)
+ * {
+ *     static HAL::PROFILE::LoopMonitor monitor("control", 1000, 300); // 额定周期1 ms，执行时间预算300 us
+ *     for (;;)
+ *     {
+ *         monitor.tick();
+ *         ...
+ *         monitor.done();
+ *         osDelay(1);
+ *     }
+ * }
+ * @endcode
+ *
+ * 构造为常量初始化，第一次tick()时登记到监视器表；统计按窗口取走，LoopMonitor::log_report()打印全部任务
+ */
+class LoopMonitor
+{
+  public:
+    /**
+     * @param name 任务名
+     * @param period_us 额定周期
+     * @param budget_us 执行时间预算，0为不检查
+     * @param deadline_us 周期超过该值记为超时，0为额定周期的HAL_LOOP_DEADLINE_PERCENT%
+     */
+    constexpr LoopMonitor(const char *name, uint32_t period_us, uint32_t budget_us = 0, uint32_t deadline_us = 0)
+        : name_(name), period_us_(period_us), budget_us_(budget_us),
+          deadline_us_(deadline_us != 0 ? deadline_us : period_us * HAL_LOOP_DEADLINE_PERCENT / 100)
+    {
+    }
+
+    LoopMonitor(const LoopMonitor &) = delete;
+    LoopMonitor &operator=(const LoopMonitor &) = delete;
+
+    // 每次循环开始时调用，记录与上一次的间隔
+    void tick();
+
+    // 本次循环的工作结束时调用（osDelay()之前），记录执行时间
+    void done();
+
+    // 取走窗口统计并清零，在一个任务中调用
+    LoopStats take_stats();
+
+    const char *name() const
+    {
+        return name_;
+    }
+
+    uint32_t period_us() const
+    {
+        return period_us_;
+    }
+
+    uint32_t budget_us() const
+    {
+        return budget_us_;
+    }
+
+    uint32_t deadline_us() const
+    {
+        return deadline_us_;
+    }
+
+    // 已登记的监视器数
+    static uint8_t monitor_count();
+
+    // 第i个监视器，不存在时返回nullptr
+    static LoopMonitor *monitor(uint8_t i);
+
+    // 取走全部任务的窗口统计并打印到日志，有超时或超预算的任务以WARNING打印
+    static void log_report();
+
+    // 监视器表已满而没有登记的监视器数
+    static uint32_t dropped_monitors()
+    {
+        return dropped_monitors_;
+    }
+
+  private:
+    // 窗口内的原始数据，tick()/done()更新，take_stats()换算
+    struct Window
+    {
+        uint32_t ticks;
+        uint32_t min_period_us;
+        uint32_t max_period_us;
+        uint64_t total_period_us;
+        uint32_t jitter_max_us;
+        uint32_t missed;
+        uint32_t busy_count;
+        uint32_t max_busy_us;
+        uint64_t total_busy_us;
+        uint32_t over_budget;
+        uint16_t jitter_histogram[LOOP_JITTER_BUCKETS]; // 饱和计数
+    };
+
+    const char *name_;
+    const uint32_t period_us_;
+    const uint32_t budget_us_;
+    const uint32_t deadline_us_;
+
+    bool registered_ = false;
+    bool started_ = false;
+    bool busy_ = false; // tick()之后还没有done()
+    uint64_t last_tick_us_ = 0;
+    uint32_t total_ticks_ = 0;
+    uint32_t total_missed_ = 0;
+    uint32_t longest_gap_us_ = 0;
+    Window window_ = {0, UINT32_MAX, 0, 0, 0, 0, 0, 0, 0, 0, {}};
+
+    inline static LoopMonitor *monitors_[HAL_LOOP_MAX_MONITORS] = {};
+    inline static uint8_t monitor_count_ = 0;
+    inline static uint32_t dropped_monitors_ = 0;
+};
+
+} // namespace HAL::PROFILE
@@ -0,0 +1,225 @@
+#include "profile.hpp"
+
+#ifdef HAL_PROFILE
+
+#include "../DWT/DWT.hpp"
+#include "../IRQ/irq_lock.hpp"
+#include "../LOGGER/SEGGER/RTT/SEGGER_RTT.h"
+#include "../LOGGER/logger.hpp"
+#include <cstring>
+
+namespace HAL::PROFILE
+{
+
+namespace
+{
+// 记录格式版本
+constexpr uint8_t FORMAT_VERSION = 1;
+constexpr uint8_t WINDOW_RECORD_SIZE = 16;
+constexpr size_t MAX_ZONE_RECORD_SIZE = 8 + MAX_NAME_LENGTH + 20 + 1 + 4 * HISTOGRAM_BUCKETS;
+static_assert(MAX_ZONE_RECORD_SIZE <= 0xFF, "记录长度用1字节表示");
+
+uint32_t window_sequence = 0;
+uint32_t window_start_cycles = 0;
+bool rtt_configured = false;
+
+uint8_t *put_u32(uint8_t *out, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        *out++ = (uint8_t)(value >> (8 * i));
+    }
+    return out;
+}
+
+uint8_t *put_u64(uint8_t *out, uint64_t value)
+{
+    out = put_u32(out, (uint32_t)value);
+    return put_u32(out, (uint32_t)(value >> 32));
+}
+
+// 结束当前窗口并开始下一个，返回窗口长度（周期）
+uint32_t next_window()
+{
+    const uint32_t now = DWT->CYCCNT;
+    const uint32_t length = now - window_start_cycles;
+    window_start_cycles = now;
+    ++window_sequence;
+    return length;
+}
+} // namespace
+
+void Profiler::init()
+{
+    HAL::DWTimer::getInstance();
+
+    // 两次连续读取CYCCNT的最小差值即ZoneScope本身计入的周期数
+    uint32_t best = UINT32_MAX;
+    for (int i = 0; i < 16; ++i)
+    {
+        const uint32_t start = DWT->CYCCNT;
+        const uint32_t end = DWT->CYCCNT;
+        best = end - start < best ? end - start : best;
+    }
+    overhead_cycles_ = best;
+    window_start_cycles = DWT->CYCCNT;
+}
+
+void Profiler::add_zone(Zone *zone)
+{
+    zone->registered_ = true;
+    if (zone_count_ < HAL_PROFILE_MAX_ZONES)
+    {
+        zones_[zone_count_++] = zone;
+    }
+    else
+    {
+        ++dropped_zones_;
+    }
+}
+
+uint8_t Profiler::zone_count()
+{
+    return zone_count_;
+}
+
+const char *Profiler::zone_name(uint8_t i)
+{
+    return i < zone_count_ ? zones_[i]->name() : nullptr;
+}
+
+ZoneStats Profiler::take_stats(uint8_t i)
+{
+    ZoneStats stats = {0, UINT32_MAX, 0, 0, {}};
+    if (i >= zone_count_)
+    {
+        return stats;
+    }
+
+    // 每次只锁一个分区，关中断时间约为拷贝一个ZoneStats
+    IrqLock lock;
+    Zone *zone = zones_[i];
+    stats = zone->stats_;
+    zone->stats_ = {0, UINT32_MAX, 0, 0, {}};
+    return stats;
+}
+
+void Profiler::dump_rtt()
+{
+    static uint8_t rtt_buffer[HAL_PROFILE_RTT_BUFFER_SIZE];
+    if (!rtt_configured)
+    {
+        // 空间不足时整条丢弃，不会写出半条记录
+        SEGGER_RTT_ConfigUpBuffer(HAL_PROFILE_RTT_CHANNEL, "profile", rtt_buffer, sizeof(rtt_buffer),
+                                  SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        rtt_configured = true;
+    }
+
+    const uint32_t window_cycles = next_window();
+    const uint32_t count = zone_count_;
+
+    uint8_t record[MAX_ZONE_RECORD_SIZE];
+    uint8_t *p = record;
+    *p++ = 'P';
+    *p++ = 'W';
+    *p++ = WINDOW_RECORD_SIZE;
+    *p++ = FORMAT_VERSION;
+    p = put_u32(p, window_sequence);
+    p = put_u32(p, window_cycles);
+    p = put_u32(p, HAL::DWTimer::getInstance().GetCyclesPerUs() * 1000000);
+    SEGGER_RTT_Write(HAL_PROFILE_RTT_CHANNEL, record, WINDOW_RECORD_SIZE);
+
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        const ZoneStats stats = take_stats(i);
+        const char *name = zones_[i]->name();
+        const size_t length = strlen(name);
+        const uint8_t name_length = length < MAX_NAME_LENGTH ? (uint8_t)length : MAX_NAME_LENGTH;
+
+        p = record + 3;
+        *p++ = name_length;
+        p = put_u32(p, window_sequence);
+        memcpy(p, name, name_length);
+        p += name_length;
+        p = put_u32(p, stats.count);
+        p = put_u32(p, stats.count != 0 ? stats.min_cycles : 0);
+        p = put_u32(p, stats.max_cycles);
+        p = put_u64(p, stats.total_cycles);
+        *p++ = HISTOGRAM_BUCKETS;
+        for (uint8_t b = 0; b < HISTOGRAM_BUCKETS; ++b)
+        {
+            p = put_u32(p, stats.histogram[b]);
+        }
+
+        record[1] = 'Z';
+        record[2] = (uint8_t)(p - record);
+        SEGGER_RTT_Write(HAL_PROFILE_RTT_CHANNEL, record, p - record);
+    }
+}
+
+void Profiler::log_report()
+{
+    auto &log = HAL::LOGGER::Logger::getInstance();
+    const uint32_t window_cycles = next_window();
+    const uint32_t cycles_per_us = HAL::DWTimer::getInstance().GetCyclesPerUs();
+
+    log.log(HAL::LOGGER::LogLevel::INFO, "profile window %u: %u ms, %u zones", window_sequence,
+            HAL::DWTimer::CyclesToMs(window_cycles), zone_count_);
+    for (uint8_t i = 0; i < zone_count_; ++i)
+    {
+        const ZoneStats stats = take_stats(i);
+        if (stats.count == 0)
+        {
+            continue;
+        }
+        const uint32_t mean = (uint32_t)(stats.total_cycles / stats.count);
+        // 占用率（万分之一）
+        const uint32_t load = window_cycles != 0 ? (uint32_t)(stats.total_cycles * 10000 / window_cycles) : 0;
+        log.log(HAL::LOGGER::LogLevel::INFO, "  %s n %u mean %u min %u max %u cyc (max %u us) load %u.%02u%%",
+                zones_[i]->name(), stats.count, mean, stats.min_cycles, stats.max_cycles,
+                stats.max_cycles / cycles_per_us, load / 100, load % 100);
+    }
+}
+
+} // namespace HAL::PROFILE
+
+#else
+
+namespace HAL::PROFILE
+{
+
+// 未定义HAL_PROFILE时没有分区，导出为空操作
+void Profiler::init()
+{
+}
+
+void Profiler::dump_rtt()
+{
+}
+
+void Profiler::log_report()
+{
+}
+
+uint8_t Profiler::zone_count()
+{
+    return 0;
+}
+
+const char *Profiler::zone_name(uint8_t)
+{
+    return nullptr;
+}
+
+ZoneStats Profiler::take_stats(uint8_t)
+{
+    return {0, UINT32_MAX, 0, 0, {}};
+}
+
+void Profiler::add_zone(Zone *)
+{
+}
+
+} // namespace HAL::PROFILE
+
+#endif // HAL_PROFILE
@@ -0,0 +1,206 @@
+/**
+ * @file profile.hpp
+ * @author 竹节虫 (k.yixiang@qq.com)
+ * @brief 基于DWT周期计数的分区耗时统计
+ * @version 0.0.1
+ * @date 2026-10-17
+ *
+ * @copyright SZPU-RCIA (c) 2026
+ *
+ */
+
+#pragma once
+#include <cstdint>
+
+// 最多统计的分区数，超出的分区不记录（计入dropped_zones()）
+#ifndef HAL_PROFILE_MAX_ZONES
+#define HAL_PROFILE_MAX_ZONES 24
+#endif
+
+// 导出统计使用的RTT通道（0号通道为日志，1号为CAN抓包）
+#ifndef HAL_PROFILE_RTT_CHANNEL
+#define HAL_PROFILE_RTT_CHANNEL 2
+#endif
+
+// RTT通道缓冲区大小（字节），每个分区一条记录约160字节
+#ifndef HAL_PROFILE_RTT_BUFFER_SIZE
+#define HAL_PROFILE_RTT_BUFFER_SIZE 2048
+#endif
+
+#ifdef HAL_PROFILE
+#include "main.h"
+#endif
+
+namespace HAL::PROFILE
+{
+
+// 直方图桶数：第i个桶统计[2^i, 2^(i+1))个周期（0周期计入第0个桶），最后一个桶不设上限（168 MHz下约50 ms以上）
+constexpr uint8_t HISTOGRAM_BUCKETS = 24;
+
+// 分区名字在导出记录中的最大长度
+constexpr uint8_t MAX_NAME_LENGTH = 32;
+
+// 一个分区在统计窗口内的数据，单位为内核时钟周期
+struct ZoneStats
+{
+    uint32_t count;                         // 执行次数
+    uint32_t min_cycles;                    // 最短耗时，没有记录时为UINT32_MAX
+    uint32_t max_cycles;                    // 最长耗时
+    uint64_t total_cycles;                  // 累计耗时，平均值为total_cycles / count
+    uint32_t histogram[HISTOGRAM_BUCKETS];  // 按耗时的log2分桶计数
+};
+
+/**
+ * @brief 一个统计分区，由PROFILE_ZONE定义为函数内的静态变量
+ *
+ * 构造为常量初始化，不产生静态局部变量的初始化检查；第一次记录时登记到分区表
+ */
+class Zone
+{
+  public:
+    constexpr explicit Zone(const char *name) : name_(name), stats_{0, UINT32_MAX, 0, 0, {}}
+    {
+    }
+
+    Zone(const Zone &) = delete;
+    Zone &operator=(const Zone &) = delete;
+
+    const char *name() const
+    {
+        return name_;
+    }
+
+#ifdef HAL_PROFILE
+    // 记录一次耗时（已扣除测量本身的开销），关中断更新，任务和中断中都可以使用
+    inline void record(uint32_t cycles);
+#endif
+
+  private:
+    friend class Profiler;
+
+    const char *name_;
+    bool registered_ = false;
+    ZoneStats stats_;
+};
+
+/**
+ * @brief 分区表与统计导出
+ *
+ * 统计按窗口导出：dump_rtt()/log_report()取走上次导出以来的数据并清零，两者只用其中一个，且只在一个任务中调用
+ */
+class Profiler
+{
+  public:
+    // 打开周期计数器并测量测量本身的开销，在第一个PROFILE_ZONE执行之前调用一次
+    static void init();
+
+    // 把窗口内各分区的统计以二进制记录写入RTT通道（格式见README），供PC端tools/profile_view.py显示
+    static void dump_rtt();
+
+    // 把窗口内各分区的统计以文本打印到日志（RTT通道0）
+    static void log_report();
+
+    // 已登记的分区数
+    static uint8_t zone_count();
+
+    // 第i个分区的名字
+    static const char *zone_name(uint8_t i);
+
+    // 取走第i个分区的窗口统计并清零
+    static ZoneStats take_stats(uint8_t i);
+
+    // 每次记录扣除的测量开销（周期）
+    static uint32_t overhead_cycles()
+    {
+        return overhead_cycles_;
+    }
+
+    // 分区表已满而没有登记的分区数
+    static uint32_t dropped_zones()
+    {
+        return dropped_zones_;
+    }
+
+  private:
+    friend class Zone;
+
+    // 登记分区，调用方持有关中断锁
+    static void add_zone(Zone *zone);
+
+    inline static Zone *zones_[HAL_PROFILE_MAX_ZONES] = {};
+    inline static uint8_t zone_count_ = 0;
+    inline static uint32_t dropped_zones_ = 0;
+    inline static uint32_t overhead_cycles_ = 0;
+};
+
+#ifdef HAL_PROFILE
+// 作用域内的耗时记录到分区，嵌套时外层的耗时包含内层
+class ZoneScope
+{
+  public:
+    explicit ZoneScope(Zone &zone) : zone_(zone), start_(DWT->CYCCNT)
+    {
+    }
+
+    ~ZoneScope()
+    {
+        zone_.record(DWT->CYCCNT - start_);
+    }
+
+    ZoneScope(const ZoneScope &) = delete;
+    ZoneScope &operator=(const ZoneScope &) = delete;
+
+  private:
+    Zone &zone_;
+    const uint32_t start_;
+};
+
+inline void Zone::record(uint32_t cycles)
+{
+    const uint32_t overhead = Profiler::overhead_cycles_;
+    cycles = cycles > overhead ? cycles - overhead : 0;
+    uint32_t bucket = cycles == 0 ? 0 : 31 - __CLZ(cycles);
+    bucket = bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1;
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (!registered_)
+    {
+        Profiler::add_zone(this);
+    }
+    ++stats_.count;
+    stats_.total_cycles += cycles;
+    stats_.min_cycles = cycles < stats_.min_cycles ? cycles : stats_.min_cycles;
+    stats_.max_cycles = cycles > stats_.max_cycles ? cycles : stats_.max_cycles;
+    ++stats_.histogram[bucket];
+    __set_PRIMASK(primask);
+}
+#endif
+
+} // namespace HAL::PROFILE
+
+#define HAL_PROFILE_CONCAT_(a, b) a##b
+#define HAL_PROFILE_CONCAT(a, b) HAL_PROFILE_CONCAT_(a, b)
+
+/**
+ * @brief 统计从这里到所在作用域结束的耗时
+ *
+ * @code
+ * void main_loop_gimbal()
+ * {
+ *     PROFILE_ZONE("main_loop_gimbal");
+ *     ...
+ * }
+ * @endcode
+ *
+ * 定义HAL_PROFILE时生效，未定义时展开为空语句，没有任何开销。
+ * 分区是所在函数的静态变量：模板的每个实例各有一个分区（名字相同），同一函数内每行最多一个PROFILE_ZONE
+ */
+#ifdef HAL_PROFILE
+#define PROFILE_ZONE(name)                                                                                             \
+    static HAL::PROFILE::Zone HAL_PROFILE_CONCAT(hal_profile_zone_, __LINE__)(name);                                   \
+    HAL::PROFILE::ZoneScope HAL_PROFILE_CONCAT(hal_profile_scope_, __LINE__)(                                          \
+        HAL_PROFILE_CONCAT(hal_profile_zone_, __LINE__))
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#endif
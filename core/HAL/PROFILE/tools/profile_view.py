@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+profile_view.py - 显示Profiler::dump_rtt()导出的分区统计（格式见../README.md）
+
+用法:
+    JLinkRTTLogger -Device STM32F407IG -If SWD -Speed 4000 -RTTChannel 2 profile.bin
+    python3 profile_view.py profile.bin            # 显示文件中的全部窗口
+    python3 profile_view.py profile.bin --follow   # 持续读取正在写入的文件，只显示最新窗口
+    python3 profile_view.py profile.bin --sort load --hist
+
+只使用标准库
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+FORMAT_VERSION = 1
+WINDOW_MAGIC = b"PW"
+ZONE_MAGIC = b"PZ"
+WINDOW_SIZE = 16
+
+
+class Window:
+    def __init__(self, seq, cycles, clock_hz):
+        self.seq = seq
+        self.cycles = cycles
+        self.clock_hz = clock_hz
+        self.zones = []
+
+
+class Zone:
+    def __init__(self, name, count, min_cycles, max_cycles, total_cycles, histogram):
+        self.name = name
+        self.count = count
+        self.min_cycles = min_cycles
+        self.max_cycles = max_cycles
+        self.total_cycles = total_cycles
+        self.histogram = histogram
+
+
+class Decoder:
+    """增量解码：feed()送入任意长度的数据，返回已完整的窗口"""
+
+    def __init__(self):
+        self.buffer = b""
+        self.current = None
+        self.skipped = 0
+
+    def feed(self, data):
+        self.buffer += data
+        done = []
+        pos = 0
+        buf = self.buffer
+        while len(buf) - pos >= 3:
+            magic = buf[pos:pos + 2]
+            length = buf[pos + 2]
+            if magic not in (WINDOW_MAGIC, ZONE_MAGIC) or length < 8:
+                # 不是记录头（连接时截断或RTT丢弃），逐字节重新同步
+                pos += 1
+                self.skipped += 1
+                continue
+            if len(buf) - pos < length:
+                break
+            record = buf[pos:pos + length]
+            if magic == WINDOW_MAGIC:
+                window = self._parse_window(record)
+                if window is None:
+                    pos += 1
+                    self.skipped += 1
+                    continue
+                if self.current is not None:
+                    done.append(self.current)
+                self.current = window
+            else:
+                zone = self._parse_zone(record)
+                if zone is None:
+                    pos += 1
+                    self.skipped += 1
+                    continue
+                seq, zone = zone
+                if self.current is not None and seq == self.current.seq:
+                    self.current.zones.append(zone)
+            pos += length
+        self.buffer = buf[pos:]
+        return done
+
+    def flush(self):
+        done = [self.current] if self.current is not None else []
+        self.current = None
+        return done
+
+    @staticmethod
+    def _parse_window(record):
+        if len(record) != WINDOW_SIZE or record[3] != FORMAT_VERSION:
+            return None
+        seq, cycles, clock_hz = struct.unpack_from("<III", record, 4)
+        return Window(seq, cycles, clock_hz)
+
+    @staticmethod
+    def _parse_zone(record):
+        name_length = record[3]
+        fixed = 8 + name_length + 20 + 1
+        if len(record) < fixed:
+            return None
+        (seq,) = struct.unpack_from("<I", record, 4)
+        name = record[8:8 + name_length].decode("utf-8", "replace")
+        count, min_cycles, max_cycles, total_cycles = struct.unpack_from("<IIIQ", record, 8 + name_length)
+        buckets = record[fixed - 1]
+        if len(record) != fixed + 4 * buckets:
+            return None
+        histogram = list(struct.unpack_from("<%dI" % buckets, record, fixed))
+        return seq, Zone(name, count, min_cycles, max_cycles, total_cycles, histogram)
+
+
+def cycles_to_us(cycles, clock_hz):
+    return cycles * 1e6 / clock_hz if clock_hz else float("nan")
+
+
+def bucket_label(i, clock_hz):
+    # 第i个桶为[2^i, 2^(i+1))个周期，按上限显示
+    return "<%.3gus" % cycles_to_us(1 << (i + 1), clock_hz)
+
+
+def sparkline(histogram):
+    bars = " .:-=+*#%@"
+    peak = max(histogram) if histogram else 0
+    if peak == 0:
+        return ""
+    last = max(i for i, n in enumerate(histogram) if n)
+    first = min(i for i, n in enumerate(histogram) if n)
+    return "".join(bars[(n * (len(bars) - 1) + peak - 1) // peak] for n in histogram[first:last + 1])
+
+
+def print_window(window, sort, show_hist, out):
+    seconds = window.cycles / window.clock_hz if window.clock_hz else 0.0
+    out.write("window %u  %.1f ms  %u zones\n" % (window.seq, seconds * 1e3, len(window.zones)))
+    out.write("  %-24s %8s %9s %9s %9s %9s %7s  %s\n" %
+              ("zone", "calls", "calls/s", "mean us", "min us", "max us", "load%", "histogram"))
+
+    def load(z):
+        return z.total_cycles / window.cycles if window.cycles else 0.0
+
+    zones = list(window.zones)
+    if sort == "load":
+        zones.sort(key=load, reverse=True)
+    elif sort == "max":
+        zones.sort(key=lambda z: z.max_cycles, reverse=True)
+    elif sort == "name":
+        zones.sort(key=lambda z: z.name)
+
+    hz = window.clock_hz
+    for z in zones:
+        if z.count == 0:
+            out.write("  %-24s %8u\n" % (z.name, 0))
+            continue
+        mean = z.total_cycles / z.count
+        rate = z.count / seconds if seconds else 0.0
+        out.write("  %-24s %8u %9.1f %9.2f %9.2f %9.2f %7.2f  %s\n" %
+                  (z.name, z.count, rate, cycles_to_us(mean, hz), cycles_to_us(z.min_cycles, hz),
+                   cycles_to_us(z.max_cycles, hz), load(z) * 100, sparkline(z.histogram)))
+        if show_hist:
+            for i, n in enumerate(z.histogram):
+                if n:
+                    out.write("      %10s %8u\n" % (bucket_label(i, hz), n))
+    out.write("\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="显示PROFILE_ZONE分区统计（RTT导出数据）")
+    parser.add_argument("file", help="JLinkRTTLogger保存的文件，'-'为标准输入")
+    parser.add_argument("--follow", "-f", action="store_true", help="持续读取文件末尾，刷新显示最新窗口")
+    parser.add_argument("--sort", choices=["none", "load", "max", "name"], default="load", help="排序方式")
+    parser.add_argument("--hist", action="store_true", help="逐桶显示直方图")
+    args = parser.parse_args()
+
+    decoder = Decoder()
+    out = sys.stdout
+
+    if args.file == "-":
+        stream = sys.stdin.buffer
+    else:
+        stream = open(args.file, "rb")
+
+    if not args.follow:
+        for window in decoder.feed(stream.read()) + decoder.flush():
+            print_window(window, args.sort, args.hist, out)
+        if decoder.skipped:
+            sys.stderr.write("skipped %u bytes while resynchronizing\n" % decoder.skipped)
+        return 0
+
+    try:
+        while True:
+            data = stream.read(65536)
+            windows = decoder.feed(data) if data else []
+            if windows:
+                if out.isatty():
+                    out.write("\x1b[2J\x1b[H")
+                print_window(windows[-1], args.sort, args.hist, out)
+                out.flush()
+            if not data:
+                time.sleep(0.1)
+    except KeyboardInterrupt:
+        return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
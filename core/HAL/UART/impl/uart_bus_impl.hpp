@@ -10,50 +10,122 @@
  */
 
 #pragma once
+#include "../../ASSERT/asster.hpp"
+#include "../../BOARD/board.hpp"
 #include "../interface/uart_bus.hpp"
 #include "uart_device_impl.hpp"
+#include <iterator>
+#include <utility>
 
 namespace HAL::UART
 {
 
-// UART总线管理实现类
-class UartBus : public IUartBus
+/**
+ * @brief UART总线管理实现类
+ *
+ * Ports为板级描述表（BOARD::UartPort数组），每一项生成一个UartDevice，Ring模式的接收缓冲区一并分配在总线中，
+ * 描述表之外的外设用get_device<Id>()访问时编译失败
+ */
+template <const auto &Ports> class UartBus final : public IUartBus
 {
+    static constexpr size_t COUNT = std::size(Ports);
+    static constexpr size_t RX_BUFFER_TOTAL = BOARD::rx_buffer_offset(Ports, COUNT);
+
   public:
     // 获取单例实例
-    static UartBus &instance();
+    static UartBus &instance()
+    {
+        static UartBus instance;
+        // 懒汉模式：在第一次获取实例时初始化
+        if (!instance.initialized_)
+        {
+            instance.init();
+            instance.initialized_ = true;
+        }
+        return instance;
+    }
 
     // 析构函数
     ~UartBus() override = default;
 
-    // 实现IUartBus接口
-    IUartDevice &get_device(UartDeviceId id) override;
-    bool has_device(UartDeviceId id) const override;
+    // 编译期按ID取设备，不经过虚函数
+    template <UartDeviceId Id> UartDevice &device()
+    {
+        constexpr size_t index = BOARD::index_of(Ports, Id);
+        static_assert(index < COUNT, "板级描述表中没有该UART外设");
+        return devices_[index];
+    }
+
+    // 实现IUartBus接口；ID不在描述表中时断言失败
+    IUartDevice &get_device(UartDeviceId id) override
+    {
+        const size_t index = BOARD::index_of(Ports, id);
+        assert_always(index < COUNT);
+        return devices_[index];
+    }
 
-    // 初始化UART总线（私有，由instance()调用）
-    void init();
+    bool has_device(UartDeviceId id) const override
+    {
+        return BOARD::index_of(Ports, id) < COUNT;
+    }
+
+    // 禁止拷贝构造和赋值操作
+    UartBus(const UartBus &) = delete;
+    UartBus &operator=(const UartBus &) = delete;
 
   private:
     // 私有构造函数（单例模式）
-    UartBus();
+    UartBus() : UartBus(std::make_index_sequence<COUNT>())
+    {
+    }
+
+    template <size_t... I> explicit UartBus(std::index_sequence<I...>) : devices_{UartDevice(Ports[I].handle)...}
+    {
+    }
 
-    // 注册一个UART设备
-    void register_device(UartDeviceId id, UartDevice *device);
+    // 初始化所有设备（由instance()调用）
+    void init()
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            devices_[i].init();
+            if (Ports[i].rx_mode == BOARD::UartRxMode::Ring)
+            {
+                // 循环接收只用DMA，不打开RXNE中断（否则HAL会在中断中按普通接收读DR）
+                // 启动失败（未配置接收DMA、DMA重新初始化或启动接收失败）时该串口收不到任何数据，在初始化时暴露
+                assert_always(
+                    devices_[i].start_rx_ring(rx_buffers_ + BOARD::rx_buffer_offset(Ports, i), Ports[i].rx_buffer_size));
+            }
+            else
+            {
+                devices_[i].start();
+            }
+        }
+    }
 
     // 是否已初始化标志
     bool initialized_ = false;
 
-    // 禁止拷贝构造和赋值操作
-    UartBus(const UartBus &) = delete;
-    UartBus &operator=(const UartBus &) = delete;
+    // 设备实例，顺序与描述表相同
+    UartDevice devices_[COUNT];
 
-    // 使用指针数组代替固定成员变量
-    UartDevice *devices_[(size_t)UartDeviceId::MAX_DEVICES] = {nullptr};
-
-    // 实际设备实例
-    UartDevice uart1_;
-    UartDevice uart3_;
-    UartDevice uart6_;
+    // Ring模式的接收缓冲区按描述表顺序连续存放，用作DMA目标，不能放在CCM RAM
+    uint8_t rx_buffers_[RX_BUFFER_TOTAL > 0 ? RX_BUFFER_TOTAL : 1];
 };
 
-} // namespace HAL::UART
\ No newline at end of file
+// 按板级描述表生成的UART总线
+using BoardUartBus = UartBus<BOARD::UART_PORTS>;
+
+/**
+ * @brief 编译期取UART设备，描述表中没有该外设时编译失败
+ *
+ * @code
+ * auto &uart8 = HAL::UART::get_device<HAL::UART::UartDeviceId::HAL_Uart8>();
+ * @endcode
+ */
+template <UartDeviceId Id> UartDevice &get_device()
+{
+    return BoardUartBus::instance().device<Id>();
+}
+
+} // namespace HAL::UART
@@ -1,8 +1,14 @@
 #include "uart_device_impl.hpp"
+#include "../../IRQ/irq_lock.hpp"
 
 namespace HAL::UART
 {
 
+namespace
+{
+constexpr uint16_t TX_RING_MASK = HAL_UART_TX_RING_SIZE - 1;
+} // namespace
+
 // UartDevice实现
 UartDevice::UartDevice(UART_HandleTypeDef *handle)
     : handle_(handle), is_receiving_(false), is_dma_tx_ongoing_(false), is_dma_rx_ongoing_(false),
@@ -106,25 +112,242 @@ bool UartDevice::receive_dma_idle(Data &data)
     return false;
 }
 
-void UartDevice::register_rx_callback(RemoteDataCallback callback)
+bool UartDevice::start_rx_ring(uint8_t *buffer, uint16_t size)
 {
-    if (callback)
+    if (buffer == nullptr || size < 2 || handle_->hdmarx == nullptr)
     {
-        rx_callbacks_.push_back(callback);
+        return false;
     }
+
+    // CubeMX默认把接收DMA配置为普通模式，这里改为循环模式；DMA流此时未运行，可以重新初始化
+    HAL_UART_AbortReceive(handle_);
+    if (handle_->hdmarx->Init.Mode != DMA_CIRCULAR)
+    {
+        handle_->hdmarx->Init.Mode = DMA_CIRCULAR;
+        if (HAL_DMA_Init(handle_->hdmarx) != HAL_OK)
+        {
+            return false;
+        }
+    }
+
+    ring_buffer_ = buffer;
+    ring_size_ = size;
+    if (!arm_rx_ring())
+    {
+        ring_buffer_ = nullptr;
+        return false;
+    }
+    return true;
 }
 
-void UartDevice::trigger_rx_callbacks(const Data &data)
+bool UartDevice::arm_rx_ring()
 {
-    for (auto &callback : rx_callbacks_)
+    ring_read_ = 0;
+
+    // 循环模式下HAL在半满、全满和空闲时都调用HAL_UARTEx_RxEventCallback，且不会停止DMA
+    if (HAL_UARTEx_ReceiveToIdle_DMA(handle_, ring_buffer_, ring_size_) != HAL_OK)
     {
-        if (callback)
+        return false;
+    }
+
+    // DMA接收时HAL遇到任何错误中断都会中止DMA，屏蔽ORE/FE/NE（EIE）和PE（PEIE）中断后DMA继续运行，
+    // 出错的字节照常写入缓冲区（ORE时丢失的字节无法找回），由帧校验丢弃
+    IrqLock lock;
+    CLEAR_BIT(handle_->Instance->CR3, USART_CR3_EIE);
+    CLEAR_BIT(handle_->Instance->CR1, USART_CR1_PEIE);
+    return true;
+}
+
+void UartDevice::sample_errors()
+{
+    if (ring_buffer_ == nullptr)
+    {
+        return;
+    }
+
+    // 标志在读SR后再读DR时清除：DMA读DR或HAL空闲处理会清除它们，这里只读SR，不影响DMA
+    const uint32_t sr = handle_->Instance->SR;
+    const uint32_t flags = sr & (USART_SR_ORE | USART_SR_FE | USART_SR_NE | USART_SR_PE);
+    const uint32_t fresh = flags & ~last_error_flags_;
+
+    error_stats_.overrun += (fresh & USART_SR_ORE) != 0;
+    error_stats_.framing += (fresh & USART_SR_FE) != 0;
+    error_stats_.noise += (fresh & USART_SR_NE) != 0;
+    error_stats_.parity += (fresh & USART_SR_PE) != 0;
+
+    // 空闲中断时HAL紧接着读DR，标志会被清除；其他中断（发送完成等）时标志保留到下一次
+    last_error_flags_ = (sr & USART_SR_IDLE) ? 0 : flags;
+}
+
+void UartDevice::handle_error()
+{
+    const uint32_t code = handle_->ErrorCode;
+    error_stats_.overrun += (code & HAL_UART_ERROR_ORE) != 0;
+    error_stats_.framing += (code & HAL_UART_ERROR_FE) != 0;
+    error_stats_.noise += (code & HAL_UART_ERROR_NE) != 0;
+    error_stats_.parity += (code & HAL_UART_ERROR_PE) != 0;
+    error_stats_.dma += (code & HAL_UART_ERROR_DMA) != 0;
+
+    // 循环接收被HAL中止（例如错误中断被重新打开）：DMA流已停止，NDTR保留停止时的剩余数，先交付已收到的数据再重启
+    if (ring_buffer_ != nullptr && handle_->RxState == HAL_UART_STATE_READY)
+    {
+        handle_rx_event(ring_size_ - __HAL_DMA_GET_COUNTER(handle_->hdmarx));
+        if (arm_rx_ring())
         {
-            callback(data);
+            ++error_stats_.recoveries;
         }
     }
 }
 
+UartErrorStats UartDevice::get_error_stats() const
+{
+    return error_stats_;
+}
+
+bool UartDevice::handle_rx_event(uint16_t pos)
+{
+    if (ring_buffer_ == nullptr)
+    {
+        return false;
+    }
+
+    // pos为DMA写指针（已写入的字节数），全满事件时等于缓冲区长度，对应下标0
+    const uint16_t write = pos >= ring_size_ ? 0 : pos;
+    if (write == ring_read_)
+    {
+        return true;
+    }
+
+    RxSpan span;
+    span.first = ring_buffer_ + ring_read_;
+    if (write > ring_read_)
+    {
+        span.first_size = write - ring_read_;
+        span.second = ring_buffer_;
+        span.second_size = 0;
+    }
+    else
+    {
+        span.first_size = ring_size_ - ring_read_;
+        span.second = ring_buffer_;
+        span.second_size = write;
+        ring_stats_.wraps += write != 0;
+    }
+    ring_read_ = write;
+
+    const uint16_t size = span.size();
+    ++ring_stats_.events;
+    ring_stats_.bytes += size;
+    if (size > ring_stats_.max_chunk)
+    {
+        ring_stats_.max_chunk = size;
+    }
+
+    span_callbacks_.invoke(span);
+    return true;
+}
+
+bool UartDevice::register_rx_span_callback(RxSpanCallback callback)
+{
+    return span_callbacks_.add(callback);
+}
+
+RxRingStats UartDevice::get_rx_ring_stats() const
+{
+    return ring_stats_;
+}
+
+uint16_t UartDevice::write(const uint8_t *data, uint16_t size)
+{
+    if (data == nullptr || size == 0)
+    {
+        return 0;
+    }
+
+    IrqLock lock;
+    const uint16_t pending = tx_head_ - tx_tail_;
+    const uint16_t space = HAL_UART_TX_RING_SIZE - pending;
+    const uint16_t accepted = size < space ? size : space;
+
+    // 队列末尾放不下时分两段拷贝
+    const uint16_t head = tx_head_ & TX_RING_MASK;
+    const uint16_t first = accepted < HAL_UART_TX_RING_SIZE - head ? accepted : HAL_UART_TX_RING_SIZE - head;
+    memcpy(tx_ring_ + head, data, first);
+    memcpy(tx_ring_, data + first, accepted - first);
+    tx_head_ += accepted;
+
+    tx_stats_.accepted_bytes += accepted;
+    if (accepted < size)
+    {
+        tx_stats_.dropped_bytes += size - accepted;
+        ++tx_stats_.dropped_writes;
+    }
+    if (pending + accepted > tx_stats_.max_pending)
+    {
+        tx_stats_.max_pending = pending + accepted;
+    }
+
+    if (tx_dma_size_ == 0)
+    {
+        start_tx_dma();
+    }
+    return accepted;
+}
+
+void UartDevice::start_tx_dma()
+{
+    const uint16_t pending = tx_head_ - tx_tail_;
+    if (pending == 0)
+    {
+        return;
+    }
+
+    const uint16_t tail = tx_tail_ & TX_RING_MASK;
+    const uint16_t size = pending < HAL_UART_TX_RING_SIZE - tail ? pending : HAL_UART_TX_RING_SIZE - tail;
+
+    // transmit()/transmit_dma()占用发送时返回HAL_BUSY，数据留在队列中，由那次传输的完成回调接着发送
+    if (HAL_UART_Transmit_DMA(handle_, tx_ring_ + tail, size) == HAL_OK)
+    {
+        tx_dma_size_ = size;
+        ++tx_stats_.dma_transfers;
+    }
+}
+
+bool UartDevice::handle_tx_complete()
+{
+    IrqLock lock;
+    const bool own = tx_dma_size_ != 0;
+    if (own)
+    {
+        tx_tail_ += tx_dma_size_;
+        tx_stats_.sent_bytes += tx_dma_size_;
+        tx_dma_size_ = 0;
+    }
+
+    start_tx_dma();
+    return own;
+}
+
+uint16_t UartDevice::tx_pending() const
+{
+    return tx_head_ - tx_tail_;
+}
+
+TxRingStats UartDevice::get_tx_ring_stats() const
+{
+    return tx_stats_;
+}
+
+bool UartDevice::register_rx_callback(RemoteDataCallback callback)
+{
+    return rx_callbacks_.add(callback);
+}
+
+void UartDevice::trigger_rx_callbacks(const Data &data)
+{
+    rx_callbacks_.invoke(data);
+}
+
 void UartDevice::clear_ore_error(Data &data)
 {
     if (__HAL_UART_GET_FLAG(handle_, UART_FLAG_ORE) != RESET)
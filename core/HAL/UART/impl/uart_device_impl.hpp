@@ -12,11 +12,24 @@
 #pragma once
 #include "../interface/uart_device.hpp"
 
+// 每个UART可注册的接收回调数量上限
+#ifndef HAL_UART_MAX_RX_CALLBACKS
+#define HAL_UART_MAX_RX_CALLBACKS 4
+#endif
+
+// 每个UART发送队列的长度（字节，2的幂），用作DMA源，不能放在CCM RAM
+#ifndef HAL_UART_TX_RING_SIZE
+#define HAL_UART_TX_RING_SIZE 512
+#endif
+
+static_assert((HAL_UART_TX_RING_SIZE & (HAL_UART_TX_RING_SIZE - 1)) == 0, "HAL_UART_TX_RING_SIZE必须是2的幂");
+static_assert(HAL_UART_TX_RING_SIZE <= 32768, "发送队列下标为16位");
+
 namespace HAL::UART
 {
 
 // UART硬件设备实现类
-class UartDevice : public IUartDevice
+class UartDevice final : public IUartDevice
 {
   public:
     // 构造函数，初始化UART设备
@@ -41,8 +54,25 @@ class UartDevice : public IUartDevice
     bool receive_dma_idle(Data &data) override;
     void clear_ore_error(Data &data) override;
 
+    // 循环DMA接收
+    bool start_rx_ring(uint8_t *buffer, uint16_t size) override;
+    bool handle_rx_event(uint16_t pos) override;
+    bool register_rx_span_callback(RxSpanCallback callback) override;
+    RxRingStats get_rx_ring_stats() const override;
+
+    // 接收错误处理
+    void sample_errors() override;
+    void handle_error() override;
+    UartErrorStats get_error_stats() const override;
+
+    // DMA发送队列
+    uint16_t write(const uint8_t *data, uint16_t size) override;
+    bool handle_tx_complete() override;
+    uint16_t tx_pending() const override;
+    TxRingStats get_tx_ring_stats() const override;
+
     // 实现回调机制
-    void register_rx_callback(RemoteDataCallback callback) override;
+    bool register_rx_callback(RemoteDataCallback callback) override;
     void trigger_rx_callbacks(const Data &data) override;
 
     UART_HandleTypeDef *get_handle() const override;
@@ -58,7 +88,31 @@ class UartDevice : public IUartDevice
     bool is_idle_enabled_;
 
     // 存储注册的回调函数
-    std::vector<RemoteDataCallback> rx_callbacks_;
+    HAL::DELEGATE::CallbackRegistry<RemoteDataCallback, HAL_UART_MAX_RX_CALLBACKS> rx_callbacks_;
+
+    // 循环接收缓冲区与读指针（下一个未交付字节的下标）
+    uint8_t *ring_buffer_ = nullptr;
+    uint16_t ring_size_ = 0;
+    uint16_t ring_read_ = 0;
+    RxRingStats ring_stats_ = {};
+    HAL::DELEGATE::CallbackRegistry<RxSpanCallback, HAL_UART_MAX_RX_CALLBACKS> span_callbacks_;
+
+    // 接收错误
+    UartErrorStats error_stats_ = {};
+    uint32_t last_error_flags_ = 0; // 上次采样时仍未清除的错误标志，避免重复计数
+
+    // 启动循环DMA接收并屏蔽错误中断
+    bool arm_rx_ring();
+
+    // 发送队列：tx_head_/tx_tail_为自由增长的16位计数，取模后作为下标
+    uint8_t tx_ring_[HAL_UART_TX_RING_SIZE];
+    volatile uint16_t tx_head_ = 0;
+    volatile uint16_t tx_tail_ = 0;
+    uint16_t tx_dma_size_ = 0; // 正在DMA发送的字节数，0表示空闲
+    TxRingStats tx_stats_ = {};
+
+    // 从tx_tail_开始启动一次DMA（不跨过队列末尾），调用方持有关中断锁
+    void start_tx_dma();
 };
 
 } // namespace HAL::UART
\ No newline at end of file
@@ -18,7 +18,7 @@ namespace HAL::UART
 // 全局函数实现
 IUartBus &get_uart_bus_instance()
 {
-    return UartBus::instance();
+    return BoardUartBus::instance();
 }
 
 } // namespace HAL::UART
\ No newline at end of file
@@ -5,13 +5,17 @@
 namespace HAL::UART
 {
 
-// UART设备ID枚举
+// UART设备ID枚举，覆盖F4的全部串口；实际存在哪些由板级描述表（HAL/BOARD）决定
 enum class UartDeviceId : uint8_t
 {
     HAL_Uart1 = 0,
-    HAL_Uart3 = 1,
-    HAL_Uart6 = 2,
-    // 可以在此处添加更多UART设备，无需修改接口
+    HAL_Uart2 = 1,
+    HAL_Uart3 = 2,
+    HAL_Uart4 = 3,
+    HAL_Uart5 = 4,
+    HAL_Uart6 = 5,
+    HAL_Uart7 = 6,
+    HAL_Uart8 = 7,
     MAX_DEVICES
 };
 
@@ -10,9 +10,10 @@
  */
 
 #pragma once
+#include "../../DELEGATE/delegate.hpp"
 #include "main.h"  // 包含STM32 HAL的主头文件
 #include "usart.h" // 包含UART相关定义
-#include <functional>
+#include <cstring>
 
 namespace HAL::UART
 {
@@ -24,7 +25,76 @@ struct Data
     uint16_t size;   // 数据大小
 };
 
-using RemoteDataCallback = std::function<void(const HAL::UART::Data& data)>;
+// UART接收回调函数类型（不分配堆内存，可放下函数指针或捕获两个指针的lambda）
+using RemoteDataCallback = HAL::DELEGATE::InplaceFunction<void(const HAL::UART::Data &data)>;
+
+/**
+ * @brief 循环接收缓冲区中的一段新数据（零拷贝）
+ *
+ * 数据跨过缓冲区末尾时分为两段：first为从读指针到缓冲区末尾，second为从缓冲区开头开始的部分，不跨越时second_size为0
+ */
+struct RxSpan
+{
+    const uint8_t *first;
+    uint16_t first_size;
+    const uint8_t *second;
+    uint16_t second_size;
+
+    uint16_t size() const
+    {
+        return first_size + second_size;
+    }
+
+    // 按逻辑下标访问，不检查越界
+    uint8_t operator[](uint16_t index) const
+    {
+        return index < first_size ? first[index] : second[index - first_size];
+    }
+
+    // 拷贝到连续缓冲区，返回拷贝的字节数
+    uint16_t copy_to(uint8_t *out, uint16_t max_size) const
+    {
+        const uint16_t n1 = first_size < max_size ? first_size : max_size;
+        memcpy(out, first, n1);
+        const uint16_t n2 = second_size < max_size - n1 ? second_size : max_size - n1;
+        memcpy(out + n1, second, n2);
+        return n1 + n2;
+    }
+};
+
+// 循环接收回调类型，在串口中断中执行，span只在DMA绕回覆盖之前有效
+using RxSpanCallback = HAL::DELEGATE::InplaceFunction<void(const HAL::UART::RxSpan &span)>;
+
+// 循环接收统计
+struct RxRingStats
+{
+    uint32_t events;      // 收到新数据的接收事件次数（空闲/半满/全满）
+    uint32_t bytes;       // 收到的总字节数
+    uint32_t wraps;       // 跨过缓冲区末尾、分两段交付的次数
+    uint16_t max_chunk;   // 单次事件交付的最大字节数，接近缓冲区长度说明回调处理不及时
+};
+
+// 接收错误统计
+struct UartErrorStats
+{
+    uint32_t overrun;    // ORE：上一个字节还未被读走又收到新字节，丢失1个字节
+    uint32_t framing;    // FE：停止位错误（波特率不一致、线路干扰）
+    uint32_t noise;      // NE：采样到噪声
+    uint32_t parity;     // PE：奇偶校验错误
+    uint32_t dma;        // DMA传输错误
+    uint32_t recoveries; // HAL因错误中止接收后重新启动循环接收的次数
+};
+
+// 发送队列统计
+struct TxRingStats
+{
+    uint32_t accepted_bytes; // write()接受的字节数
+    uint32_t sent_bytes;     // DMA发送完成的字节数，两次读取的差值除以间隔即为吞吐量
+    uint32_t dropped_bytes;  // 队列已满被丢弃的字节数
+    uint32_t dropped_writes; // 未被完整接受的write()次数
+    uint32_t dma_transfers;  // 启动的DMA传输次数
+    uint16_t max_pending;    // 队列中待发送字节数的历史最大值
+};
 
 // UART设备抽象接口
 class IUartDevice
@@ -53,14 +123,47 @@ class IUartDevice
     // 使用DMA发送数据
     virtual bool transmit_dma(const Data &data) = 0;
 
+    // 写入发送队列（非阻塞，数据被拷贝），返回接受的字节数，队列剩余空间不足时只接受前一部分
+    virtual uint16_t write(const uint8_t *data, uint16_t size) = 0;
+
+    // 在HAL_UART_TxCpltCallback中调用：发送队列中还有数据时接着启动下一次DMA；本次完成的不是队列的传输时返回false
+    virtual bool handle_tx_complete() = 0;
+
+    // 发送队列中尚未发完的字节数（含正在DMA发送的部分）
+    virtual uint16_t tx_pending() const = 0;
+
+    // 获取发送队列统计
+    virtual TxRingStats get_tx_ring_stats() const = 0;
+
     // 使用DMA接收数据
     virtual bool receive_dma(Data &data) = 0;
 
     // 设置DMA连续接收并使用空闲中断检测
     virtual bool receive_dma_idle(Data &data) = 0;
 
-    // 注册接收回调函数
-    virtual void register_rx_callback(RemoteDataCallback callback) = 0;
+    // 启动循环DMA接收：DMA流切换为循环模式后一直运行，不再在每次事件后重启，buffer在运行期间必须有效
+    virtual bool start_rx_ring(uint8_t *buffer, uint16_t size) = 0;
+
+    // 在HAL_UARTEx_RxEventCallback中调用，pos为回调的Size参数；未启动循环接收时返回false
+    virtual bool handle_rx_event(uint16_t pos) = 0;
+
+    // 注册循环接收回调，回调数量达到HAL_UART_MAX_RX_CALLBACKS时返回false
+    virtual bool register_rx_span_callback(RxSpanCallback callback) = 0;
+
+    // 获取循环接收统计
+    virtual RxRingStats get_rx_ring_stats() const = 0;
+
+    // 在USARTx_IRQHandler中、HAL_UART_IRQHandler之前调用：循环接收时统计错误标志（HAL随后在空闲处理中清除）
+    virtual void sample_errors() = 0;
+
+    // 在HAL_UART_ErrorCallback中调用：按错误类型计数，循环接收被HAL中止时交付已收到的数据并重新启动
+    virtual void handle_error() = 0;
+
+    // 获取接收错误统计
+    virtual UartErrorStats get_error_stats() const = 0;
+
+    // 注册接收回调函数，回调数量达到HAL_UART_MAX_RX_CALLBACKS时返回false
+    virtual bool register_rx_callback(RemoteDataCallback callback) = 0;
 
     // 触发所有注册的回调函数
     virtual void trigger_rx_callbacks(const Data &data) = 0;